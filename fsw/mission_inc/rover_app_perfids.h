@@ -29,7 +29,8 @@
 #ifndef _rover_app_perfids_h_
 #define _rover_app_perfids_h_
 
-#define ROVER_APP_PERF_ID 91
+#define ROVER_APP_PERF_ID         91
+#define ROVER_APP_CONTROL_PERF_ID 92
 
 #endif /* _rover_app_perfids_h_ */
 
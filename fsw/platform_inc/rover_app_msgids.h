@@ -35,10 +35,22 @@
 #define ROVER_APP_CMD_MID     (CFE_PLATFORM_CMD_MID_BASE + 0x27)
 #define ROVER_APP_SEND_HK_MID (CFE_PLATFORM_CMD_MID_BASE + 0x28)
 #define ROVER_APP_CMD_ODOM_MID (CFE_PLATFORM_CMD_MID_BASE + 0x29)
+#define ROVER_APP_SCHED_CMD_MID (CFE_PLATFORM_CMD_MID_BASE + 0x2A)
+
+/* Multi-rover mode: one MID per fleet vehicle from each base */
+#define ROVER_APP_FLEET_CMD_MID_BASE  (CFE_PLATFORM_CMD_MID_BASE + 0x40)
+#define ROVER_APP_FLEET_ODOM_MID_BASE (CFE_PLATFORM_CMD_MID_BASE + 0x80)
 
 #define ROVER_APP_HK_TLM_MID      (CFE_PLATFORM_TLM_MID_BASE + 0x26)
 #define ROVER_APP_TLM_TWIST_MID   (CFE_PLATFORM_TLM_MID_BASE + 0x27)
 #define ROVER_APP_HR_CONTROL_MID  (CFE_PLATFORM_TLM_MID_BASE + 0x28)
+#define ROVER_APP_DIAG_TLM_MID    (CFE_PLATFORM_TLM_MID_BASE + 0x29)
+#define ROVER_APP_STATS_TLM_MID   (CFE_PLATFORM_TLM_MID_BASE + 0x2A)
+#define ROVER_APP_SCHED_TLM_MID   (CFE_PLATFORM_TLM_MID_BASE + 0x2B)
+#define ROVER_APP_FLEET_TWIST_TLM_MID (CFE_PLATFORM_TLM_MID_BASE + 0x2C)
+#define ROVER_APP_FLEET_STATE_TLM_MID (CFE_PLATFORM_TLM_MID_BASE + 0x2D)
+#define ROVER_APP_COMPACT_TLM_MID     (CFE_PLATFORM_TLM_MID_BASE + 0x2E)
+#define ROVER_APP_STATE_BUNDLE_TLM_MID (CFE_PLATFORM_TLM_MID_BASE + 0x2F)
 #endif /* _rover_app_msgids_h_ */
 
 /*********************************/
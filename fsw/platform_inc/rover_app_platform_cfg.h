@@ -0,0 +1,406 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_platform_cfg.h
+**
+** Purpose:
+**  Platform configuration parameters for the Rover App
+**
+** Notes:
+**  Every value may be overridden from the build (-D) without editing
+**  this file.
+**
+*******************************************************************************/
+#ifndef _rover_app_platform_cfg_h_
+#define _rover_app_platform_cfg_h_
+
+/*
+** Control task
+**
+** With ROVER_APP_CONTROL_TASK_ENABLE set, HR wakeups and odometry are
+** received on their own pipe by a higher priority child task, while the
+** main task keeps ground commands and HK requests.  Set it to 0 to service
+** everything from the main task's command pipe.
+*/
+#ifndef ROVER_APP_CONTROL_TASK_ENABLE
+#define ROVER_APP_CONTROL_TASK_ENABLE 1
+#endif
+
+/* Lower value is higher priority; the main task runs at its startup script priority */
+#ifndef ROVER_APP_CONTROL_TASK_PRIORITY
+#define ROVER_APP_CONTROL_TASK_PRIORITY 40
+#endif
+
+#ifndef ROVER_APP_CONTROL_TASK_STACK_SIZE
+#define ROVER_APP_CONTROL_TASK_STACK_SIZE 16384
+#endif
+
+/*
+** Multi-rover mode: vehicles served besides the app's own, each with its
+** own command and odometry MIDs (see rover_app_fleet.h), 0 for none.  At
+** most 64, the width of the MID ranges in rover_app_msgids.h.
+*/
+#ifndef ROVER_APP_FLEET_SIZE
+#define ROVER_APP_FLEET_SIZE 0
+#endif
+
+/* Every fleet vehicle may have a command and an odometry message waiting */
+#ifndef ROVER_APP_CONTROL_PIPE_DEPTH
+#define ROVER_APP_CONTROL_PIPE_DEPTH (32 + (2 * ROVER_APP_FLEET_SIZE))
+#endif
+
+/* Fleet state packet period, in HR ticks */
+#ifndef ROVER_APP_FLEET_STATE_PERIOD
+#define ROVER_APP_FLEET_STATE_PERIOD 100
+#endif
+
+/*
+** Most messages handled per pipe wakeup.  Consecutive odometry and
+** SET_TWIST messages within one batch are coalesced to the newest; 1
+** handles every message on its own.
+*/
+#ifndef ROVER_APP_PIPE_BATCH_LIMIT
+#define ROVER_APP_PIPE_BATCH_LIMIT 32
+#endif
+
+/*
+** Odometry history
+*/
+
+/* Timestamped odometry samples kept, must be a power of two */
+#ifndef ROVER_APP_ODOM_HISTORY_SIZE
+#define ROVER_APP_ODOM_HISTORY_SIZE 64
+#endif
+
+/* Longest constant velocity extrapolation past the newest sample */
+#ifndef ROVER_APP_ODOM_EXTRAPOLATE_MS
+#define ROVER_APP_ODOM_EXTRAPOLATE_MS 200
+#endif
+
+/*
+** A sample this much older than the newest one (a time source reset, a log
+** replayed from the start) restarts the history instead of being rejected
+*/
+#ifndef ROVER_APP_ODOM_RESEED_MS
+#define ROVER_APP_ODOM_RESEED_MS 500
+#endif
+
+/*
+** How HighRateControLoop carries the state between odometry updates, see
+** ROVER_APP_DEAD_RECKON_* in rover_app_history.h.  Dead reckoning keeps
+** integrating past ROVER_APP_ODOM_EXTRAPOLATE_MS.
+*/
+#ifndef ROVER_APP_DEAD_RECKON_MODE
+#define ROVER_APP_DEAD_RECKON_MODE 1
+#endif
+
+/*
+** Uploaded trajectories: most knots in one, and so in each of the two
+** trajectories kept (the running one and the next)
+*/
+#ifndef ROVER_APP_TRAJ_MAX_KNOTS
+#define ROVER_APP_TRAJ_MAX_KNOTS 128
+#endif
+
+/*
+** Path following: most waypoints in a path, and so in each of the two
+** kept (the one followed and the next).  The segment grid has at most
+** ROVER_APP_PATH_GRID_CELLS cells and ROVER_APP_PATH_GRID_ENTRIES
+** segment references; the cells grow until the path fits.
+*/
+#ifndef ROVER_APP_PATH_MAX_POINTS
+#define ROVER_APP_PATH_MAX_POINTS 4096
+#endif
+#ifndef ROVER_APP_PATH_GRID_CELLS
+#define ROVER_APP_PATH_GRID_CELLS ROVER_APP_PATH_MAX_POINTS
+#endif
+#ifndef ROVER_APP_PATH_GRID_ENTRIES
+#define ROVER_APP_PATH_GRID_ENTRIES (4 * ROVER_APP_PATH_MAX_POINTS)
+#endif
+
+/* Default pure pursuit lookahead distance, m */
+#ifndef ROVER_APP_PATH_LOOKAHEAD
+#define ROVER_APP_PATH_LOOKAHEAD 1.0f
+#endif
+
+/* The path is done when the rover is this close to its end, m */
+#ifndef ROVER_APP_PATH_GOAL_TOLERANCE
+#define ROVER_APP_PATH_GOAL_TOLERANCE 0.1f
+#endif
+
+/*
+** Twist shaping defaults, the values in the default table image.  Each
+** axis ramps to the commanded twist with at most these acceleration
+** (m/s^2, rad/s^2) and jerk (m/s^3, rad/s^3) magnitudes, 0 for no limit.
+*/
+#ifndef ROVER_APP_SHAPE_LINEAR_ACCEL_MAX
+#define ROVER_APP_SHAPE_LINEAR_ACCEL_MAX 1.0f
+#endif
+#ifndef ROVER_APP_SHAPE_LINEAR_JERK_MAX
+#define ROVER_APP_SHAPE_LINEAR_JERK_MAX 5.0f
+#endif
+#ifndef ROVER_APP_SHAPE_ANGULAR_ACCEL_MAX
+#define ROVER_APP_SHAPE_ANGULAR_ACCEL_MAX 2.0f
+#endif
+#ifndef ROVER_APP_SHAPE_ANGULAR_JERK_MAX
+#define ROVER_APP_SHAPE_ANGULAR_JERK_MAX 10.0f
+#endif
+
+/*
+** Compact HK packet (ROVER_APP_COMPACT_TLM_MID), sent after every HK
+** packet when enabled, and the default quantization steps of its fields
+** in the table image: m, m/s and rad/s per count.  An int16 holds
+** +-327 m, +-32 m/s and +-32 rad/s at these defaults.
+*/
+#ifndef ROVER_APP_COMPACT_TLM_ENABLE
+#define ROVER_APP_COMPACT_TLM_ENABLE 1
+#endif
+#ifndef ROVER_APP_COMPACT_POSITION_SCALE
+#define ROVER_APP_COMPACT_POSITION_SCALE 0.01f
+#endif
+#ifndef ROVER_APP_COMPACT_LINEAR_SCALE
+#define ROVER_APP_COMPACT_LINEAR_SCALE 0.001f
+#endif
+#ifndef ROVER_APP_COMPACT_ANGULAR_SCALE
+#define ROVER_APP_COMPACT_ANGULAR_SCALE 0.001f
+#endif
+
+/* Longest time step the shaping takes at once, after a gap in HR ticks */
+#ifndef ROVER_APP_SHAPE_MAX_STEP_MS
+#define ROVER_APP_SHAPE_MAX_STEP_MS 100
+#endif
+
+/* Most time-tagged commands sent per HR tick, later ones wait a tick */
+#ifndef ROVER_APP_SCHED_RELEASE_LIMIT
+#define ROVER_APP_SCHED_RELEASE_LIMIT 4
+#endif
+
+/*
+** Output policy of the HR rate telemetry streams until
+** ROVER_APP_SET_OUTPUT_CC changes it: a packet every
+** ROVER_APP_OUTPUT_PERIOD ticks
+*/
+#ifndef ROVER_APP_OUTPUT_PERIOD
+#define ROVER_APP_OUTPUT_PERIOD 1
+#endif
+
+/*
+** HR state bundles (ROVER_APP_STATE_BUNDLE_TLM_MID): room in the packet,
+** and the table defaults for the samples that fill it and the longest a
+** sample waits for the rest, 0 to send only full bundles
+*/
+#ifndef ROVER_APP_BUNDLE_ENABLE
+#define ROVER_APP_BUNDLE_ENABLE 1
+#endif
+#ifndef ROVER_APP_BUNDLE_MAX_SAMPLES
+#define ROVER_APP_BUNDLE_MAX_SAMPLES 32
+#endif
+#ifndef ROVER_APP_BUNDLE_SAMPLES
+#define ROVER_APP_BUNDLE_SAMPLES 10
+#endif
+#ifndef ROVER_APP_BUNDLE_TIMEOUT_MS
+#define ROVER_APP_BUNDLE_TIMEOUT_MS 100
+#endif
+
+/*
+** Build the HR rate telemetry in SB buffers and send them without a copy
+** (see rover_app_txbuf.h), 0 to always send with CFE_SB_TransmitMsg()
+*/
+#ifndef ROVER_APP_ZERO_COPY_ENABLE
+#define ROVER_APP_ZERO_COPY_ENABLE 1
+#endif
+
+/*
+** Event rate limit of every event ID in the table image: events per
+** second on average, 0 for no limit, and how many may go back to back.
+** Events held back are counted and reported every
+** ROVER_APP_EVLIMIT_SUMMARY_S seconds, on an HK request.
+*/
+#ifndef ROVER_APP_EVLIMIT_RATE
+#define ROVER_APP_EVLIMIT_RATE 1.0f
+#endif
+#ifndef ROVER_APP_EVLIMIT_BURST
+#define ROVER_APP_EVLIMIT_BURST 10
+#endif
+#ifndef ROVER_APP_EVLIMIT_SUMMARY_S
+#define ROVER_APP_EVLIMIT_SUMMARY_S 10
+#endif
+
+/*
+** Input recorder (see rover_app_record.h).  The ring holds the messages
+** recorded since the last write, in records of a 16 byte header plus the
+** message rounded up to 16 bytes; it must be a power of two.  The writer
+** task wakes every ROVER_APP_RECORD_TASK_PERIOD_MS and writes once
+** ROVER_APP_RECORD_WRITE_SIZE bytes are waiting, or whatever is waiting
+** ROVER_APP_RECORD_FLUSH_MS after its last write.
+*/
+#ifndef ROVER_APP_RECORD_ENABLE
+#define ROVER_APP_RECORD_ENABLE 1
+#endif
+#ifndef ROVER_APP_RECORD_RING_SIZE
+#define ROVER_APP_RECORD_RING_SIZE 262144
+#endif
+#ifndef ROVER_APP_RECORD_WRITE_SIZE
+#define ROVER_APP_RECORD_WRITE_SIZE 65536
+#endif
+#ifndef ROVER_APP_RECORD_FLUSH_MS
+#define ROVER_APP_RECORD_FLUSH_MS 1000
+#endif
+#ifndef ROVER_APP_RECORD_TASK_PERIOD_MS
+#define ROVER_APP_RECORD_TASK_PERIOD_MS 100
+#endif
+#ifndef ROVER_APP_RECORD_TASK_PRIORITY
+#define ROVER_APP_RECORD_TASK_PRIORITY 200
+#endif
+#ifndef ROVER_APP_RECORD_TASK_STACK_SIZE
+#define ROVER_APP_RECORD_TASK_STACK_SIZE 8192
+#endif
+
+/* Default file for record commands without a name */
+#ifndef ROVER_APP_RECORD_FILE
+#define ROVER_APP_RECORD_FILE "/cf/rover_app_record.bin"
+#endif
+
+/*
+** Flight recorder (see rover_app_blackbox.h): the last ticks kept, a
+** power of two (4096 is about 4 s at 1 kHz, 128 bytes each), the
+** automatic triggers that freeze them, and how old odometry may get
+** before ROVER_APP_BLACKBOX_ODOM_STALE fires
+*/
+#ifndef ROVER_APP_BLACKBOX_ENABLE
+#define ROVER_APP_BLACKBOX_ENABLE 1
+#endif
+#ifndef ROVER_APP_BLACKBOX_ENTRIES
+#define ROVER_APP_BLACKBOX_ENTRIES 4096
+#endif
+#ifndef ROVER_APP_BLACKBOX_TRIGGERS
+#define ROVER_APP_BLACKBOX_TRIGGERS 0x0E /* Odometry stale, length errors, app errors */
+#endif
+#ifndef ROVER_APP_BLACKBOX_STALE_MS
+#define ROVER_APP_BLACKBOX_STALE_MS 500
+#endif
+
+/* Default file for dump commands without a name */
+#ifndef ROVER_APP_BLACKBOX_FILE
+#define ROVER_APP_BLACKBOX_FILE "/cf/rover_app_blackbox.bin"
+#endif
+
+/*
+** Triggered dumps: printf format of their file names, whose %u is the dump
+** number modulo ROVER_APP_BLACKBOX_AUTO_FILES, so the last few are kept
+** without filling the volume; and the time after one before another
+** automatic trigger (app errors excepted) may freeze the ring
+*/
+#ifndef ROVER_APP_BLACKBOX_AUTO_FILE
+#define ROVER_APP_BLACKBOX_AUTO_FILE "/cf/rover_app_blackbox_%u.bin"
+#endif
+#ifndef ROVER_APP_BLACKBOX_AUTO_FILES
+#define ROVER_APP_BLACKBOX_AUTO_FILES 4
+#endif
+#ifndef ROVER_APP_BLACKBOX_HOLDOFF_MS
+#define ROVER_APP_BLACKBOX_HOLDOFF_MS 60000
+#endif
+
+/*
+** RoverAppTable_t under Table Services (see rover_app_params.h), loaded
+** from ROVER_APP_TABLE_FILE at startup; the defaults are used without it
+*/
+#ifndef ROVER_APP_TABLE_NAME
+#define ROVER_APP_TABLE_NAME "RoverAppTable"
+#endif
+#ifndef ROVER_APP_TABLE_FILE
+#define ROVER_APP_TABLE_FILE "/cf/rover_app_tbl.tbl"
+#endif
+
+/*
+** Warm restart from the Critical Data Store (see rover_app_cds.h): the
+** block name, the least time between two writes of it, and how old the
+** block may be for the twists to be restored (0 never restores them, the
+** vehicle then starts from rest)
+*/
+#ifndef ROVER_APP_CDS_ENABLE
+#define ROVER_APP_CDS_ENABLE 1
+#endif
+#ifndef ROVER_APP_CDS_NAME
+#define ROVER_APP_CDS_NAME "RoverAppCds"
+#endif
+#ifndef ROVER_APP_CDS_PERIOD_MS
+#define ROVER_APP_CDS_PERIOD_MS 100
+#endif
+#ifndef ROVER_APP_CDS_TWIST_MAX_AGE_MS
+#define ROVER_APP_CDS_TWIST_MAX_AGE_MS 1000
+#endif
+
+/* Attempts a reader makes to get a consistent copy of shared state */
+#ifndef ROVER_APP_SEQLOCK_MAX_RETRIES
+#define ROVER_APP_SEQLOCK_MAX_RETRIES 16
+#endif
+
+/*
+** Timing instrumentation: the control loop histograms reported in
+** ROVER_APP_DIAG_TLM_MID.  Costs two CFE_TIME_GetTime() calls per HR
+** tick and odometry message.  The per message processing times in
+** ROVER_APP_STATS_TLM_MID are kept either way.
+*/
+#ifndef ROVER_APP_DIAG_ENABLE
+#define ROVER_APP_DIAG_ENABLE 1
+#endif
+
+/*
+** Trace logger
+*/
+
+/* Highest level compiled in, see ROVER_APP_TRACE_LEVEL_* in rover_app_trace.h */
+#ifndef ROVER_APP_TRACE_LEVEL
+#define ROVER_APP_TRACE_LEVEL 2
+#endif
+
+/* Number of records in the trace ring, must be a power of two */
+#ifndef ROVER_APP_TRACE_RING_SIZE
+#define ROVER_APP_TRACE_RING_SIZE 1024
+#endif
+
+/* Set to 1 to stream the ring to ROVER_APP_TRACE_FILE from a child task */
+#ifndef ROVER_APP_TRACE_TASK_ENABLE
+#define ROVER_APP_TRACE_TASK_ENABLE 0
+#endif
+
+#ifndef ROVER_APP_TRACE_TASK_PRIORITY
+#define ROVER_APP_TRACE_TASK_PRIORITY 200
+#endif
+
+#ifndef ROVER_APP_TRACE_TASK_STACK_SIZE
+#define ROVER_APP_TRACE_TASK_STACK_SIZE 8192
+#endif
+
+#ifndef ROVER_APP_TRACE_TASK_PERIOD_MS
+#define ROVER_APP_TRACE_TASK_PERIOD_MS 500
+#endif
+
+/* Default file for the drain task and for dump commands without a name */
+#ifndef ROVER_APP_TRACE_FILE
+#define ROVER_APP_TRACE_FILE "/cf/rover_app_trace.bin"
+#endif
+
+#endif /* _rover_app_platform_cfg_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
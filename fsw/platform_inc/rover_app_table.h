@@ -30,6 +30,8 @@
 #ifndef _rover_app_table_h_
 #define _rover_app_table_h_
 
+#include "rover_app_platform_cfg.h"
+
 /**
  * Table structure
  */
@@ -37,8 +39,54 @@ typedef struct
 {
    uint16 Int1;
    uint16 Int2;
+
+   /* Twist shaping limits, 0 for no limit (see rover_app_shape.h) */
+   float LinearAccelMax;  /* m/s^2 */
+   float LinearJerkMax;   /* m/s^3 */
+   float AngularAccelMax; /* rad/s^2 */
+   float AngularJerkMax;  /* rad/s^3 */
+
+   /* Compact HK quantization steps per field, per count (see rover_app_compact.h) */
+   float PositionScale[3]; /* m, pose x y z */
+   float LinearScale[3];   /* m/s */
+   float AngularScale[3];  /* rad/s */
+
+   /* HR state bundles (see rover_app_bundle.h) */
+   uint16 BundleSamples;   /* Per packet, 1 to ROVER_APP_BUNDLE_MAX_SAMPLES */
+   uint16 BundleTimeoutMs; /* Longest a sample waits, 0 for full bundles only */
+
+   /* Rate limit of every event ID (see rover_app_evlimit.h) */
+   float  EventRate;  /* Events per second, 0 for no limit */
+   uint16 EventBurst; /* Back to back, at least 1 */
+   uint16 Spare;
 } RoverAppTable_t;
 
+/*
+** Default table image, also what the app runs with until a table is loaded
+*/
+#define ROVER_APP_TABLE_DEFAULTS                             \
+   {                                                         \
+      .Int1            = 1,                                  \
+      .Int2            = 2,                                  \
+      .LinearAccelMax  = ROVER_APP_SHAPE_LINEAR_ACCEL_MAX,   \
+      .LinearJerkMax   = ROVER_APP_SHAPE_LINEAR_JERK_MAX,    \
+      .AngularAccelMax = ROVER_APP_SHAPE_ANGULAR_ACCEL_MAX,  \
+      .AngularJerkMax  = ROVER_APP_SHAPE_ANGULAR_JERK_MAX,   \
+      .PositionScale   = {ROVER_APP_COMPACT_POSITION_SCALE,  \
+                          ROVER_APP_COMPACT_POSITION_SCALE,  \
+                          ROVER_APP_COMPACT_POSITION_SCALE}, \
+      .LinearScale     = {ROVER_APP_COMPACT_LINEAR_SCALE,    \
+                          ROVER_APP_COMPACT_LINEAR_SCALE,    \
+                          ROVER_APP_COMPACT_LINEAR_SCALE},   \
+      .AngularScale    = {ROVER_APP_COMPACT_ANGULAR_SCALE,   \
+                          ROVER_APP_COMPACT_ANGULAR_SCALE,   \
+                          ROVER_APP_COMPACT_ANGULAR_SCALE},  \
+      .BundleSamples   = ROVER_APP_BUNDLE_SAMPLES,           \
+      .BundleTimeoutMs = ROVER_APP_BUNDLE_TIMEOUT_MS,        \
+      .EventRate       = ROVER_APP_EVLIMIT_RATE,             \
+      .EventBurst      = ROVER_APP_EVLIMIT_BURST,            \
+   }
+
 #endif /* _rover_app_table_h_ */
 
 /************************/
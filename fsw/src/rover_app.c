@@ -32,6 +32,24 @@
 #include "rover_app_version.h"
 #include "rover_app.h"
 #include "rover_app_table.h"
+#include "rover_app_trace.h"
+#include "rover_app_diag.h"
+#include "rover_app_stats.h"
+#include "rover_app_dispatch.h"
+#include "rover_app_traj.h"
+#include "rover_app_path.h"
+#include "rover_app_sched.h"
+#include "rover_app_shape.h"
+#include "rover_app_fleet.h"
+#include "rover_app_output.h"
+#include "rover_app_compact.h"
+#include "rover_app_bundle.h"
+#include "rover_app_txbuf.h"
+#include "rover_app_evlimit.h"
+#include "rover_app_record.h"
+#include "rover_app_blackbox.h"
+#include "rover_app_params.h"
+#include "rover_app_cds.h"
 
 #include <string.h>
 
@@ -43,8 +61,6 @@
 RoverAppData_t RoverAppData;
 RoverAppOdometry_t lastOdomMsg;
 
-void HighRateControLoop(void);
-
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *  * *  * * * * **/
 /* RoverAppMain() -- Application entry point and main process loop         */
 /*                                                                            */
@@ -86,12 +102,13 @@ void RoverAppMain(void)
 
         if (status == CFE_SUCCESS)
         {
-            RoverAppProcessCommandPacket(SBBufPtr);
+            RoverAppDrainPipe(RoverAppData.CommandPipe, SBBufPtr);
         }
         else
         {
-            CFE_EVS_SendEvent(ROVER_APP_PIPE_ERR_EID, CFE_EVS_EventType_ERROR,
-                              "Rover App: SB Pipe Read Error, App Will Exit");
+            ROVER_APP_EVENT(ROVER_APP_PIPE_ERR_EID, CFE_EVS_EventType_ERROR,
+                            "Rover App: SB Pipe Read Error, App Will Exit");
+            RoverAppBlackBoxTrigger(ROVER_APP_BLACKBOX_APP_ERROR);
 
             RoverAppData.RunStatus = CFE_ES_RunStatus_APP_ERROR;
         }
@@ -102,6 +119,15 @@ void RoverAppMain(void)
         CFE_ES_PerfLogEntry(ROVER_APP_PERF_ID);
     }
 
+    /*
+    ** Keep the last seconds of the control loop before an error exit
+    */
+    if (RoverAppData.RunStatus == CFE_ES_RunStatus_APP_ERROR)
+    {
+        RoverAppBlackBoxTrigger(ROVER_APP_BLACKBOX_APP_ERROR);
+    }
+    RoverAppBlackBoxService();
+
     /*
     ** Performance Log Exit Stamp
     */
@@ -119,7 +145,14 @@ void RoverAppMain(void)
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 int32 RoverAppInit(void)
 {
-    int32 status;
+    int32            status;
+    uint32           i;
+    uint32           j;
+    RoverAppParams_t Params;
+#if ROVER_APP_CDS_ENABLE
+    RoverAppCdsBlock_t Cds;
+    uint32             Restore;
+#endif
 
     RoverAppData.RunStatus = CFE_ES_RunStatus_APP_RUN;
 
@@ -128,7 +161,6 @@ int32 RoverAppInit(void)
     */
     RoverAppData.CmdCounter = 0;
     RoverAppData.ErrCounter = 0;
-    RoverAppData.square_counter = 0;
     RoverAppData.hk_counter = 0;
 
     RoverAppData.HkTlm.Payload.state.pose.x = 0.0;
@@ -139,6 +171,14 @@ int32 RoverAppInit(void)
     RoverAppData.HkTlm.Payload.state.pose.qz = 0.0;
     RoverAppData.HkTlm.Payload.state.pose.qw = 0.0;
 
+    memset(&RoverAppData.TwistCell, 0, sizeof(RoverAppData.TwistCell));
+    memset(&RoverAppData.StateCell, 0, sizeof(RoverAppData.StateCell));
+    RoverAppData.StaleReadCount = 0;
+    memset(RoverAppData.Latest, 0, sizeof(RoverAppData.Latest));
+    RoverAppOdomHistoryInit(&RoverAppData.OdomHistory);
+    memset(&RoverAppData.DeadReckon, 0, sizeof(RoverAppData.DeadReckon));
+    memset(&lastOdomMsg, 0, sizeof(lastOdomMsg));
+
     /*
     ** Initialize app configuration data
     */
@@ -164,6 +204,54 @@ int32 RoverAppInit(void)
     RoverAppData.EventFilters[5].Mask    = 0x0000;
     RoverAppData.EventFilters[6].EventID = ROVER_APP_PIPE_ERR_EID;
     RoverAppData.EventFilters[6].Mask    = 0x0000;
+    RoverAppData.EventFilters[7].EventID = ROVER_APP_TRACE_DUMP_INF_EID;
+    RoverAppData.EventFilters[7].Mask    = 0x0000;
+    RoverAppData.EventFilters[8].EventID = ROVER_APP_TRACE_ERR_EID;
+    RoverAppData.EventFilters[8].Mask    = 0x0000;
+    RoverAppData.EventFilters[9].EventID = ROVER_APP_DIAG_RESET_INF_EID;
+    RoverAppData.EventFilters[9].Mask    = 0x0000;
+    RoverAppData.EventFilters[10].EventID = ROVER_APP_TRAJ_INF_EID;
+    RoverAppData.EventFilters[10].Mask    = 0x0000;
+    RoverAppData.EventFilters[11].EventID = ROVER_APP_TRAJ_ERR_EID;
+    RoverAppData.EventFilters[11].Mask    = 0x0000;
+    RoverAppData.EventFilters[12].EventID = ROVER_APP_SCHED_INF_EID;
+    RoverAppData.EventFilters[12].Mask    = 0x0000;
+    RoverAppData.EventFilters[13].EventID = ROVER_APP_SCHED_ERR_EID;
+    RoverAppData.EventFilters[13].Mask    = 0x0000;
+    RoverAppData.EventFilters[14].EventID = ROVER_APP_PATH_INF_EID;
+    RoverAppData.EventFilters[14].Mask    = 0x0000;
+    RoverAppData.EventFilters[15].EventID = ROVER_APP_PATH_ERR_EID;
+    RoverAppData.EventFilters[15].Mask    = 0x0000;
+    RoverAppData.EventFilters[16].EventID = ROVER_APP_FLEET_INF_EID;
+    RoverAppData.EventFilters[16].Mask    = 0x0000;
+    RoverAppData.EventFilters[17].EventID = ROVER_APP_OUTPUT_INF_EID;
+    RoverAppData.EventFilters[17].Mask    = 0x0000;
+    RoverAppData.EventFilters[18].EventID = ROVER_APP_OUTPUT_ERR_EID;
+    RoverAppData.EventFilters[18].Mask    = 0x0000;
+    RoverAppData.EventFilters[19].EventID = ROVER_APP_EVLIMIT_INF_EID;
+    RoverAppData.EventFilters[19].Mask    = 0x0000;
+    RoverAppData.EventFilters[20].EventID = ROVER_APP_EVLIMIT_ERR_EID;
+    RoverAppData.EventFilters[20].Mask    = 0x0000;
+    RoverAppData.EventFilters[21].EventID = ROVER_APP_EVLIMIT_SUMMARY_EID;
+    RoverAppData.EventFilters[21].Mask    = 0x0000;
+    RoverAppData.EventFilters[22].EventID = ROVER_APP_RECORD_INF_EID;
+    RoverAppData.EventFilters[22].Mask    = 0x0000;
+    RoverAppData.EventFilters[23].EventID = ROVER_APP_RECORD_ERR_EID;
+    RoverAppData.EventFilters[23].Mask    = 0x0000;
+    RoverAppData.EventFilters[24].EventID = ROVER_APP_BLACKBOX_INF_EID;
+    RoverAppData.EventFilters[24].Mask    = 0x0000;
+    RoverAppData.EventFilters[25].EventID = ROVER_APP_BLACKBOX_ERR_EID;
+    RoverAppData.EventFilters[25].Mask    = 0x0000;
+    RoverAppData.EventFilters[26].EventID = ROVER_APP_TABLE_INF_EID;
+    RoverAppData.EventFilters[26].Mask    = 0x0000;
+    RoverAppData.EventFilters[27].EventID = ROVER_APP_TABLE_ERR_EID;
+    RoverAppData.EventFilters[27].Mask    = 0x0000;
+    RoverAppData.EventFilters[28].EventID = ROVER_APP_CDS_INF_EID;
+    RoverAppData.EventFilters[28].Mask    = 0x0000;
+    RoverAppData.EventFilters[29].EventID = ROVER_APP_CDS_ERR_EID;
+    RoverAppData.EventFilters[29].Mask    = 0x0000;
+    RoverAppData.EventFilters[30].EventID = ROVER_APP_ODOM_RESEED_INF_EID;
+    RoverAppData.EventFilters[30].Mask    = 0x0000;
 
     status = CFE_EVS_Register(RoverAppData.EventFilters, ROVER_APP_EVENT_COUNTS, CFE_EVS_EventFilter_BINARY);
     if (status != CFE_SUCCESS)
@@ -173,68 +261,171 @@ int32 RoverAppInit(void)
     }
 
     /*
-    ** Initialize housekeeping packet (clear user data area).
+    ** Register and load the table
     */
-    CFE_MSG_Init(&RoverAppData.HkTlm.TlmHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_HK_TLM_MID), sizeof(RoverAppData.HkTlm));
-    CFE_MSG_Init(&RoverAppData.LastTwist.TlmHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_TLM_TWIST_MID), sizeof(RoverAppData.LastTwist));
+    status = RoverAppParamsInit(&Params);
+    if (status != CFE_SUCCESS)
+    {
+        return (status);
+    }
+    RoverAppEvLimitInit(&Params.EventLimit);
 
     /*
-    ** Create Software Bus message pipe.
+    ** Initialize the trace logger
     */
-    status = CFE_SB_CreatePipe(&RoverAppData.CommandPipe, RoverAppData.PipeDepth, RoverAppData.PipeName);
+    status = RoverAppTraceInit();
     if (status != CFE_SUCCESS)
     {
-        CFE_ES_WriteToSysLog("Rover App: Error creating pipe, RC = 0x%08lX\n", (unsigned long)status);
         return (status);
     }
 
     /*
-    ** Subscribe to Housekeeping request commands
+    ** Initialize the input recorder
     */
-    status = CFE_SB_Subscribe(CFE_SB_ValueToMsgId(ROVER_APP_SEND_HK_MID), RoverAppData.CommandPipe);
+    status = RoverAppRecordInit();
     if (status != CFE_SUCCESS)
     {
-        CFE_ES_WriteToSysLog("Rover App: Error Subscribing to HK request, RC = 0x%08lX\n", (unsigned long)status);
         return (status);
     }
 
     /*
-    ** Subscribe to ground command packets
+    ** Build the dispatch tables from rover_app_schema.h
     */
-    status = CFE_SB_Subscribe(CFE_SB_ValueToMsgId(ROVER_APP_CMD_MID), RoverAppData.CommandPipe);
+    status = RoverAppDispatchInit();
     if (status != CFE_SUCCESS)
     {
-        CFE_ES_WriteToSysLog("Rover App: Error Subscribing to Command, RC = 0x%08lX\n", (unsigned long)status);
-
         return (status);
     }
 
+    RoverAppDiagInit();
+    RoverAppStatsInit();
+    RoverAppTrajInit();
+    RoverAppPathInit();
+    RoverAppSchedInit();
+    RoverAppShapeInit(&Params);
+    RoverAppOutputInit();
+    RoverAppTxBufInit();
+    RoverAppBlackBoxInit();
+    memcpy(RoverAppData.CompactScale, Params.CompactScale, sizeof(RoverAppData.CompactScale));
+#if ROVER_APP_BUNDLE_ENABLE
+    RoverAppBundleInit(&Params);
+#endif
+#if ROVER_APP_FLEET_SIZE > 0
+    RoverAppFleetInit(&Params);
+#endif
+    memset(&RoverAppData.TargetTwist, 0, sizeof(RoverAppData.TargetTwist));
+    RoverAppData.LastTickStamp = 0;
+
+    /*
+    ** Initialize housekeeping packet (clear user data area).
+    */
+    CFE_MSG_Init(&RoverAppData.HkTlm.TlmHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_HK_TLM_MID), sizeof(RoverAppData.HkTlm));
+    CFE_MSG_Init(&RoverAppData.LastTwist.TlmHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_TLM_TWIST_MID), sizeof(RoverAppData.LastTwist));
+    CFE_MSG_Init(&RoverAppData.CompactTlm.TlmHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_COMPACT_TLM_MID), sizeof(RoverAppData.CompactTlm));
+
+#if ROVER_APP_CDS_ENABLE
+    /*
+    ** Carry on from the state the previous run left in the CDS: the pose
+    ** anchors dead reckoning until odometry arrives, and shaping ramps on
+    ** from the twist that was being sent.  With that twist recent, dead
+    ** reckoning also covers the time since the block was written.
+    */
+    Restore = RoverAppCdsInit(&Cds);
+    if (Restore & ROVER_APP_CDS_RESTORE_COUNTERS)
+    {
+        RoverAppData.CmdCounter = Cds.CmdCounter;
+        RoverAppData.ErrCounter = Cds.ErrCounter;
+    }
+    if (Restore & ROVER_APP_CDS_RESTORE_POSE)
+    {
+        /* A twist too old to restore would be dead-reckoned into the pose */
+        if (!(Restore & ROVER_APP_CDS_RESTORE_TWIST))
+        {
+            memset(&Cds.State.twist, 0, sizeof(Cds.State.twist));
+        }
+
+        lastOdomMsg                      = Cds.State;
+        RoverAppData.DeadReckon.Anchored = true;
+        RoverAppData.DeadReckon.Stamp    = (Restore & ROVER_APP_CDS_RESTORE_TWIST)
+                                               ? Cds.Stamp
+                                               : RoverAppTimeToStamp(CFE_TIME_GetTime());
+        RoverAppData.DeadReckon.State    = Cds.State;
+        RoverAppData.HkTlm.Payload.state = Cds.State;
+        RoverAppOdomPublish(&RoverAppData.StateCell, &lastOdomMsg);
+    }
+    if (Restore & ROVER_APP_CDS_RESTORE_TWIST)
+    {
+        RoverAppData.LastTwist.twist = Cds.Twist;
+        RoverAppShapeSeed(&Cds.Twist);
+    }
+    if (Restore & ROVER_APP_CDS_RESTORE_COMMAND)
+    {
+        RoverAppData.TargetTwist = Cds.Target;
+        RoverAppTwistPublish(&RoverAppData.TwistCell, &Cds.Target);
+    }
+#endif
 
     /*
-    ** Subscribe to flight odom data
+    ** Create Software Bus message pipe.
     */
-    status = CFE_SB_Subscribe(CFE_SB_ValueToMsgId(ROVER_APP_CMD_ODOM_MID), RoverAppData.CommandPipe);
+    status = CFE_SB_CreatePipe(&RoverAppData.CommandPipe, RoverAppData.PipeDepth, RoverAppData.PipeName);
     if (status != CFE_SUCCESS)
     {
-        CFE_ES_WriteToSysLog("Rover App: Error Subscribing to Odom data, RC = 0x%08lX\n", (unsigned long)status);
+        CFE_ES_WriteToSysLog("Rover App: Error creating pipe, RC = 0x%08lX\n", (unsigned long)status);
+        return (status);
+    }
 
+    /*
+    ** Control traffic gets its own pipe when a control task services it
+    */
+#if ROVER_APP_CONTROL_TASK_ENABLE
+    status = CFE_SB_CreatePipe(&RoverAppData.ControlPipe, ROVER_APP_CONTROL_PIPE_DEPTH, "ROVER_APP_CTRL_PIPE");
+    if (status != CFE_SUCCESS)
+    {
+        CFE_ES_WriteToSysLog("Rover App: Error creating control pipe, RC = 0x%08lX\n", (unsigned long)status);
         return (status);
     }
+#else
+    RoverAppData.ControlPipe = RoverAppData.CommandPipe;
+#endif
 
-    
     /*
-    ** Subscribe to HR wakeup
+    ** Subscribe to everything in the message schema, each MID of a range
+    */
+    for (i = 0; i < ROVER_APP_SUBSCRIPTION_COUNT; i++)
+    {
+        for (j = 0; j < RoverAppSubscriptions[i].Count; j++)
+        {
+            status = CFE_SB_Subscribe(CFE_SB_ValueToMsgId(RoverAppSubscriptions[i].MsgId + j),
+                                      (RoverAppSubscriptions[i].Pipe == ROVER_APP_PIPE_CONTROL)
+                                          ? RoverAppData.ControlPipe
+                                          : RoverAppData.CommandPipe);
+            if (status != CFE_SUCCESS)
+            {
+                CFE_ES_WriteToSysLog("Rover App: Error Subscribing to %s %u, RC = 0x%08lX\n",
+                                     RoverAppSubscriptions[i].Name, (unsigned int)j, (unsigned long)status);
+                return (status);
+            }
+        }
+    }
+
+#if ROVER_APP_CONTROL_TASK_ENABLE
+    /*
+    ** Start the control task last, once its pipe is fully subscribed
     */
-    status = CFE_SB_Subscribe(CFE_SB_ValueToMsgId(ROVER_APP_HR_CONTROL_MID), RoverAppData.CommandPipe);
+    status = CFE_ES_CreateChildTask(&RoverAppData.ControlTaskId, "ROVER_APP_CTRL", RoverAppControlTask,
+                                    CFE_ES_TASK_STACK_ALLOCATE, ROVER_APP_CONTROL_TASK_STACK_SIZE,
+                                    ROVER_APP_CONTROL_TASK_PRIORITY, 0);
     if (status != CFE_SUCCESS)
     {
-        CFE_ES_WriteToSysLog("Rover App: Error Subscribing to HR Wakeup Command, RC = 0x%08lX\n", (unsigned long)status);
+        CFE_ES_WriteToSysLog("Rover App: Error creating control task, RC = 0x%08lX\n", (unsigned long)status);
 
         return (status);
     }
+#endif
 
-    CFE_EVS_SendEvent(ROVER_APP_STARTUP_INF_EID, CFE_EVS_EventType_INFORMATION, "Rover App Initialized.%s",
-                      ROVER_APP_VERSION_STRING);
+    ROVER_APP_EVENT(ROVER_APP_STARTUP_INF_EID, CFE_EVS_EventType_INFORMATION, "Rover App Initialized.%s",
+                    ROVER_APP_VERSION_STRING);
 
     return (CFE_SUCCESS);
 
@@ -242,120 +433,243 @@ int32 RoverAppInit(void)
 
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-/*  Name:  RoverAppProcessCommandPacket                                    */
+/* RoverAppControlTask() -- control child task entry point and loop           */
+/*                                                                            */
+/*   Services HR wakeups and odometry only, so ground and HK traffic on the  */
+/*   main task cannot delay a control tick.                                   */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppControlTask(void)
+{
+    int32            status;
+    CFE_SB_Buffer_t *SBBufPtr;
+
+    CFE_ES_PerfLogEntry(ROVER_APP_CONTROL_PERF_ID);
+
+    while (RoverAppData.RunStatus == CFE_ES_RunStatus_APP_RUN)
+    {
+        CFE_ES_PerfLogExit(ROVER_APP_CONTROL_PERF_ID);
+
+        status = CFE_SB_ReceiveBuffer(&SBBufPtr, RoverAppData.ControlPipe, CFE_SB_PEND_FOREVER);
+
+        CFE_ES_PerfLogEntry(ROVER_APP_CONTROL_PERF_ID);
+
+        if (status == CFE_SUCCESS)
+        {
+            RoverAppDrainPipe(RoverAppData.ControlPipe, SBBufPtr);
+        }
+        else
+        {
+            ROVER_APP_EVENT(ROVER_APP_PIPE_ERR_EID, CFE_EVS_EventType_ERROR,
+                            "Rover App: SB Control Pipe Read Error, App Will Exit");
+            RoverAppBlackBoxTrigger(ROVER_APP_BLACKBOX_APP_ERROR);
+
+            RoverAppData.RunStatus = CFE_ES_RunStatus_APP_ERROR;
+        }
+    }
+
+    CFE_ES_PerfLogExit(ROVER_APP_CONTROL_PERF_ID);
+
+    CFE_ES_ExitChildTask();
+
+} /* End of RoverAppControlTask() */
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*  Name:  RoverAppDrainPipe                                                  */
 /*                                                                            */
 /*  Purpose:                                                                  */
-/*     This routine will process any packet that is received on the ros    */
-/*     command pipe.                                                          */
+/*     Handles the buffer a blocking receive returned, then whatever else is */
+/*     already queued on the pipe, up to ROVER_APP_PIPE_BATCH_LIMIT messages. */
+/*     Runs of odometry and SET_TWIST messages are coalesced to the newest   */
+/*     of each stream; everything else is dispatched in order, after any     */
+/*     coalesced message that arrived before it.                              */
 /*                                                                            */
 /* * * * * * * * * * * * * * * * * * * * * * * *  * * * * * * *  * *  * * * * */
-void RoverAppProcessCommandPacket(CFE_SB_Buffer_t *SBBufPtr)
+void RoverAppDrainPipe(CFE_SB_PipeId_t PipeId, CFE_SB_Buffer_t *SBBufPtr)
 {
-    CFE_SB_MsgId_t MsgId = CFE_SB_INVALID_MSG_ID;
+    uint32 PendingMask = 0; /* Latest[] slots held back by this batch */
+    uint32 Count       = 0;
+    uint32 Index;
 
-    CFE_MSG_GetMsgId(&SBBufPtr->Msg, &MsgId);
-    //printf("RoverAppProcessCommandPacket() -- we're processing the cmd from MID: 0x%04x\n", CFE_SB_MsgIdToValue(MsgId));
-    switch (CFE_SB_MsgIdToValue(MsgId))
+    do
     {
-        case ROVER_APP_CMD_MID:
-            RoverAppProcessGroundCommand(SBBufPtr);
-            break;
+        Index = RoverAppDispatchLookup(&SBBufPtr->Msg);
 
-        case ROVER_APP_SEND_HK_MID:
-            RoverAppReportHousekeeping((CFE_MSG_CommandHeader_t *)SBBufPtr);
-            break;
+        RoverAppStatsReceived(Index, &SBBufPtr->Msg);
 
-        case ROVER_APP_CMD_ODOM_MID:
-            RoverAppProcessFlightOdom(SBBufPtr);
-            break;
+        if (!RoverAppCoalesce(SBBufPtr, Index, &PendingMask))
+        {
+            RoverAppFlushLatest(&PendingMask);
+            RoverAppDispatchMsg(SBBufPtr, Index);
+        }
 
-        case ROVER_APP_HR_CONTROL_MID:
-            HighRateControLoop();
-            break;
-            
-        default:
-            CFE_EVS_SendEvent(ROVER_APP_INVALID_MSGID_ERR_EID, CFE_EVS_EventType_ERROR,
-                              "rover app: invalid command packet,MID = 0x%x", (unsigned int)CFE_SB_MsgIdToValue(MsgId));
-            break;
-    }
+        Count++;
+
+    } while (Count < ROVER_APP_PIPE_BATCH_LIMIT &&
+             CFE_SB_ReceiveBuffer(&SBBufPtr, PipeId, CFE_SB_POLL) == CFE_SUCCESS);
+
+    RoverAppFlushLatest(&PendingMask);
 
     return;
 
-} /* End RoverAppProcessCommandPacket */
+} /* End RoverAppDrainPipe */
 
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*  Name:  RoverAppCoalesce                                                   */
 /*                                                                            */
-/* RoverAppProcessGroundCommand() -- rover app ground commands                */
+/*  Purpose:                                                                  */
+/*     Copies a well formed odometry or SET_TWIST message into its Latest[]  */
+/*     slot, replacing one held earlier in the batch.  Returns false for     */
+/*     messages that must be handled now, including malformed ones so their  */
+/*     length errors are still reported.                                      */
 /*                                                                            */
-/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-void RoverAppProcessGroundCommand(CFE_SB_Buffer_t *SBBufPtr)
+/* * * * * * * * * * * * * * * * * * * * * * * *  * * * * * * *  * *  * * * * */
+bool RoverAppCoalesce(const CFE_SB_Buffer_t *SBBufPtr, uint32 Index, uint32 *PendingMask)
 {
-    CFE_MSG_FcnCode_t CommandCode = 0;
+    CFE_MSG_Size_t          Size = 0;
+    CFE_MSG_SequenceCount_t Seq  = 0;
+    RoverAppLatest_t       *Latest;
+    uint32                  Slot;
+
+    switch (Index)
+    {
+        case ROVER_APP_MSG_ODOM:
+            Slot = ROVER_APP_LATEST_ODOM;
+            break;
+
+        case ROVER_APP_MSG_SET_TWIST:
+            Slot = ROVER_APP_LATEST_TWIST;
+            break;
 
-    CFE_MSG_GetFcnCode(&SBBufPtr->Msg, &CommandCode);
+        default:
+            return false;
+    }
+
+    CFE_MSG_GetSize(&SBBufPtr->Msg, &Size);
+    if (Size != RoverAppDispatchTable[Index].ExpectedLength)
+    {
+        return false;
+    }
 
-    printf("RoverAppProcessGroundCommand() -- we're getting a ground command...%d\n", CommandCode);
+    Latest = &RoverAppData.Latest[Slot];
 
     /*
-    ** Process "known" rover app ground commands
+    ** Odometry has a MID of its own, so a jump in its sequence count means
+    ** messages were lost on the way (e.g. a full pipe).  Ground commands
+    ** share theirs with the other command codes.
     */
-    switch (CommandCode)
+    if (Slot == ROVER_APP_LATEST_ODOM)
     {
-        case ROVER_APP_NOOP_CC:
-            if (RoverAppVerifyCmdLength(&SBBufPtr->Msg, sizeof(RoverAppNoopCmd_t)))
-            {
-                RoverAppNoop((RoverAppNoopCmd_t *)SBBufPtr);
-            }
+        CFE_MSG_GetSequenceCount(&SBBufPtr->Msg, &Seq);
+        if (Latest->SeqValid && Seq != Latest->LastSeq)
+        {
+            Latest->DroppedCount += (uint32)((Seq - Latest->LastSeq - 1) & ROVER_APP_SEQ_COUNT_MASK);
+        }
+        Latest->LastSeq  = Seq;
+        Latest->SeqValid = true;
+    }
 
-            break;
+    if (*PendingMask & (1u << Slot))
+    {
+        Latest->CoalescedCount++;
+    }
 
-        case ROVER_APP_SET_TWIST_CC:
-            if (RoverAppVerifyCmdLength(&SBBufPtr->Msg, sizeof(RoverAppTwistCmd_t)))
-            {
-                RoverAppCmdTwist((RoverAppTwistCmd_t *)SBBufPtr);
-            }
+    memcpy(&Latest->Msg, SBBufPtr, Size);
+    Latest->Index = Index;
+    *PendingMask |= (1u << Slot);
 
-            break;
+    return true;
 
-        /* default case already found during FC vs length test */
-        default:
-            CFE_EVS_SendEvent(ROVER_APP_COMMAND_ERR_EID, CFE_EVS_EventType_ERROR,
-                              "Invalid ground command code: CC = %d", CommandCode);
-            break;
+} /* End RoverAppCoalesce */
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*  Name:  RoverAppFlushLatest                                                */
+/*                                                                            */
+/*  Purpose:                                                                  */
+/*     Dispatches the messages held back by the current batch.               */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * *  * * * * * * *  * *  * * * * */
+void RoverAppFlushLatest(uint32 *PendingMask)
+{
+    uint32 Slot;
+
+    for (Slot = 0; Slot < ROVER_APP_LATEST_COUNT && *PendingMask != 0; Slot++)
+    {
+        if (*PendingMask & (1u << Slot))
+        {
+            *PendingMask &= ~(1u << Slot);
+            RoverAppDispatchMsg(&RoverAppData.Latest[Slot].Msg.Buf, RoverAppData.Latest[Slot].Index);
+        }
     }
 
+    return;
+
+} /* End RoverAppFlushLatest */
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*  Name:  RoverAppProcessCommandPacket                                    */
+/*                                                                            */
+/*  Purpose:                                                                  */
+/*     This routine will process any packet that is received on the ros    */
+/*     command or control pipes, one at a time (see rover_app_schema.h).     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * *  * * * * * * *  * *  * * * * */
+void RoverAppProcessCommandPacket(CFE_SB_Buffer_t *SBBufPtr)
+{
+    RoverAppDispatchMsg(SBBufPtr, RoverAppDispatchLookup(&SBBufPtr->Msg));
 
     return;
 
-} /* End of RoverAppProcessFlightOdom() */
+} /* End RoverAppProcessCommandPacket */
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 /*                                                                            */
 /* RoverAppProcessFlightOdom() -- rover app flight odometry                   */
 /*                                                                            */
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-void RoverAppProcessFlightOdom(CFE_SB_Buffer_t *SBBufPtr)
+int32 RoverAppProcessFlightOdom(const RoverAppCmdRobotState_t *Msg)
 {
-    CFE_MSG_FcnCode_t CommandCode = 0;
+    CFE_TIME_SysTime_t Arrival = CFE_TIME_GetTime();
+    CFE_TIME_SysTime_t Time;
+    int32              Status;
 
-    CFE_MSG_GetFcnCode(&SBBufPtr->Msg, &CommandCode);
+    ROVER_APP_TRACE_MSG(ROVER_APP_TRACE_LEVEL_DEBUG, ROVER_APP_TRACE_PT_ODOM, &Msg->CmdHeader.Msg, CFE_SUCCESS);
 
-    printf("RoverAppProcessGroundCommand() -- we're getting a flight odometry message ...%d\n", CommandCode);
+    // Sample time from the header, or arrival time when it has none
+    if (CFE_MSG_GetMsgTime(&Msg->CmdHeader.Msg, &Time) != CFE_SUCCESS || (Time.Seconds == 0 && Time.Subseconds == 0))
+    {
+        Time = Arrival;
+    }
 
-    // Read
-    if (RoverAppVerifyCmdLength(&SBBufPtr->Msg, sizeof(RoverAppCmdRobotState_t)))
+    // Hand the new state to the control loop
+    Status = RoverAppOdomHistoryInsert(&RoverAppData.OdomHistory, RoverAppTimeToStamp(Time), &Msg->odom);
+    if (Status == ROVER_APP_HISTORY_RESEEDED)
+    {
+        ROVER_APP_EVENT(ROVER_APP_ODOM_RESEED_INF_EID, CFE_EVS_EventType_INFORMATION,
+                        "rover app: odometry time jumped back to %u s, history restarted",
+                        (unsigned int)Time.Seconds);
+    }
+    if (Status != ROVER_APP_HISTORY_REJECTED)
     {
-       RoverAppCmdRobotState_t* state = (RoverAppCmdRobotState_t *)SBBufPtr;
-       
-       // Fill the lastState
-       lastOdomMsg = state->odom;                     
+        RoverAppData.DeadReckon.Reanchor = true;
     }
 
+#if ROVER_APP_BUNDLE_ENABLE
+    // Samples of the last HR ticks still go out if the ticks stopped
+    RoverAppBundlePoll(RoverAppTimeToStamp(Arrival));
+#endif
 
-    return;
+#if ROVER_APP_DIAG_ENABLE
+    RoverAppDiagAdd(ROVER_APP_DIAG_ODOM_EXEC, RoverAppTimeToStamp(Arrival), RoverAppTimeToStamp(CFE_TIME_GetTime()));
+#endif
 
-} /* End of RoverAppProcessFlightCommand() */
+    return CFE_SUCCESS;
+
+} /* End of RoverAppProcessFlightOdom() */
 
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
@@ -367,23 +681,66 @@ void RoverAppProcessFlightOdom(CFE_SB_Buffer_t *SBBufPtr)
 /*         telemetry, packetize it and send it to the housekeeping task via   */
 /*         the software bus                                                   */
 /* * * * * * * * * * * * * * * * * * * * * * * *  * * * * * * *  * *  * * * * */
-int32 RoverAppReportHousekeeping(const CFE_MSG_CommandHeader_t *Msg)
+int32 RoverAppReportHousekeeping(const CFE_MSG_Message_t *Msg)
 {
-    printf("RoverAppReportHousekeeping() -- sending odom as part of housekeeping...\n");
-    
     /*
     ** Get command execution counters...
     */
-    RoverAppData.HkTlm.Payload.CommandErrorCounter = RoverAppData.ErrCounter*2;
-    RoverAppData.ErrCounter++;
-    RoverAppData.HkTlm.Payload.CommandCounter      = RoverAppData.CmdCounter++;
+    RoverAppData.HkTlm.Payload.CommandErrorCounter = __atomic_fetch_add(&RoverAppData.ErrCounter, 1, __ATOMIC_RELAXED)*2;
+    RoverAppData.HkTlm.Payload.CommandCounter      = __atomic_fetch_add(&RoverAppData.CmdCounter, 1, __ATOMIC_RELAXED);
 
-    OS_printf("RoverAppReportHousekeeping reporting: %d\n", RoverAppData.HkTlm.Payload.CommandCounter);
+    /*
+    ** Latest state published by the control loop; keep the previous one
+    ** if the loop is publishing right now
+    */
+    if (!RoverAppOdomRead(&RoverAppData.StateCell, &RoverAppData.HkTlm.Payload.state))
+    {
+        __atomic_fetch_add(&RoverAppData.StaleReadCount, 1, __ATOMIC_RELAXED);
+    }
+
+    RoverAppData.HkTlm.Payload.CoalescedCount = RoverAppData.Latest[ROVER_APP_LATEST_ODOM].CoalescedCount +
+                                                RoverAppData.Latest[ROVER_APP_LATEST_TWIST].CoalescedCount;
+    RoverAppData.HkTlm.Payload.DroppedCount   = RoverAppData.Latest[ROVER_APP_LATEST_ODOM].DroppedCount;
+    RoverAppOutputCounts(RoverAppData.HkTlm.Payload.OutputSentCount, RoverAppData.HkTlm.Payload.OutputSuppressedCount);
+    RoverAppTxBufCounts(&RoverAppData.HkTlm.Payload.TxZeroCopyCount, &RoverAppData.HkTlm.Payload.TxFallbackCount,
+                        &RoverAppData.HkTlm.Payload.TxErrorCount);
+    RoverAppEvLimitSummary(RoverAppTimeToStamp(CFE_TIME_GetTime()));
+    RoverAppData.HkTlm.Payload.EventSuppressedCount = RoverAppEvLimitSuppressed();
+    RoverAppRecordCounts(&RoverAppData.HkTlm.Payload.RecordCount, &RoverAppData.HkTlm.Payload.RecordDropCount);
+    RoverAppBlackBoxService();
+    RoverAppData.HkTlm.Payload.BlackBoxDumpCount = RoverAppBlackBoxDumps();
+    RoverAppParamsManage();
+    RoverAppParamsCounts(&RoverAppData.HkTlm.Payload.TableUpdateCount, &RoverAppData.HkTlm.Payload.TableRejectCount);
+    RoverAppData.HkTlm.Payload.CdsSaveCount = RoverAppCdsSaves();
+    RoverAppData.HkTlm.Payload.OdomRejectedCount =
+        __atomic_load_n(&RoverAppData.OdomHistory.RejectedCount, __ATOMIC_RELAXED);
+    RoverAppData.HkTlm.Payload.OdomReseedCount = __atomic_load_n(&RoverAppData.OdomHistory.ReseedCount, __ATOMIC_RELAXED);
+    RoverAppData.HkTlm.Payload.StaleReadCount  = __atomic_load_n(&RoverAppData.StaleReadCount, __ATOMIC_RELAXED);
+
+    ROVER_APP_TRACE(ROVER_APP_TRACE_LEVEL_INFO, ROVER_APP_TRACE_PT_HK, ROVER_APP_HK_TLM_MID, 0,
+                    sizeof(RoverAppData.HkTlm), RoverAppData.HkTlm.Payload.CommandCounter);
 
  
     CFE_SB_TimeStampMsg(&RoverAppData.HkTlm.TlmHeader.Msg);
     CFE_SB_TransmitMsg(&RoverAppData.HkTlm.TlmHeader.Msg, true);
 
+#if ROVER_APP_COMPACT_TLM_ENABLE
+    /*
+    ** Same state, quantized for low-rate links
+    */
+    RoverAppData.CompactTlm.Payload.CommandErrorCounter = RoverAppData.HkTlm.Payload.CommandErrorCounter;
+    RoverAppData.CompactTlm.Payload.CommandCounter      = RoverAppData.HkTlm.Payload.CommandCounter;
+    RoverAppData.CompactTlm.Payload.TableGeneration     = (uint16)RoverAppData.HkTlm.Payload.TableUpdateCount;
+    RoverAppCompactEncode(&RoverAppData.HkTlm.Payload.state, RoverAppData.CompactScale,
+                          &RoverAppData.CompactTlm.Payload.State);
+    CFE_SB_TimeStampMsg(&RoverAppData.CompactTlm.TlmHeader.Msg);
+    CFE_SB_TransmitMsg(&RoverAppData.CompactTlm.TlmHeader.Msg, true);
+#endif
+
+#if ROVER_APP_DIAG_ENABLE
+    RoverAppDiagReport();
+#endif
+
     return CFE_SUCCESS;
 
 } /* End of RoverAppReportHousekeeping() */
@@ -396,8 +753,8 @@ int32 RoverAppReportHousekeeping(const CFE_MSG_CommandHeader_t *Msg)
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 int32 RoverAppNoop(const RoverAppNoopCmd_t *Msg)
 {
-    CFE_EVS_SendEvent(ROVER_APP_COMMANDNOP_INF_EID, CFE_EVS_EventType_INFORMATION, "rover app: NOOP command %s",
-                      ROVER_APP_VERSION);
+    ROVER_APP_EVENT(ROVER_APP_COMMANDNOP_INF_EID, CFE_EVS_EventType_INFORMATION, "rover app: NOOP command %s",
+                    ROVER_APP_VERSION);
 
     return CFE_SUCCESS;
 } /* End of RoverAppNoop */
@@ -405,56 +762,408 @@ int32 RoverAppNoop(const RoverAppNoopCmd_t *Msg)
 
 int32 RoverAppCmdTwist(const RoverAppTwistCmd_t *Msg)
 {
-    RoverAppData.LastTwist.twist.linear_x = Msg->twist.linear_x;
-    RoverAppData.LastTwist.twist.linear_y = Msg->twist.linear_y; 
-    RoverAppData.LastTwist.twist.linear_z = Msg->twist.linear_z;
-    RoverAppData.LastTwist.twist.angular_x = Msg->twist.angular_x;
-    RoverAppData.LastTwist.twist.angular_y = Msg->twist.angular_y;
-    RoverAppData.LastTwist.twist.angular_z = Msg->twist.angular_z;
+    RoverAppTwistPublish(&RoverAppData.TwistCell, &Msg->twist);
 
+    // A direct twist command overrides an uploaded trajectory or path
+    RoverAppTrajStop();
+    RoverAppPathStop();
 
-    CFE_EVS_SendEvent(ROVER_APP_COMMANDTWIST_INF_EID, CFE_EVS_EventType_INFORMATION, "rover app: twist command %s",
-                      ROVER_APP_VERSION);
+    ROVER_APP_EVENT(ROVER_APP_COMMANDTWIST_INF_EID, CFE_EVS_EventType_INFORMATION, "rover app: twist command %s",
+                    ROVER_APP_VERSION);
 
     return CFE_SUCCESS;
     
 }
 
-void HighRateControLoop(void) {
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTraceDumpCmd -- write the trace ring to a file                     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppTraceDumpCmd(const RoverAppTraceDumpCmd_t *Msg)
+{
+    char Filename[CFE_MISSION_MAX_PATH_LEN];
+
+    strncpy(Filename, Msg->Filename, sizeof(Filename) - 1);
+    Filename[sizeof(Filename) - 1] = 0;
+
+    return RoverAppTraceDump(Filename);
+
+} /* End of RoverAppTraceDumpCmd */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppResetDiagCmd -- clear the control loop timing histograms           */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppResetDiagCmd(const RoverAppResetDiagCmd_t *Msg)
+{
+    RoverAppDiagReset();
+
+    ROVER_APP_EVENT(ROVER_APP_DIAG_RESET_INF_EID, CFE_EVS_EventType_INFORMATION,
+                    "rover app: timing histograms reset");
+
+    return CFE_SUCCESS;
+
+} /* End of RoverAppResetDiagCmd */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppSendStatsCmd -- send the per message statistics packet             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppSendStatsCmd(const RoverAppSendStatsCmd_t *Msg)
+{
+    return RoverAppStatsReport();
+
+} /* End of RoverAppSendStatsCmd */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTrajLoadCmd -- stage trajectory knots                              */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppTrajLoadCmd(const RoverAppTrajLoadCmd_t *Msg)
+{
+    return RoverAppTrajLoad(Msg);
+
+} /* End of RoverAppTrajLoadCmd */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTrajStartCmd -- run the staged trajectory                          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppTrajStartCmd(const RoverAppTrajStartCmd_t *Msg)
+{
+    CFE_TIME_SysTime_t Start;
+    int32              Status;
+
+    Start.Seconds    = Msg->StartSeconds;
+    Start.Subseconds = Msg->StartSubseconds;
+
+    if (Start.Seconds == 0 && Start.Subseconds == 0)
+    {
+        Start = CFE_TIME_GetTime();
+    }
+
+    Status = RoverAppTrajStart(RoverAppTimeToStamp(Start));
+    if (Status == CFE_SUCCESS)
+    {
+        RoverAppPathStop();
+    }
+
+    return Status;
+
+} /* End of RoverAppTrajStartCmd */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTrajStopCmd -- abandon the trajectory and stop the rover           */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppTrajStopCmd(const RoverAppTrajStopCmd_t *Msg)
+{
+    RoverAppTwist_t Zero;
+
+    memset(&Zero, 0, sizeof(Zero));
+    RoverAppTwistPublish(&RoverAppData.TwistCell, &Zero);
+    RoverAppTrajStop();
+
+    ROVER_APP_EVENT(ROVER_APP_TRAJ_INF_EID, CFE_EVS_EventType_INFORMATION, "rover app: trajectory stopped");
+
+    return CFE_SUCCESS;
+
+} /* End of RoverAppTrajStopCmd */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppPathLoadCmd -- stage path waypoints                                */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppPathLoadCmd(const RoverAppPathLoadCmd_t *Msg)
+{
+    return RoverAppPathLoad(Msg);
+
+} /* End of RoverAppPathLoadCmd */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppPathStartCmd -- follow the staged path                             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppPathStartCmd(const RoverAppPathStartCmd_t *Msg)
+{
+    int32 Status;
+
+    Status = RoverAppPathStart(Msg->Speed, Msg->Lookahead);
+    if (Status == CFE_SUCCESS)
+    {
+        RoverAppTrajStop();
+    }
+
+    return Status;
+
+} /* End of RoverAppPathStartCmd */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppPathStopCmd -- abandon the path and stop the rover                 */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppPathStopCmd(const RoverAppPathStopCmd_t *Msg)
+{
+    RoverAppTwist_t Zero;
+
+    memset(&Zero, 0, sizeof(Zero));
+    RoverAppTwistPublish(&RoverAppData.TwistCell, &Zero);
+    RoverAppPathStop();
+
+    ROVER_APP_EVENT(ROVER_APP_PATH_INF_EID, CFE_EVS_EventType_INFORMATION, "rover app: path stopped");
+
+    return CFE_SUCCESS;
+
+} /* End of RoverAppPathStopCmd */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppSchedInsertCmd -- queue a time-tagged command                      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppSchedInsertCmd(const RoverAppSchedInsertCmd_t *Msg)
+{
+    return RoverAppSchedInsert(Msg);
+
+} /* End of RoverAppSchedInsertCmd */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppSchedListCmd -- send the scheduler packet                          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppSchedListCmd(const RoverAppSchedListCmd_t *Msg)
+{
+    return RoverAppSchedReport();
+
+} /* End of RoverAppSchedListCmd */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppSchedFlushCmd -- drop all time-tagged commands                     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppSchedFlushCmd(const RoverAppSchedFlushCmd_t *Msg)
+{
+    RoverAppSchedFlush();
+
+    return CFE_SUCCESS;
+
+} /* End of RoverAppSchedFlushCmd */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppSetOutputCmd -- change the output policy of a telemetry stream     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppSetOutputCmd(const RoverAppSetOutputCmd_t *Msg)
+{
+    return RoverAppOutputSet(Msg->Stream, &Msg->Policy);
+
+} /* End of RoverAppSetOutputCmd */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppSetEventLimitCmd -- change the rate limit of an event ID           */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppSetEventLimitCmd(const RoverAppSetEventLimitCmd_t *Msg)
+{
+    return RoverAppEvLimitSet(Msg->EventId, Msg->Rate, Msg->Burst);
+
+} /* End of RoverAppSetEventLimitCmd */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppRecordStartCmd -- record the messages dispatched to a file         */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppRecordStartCmd(const RoverAppRecordStartCmd_t *Msg)
+{
+    char Filename[CFE_MISSION_MAX_PATH_LEN];
+
+    strncpy(Filename, Msg->Filename, sizeof(Filename) - 1);
+    Filename[sizeof(Filename) - 1] = 0;
+
+    return RoverAppRecordStart(Filename);
+
+} /* End of RoverAppRecordStartCmd */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppRecordStopCmd -- finish the recording                              */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppRecordStopCmd(const RoverAppRecordStopCmd_t *Msg)
+{
+    return RoverAppRecordStop();
+
+} /* End of RoverAppRecordStopCmd */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppBlackBoxDumpCmd -- write the flight recorder to a file             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppBlackBoxDumpCmd(const RoverAppBlackBoxDumpCmd_t *Msg)
+{
+    char Filename[CFE_MISSION_MAX_PATH_LEN];
+
+    strncpy(Filename, Msg->Filename, sizeof(Filename) - 1);
+    Filename[sizeof(Filename) - 1] = 0;
+
+    return RoverAppBlackBoxDump(Filename);
+
+} /* End of RoverAppBlackBoxDumpCmd */
+
+#if ROVER_APP_FLEET_SIZE > 0
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppFleetTwistCmd -- new twist for the fleet vehicle of the MID        */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppFleetTwistCmd(const RoverAppTwistCmd_t *Msg)
+{
+    CFE_SB_MsgId_t MsgId = CFE_SB_INVALID_MSG_ID;
+
+    CFE_MSG_GetMsgId(&Msg->CmdHeader.Msg, &MsgId);
+    RoverAppFleetSetTwist(CFE_SB_MsgIdToValue(MsgId) - ROVER_APP_FLEET_CMD_MID_BASE, &Msg->twist);
+
+    return CFE_SUCCESS;
+
+} /* End of RoverAppFleetTwistCmd */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppProcessFleetOdom -- odometry of the fleet vehicle of the MID       */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppProcessFleetOdom(const RoverAppCmdRobotState_t *Msg)
+{
+    CFE_SB_MsgId_t MsgId = CFE_SB_INVALID_MSG_ID;
+
+    CFE_MSG_GetMsgId(&Msg->CmdHeader.Msg, &MsgId);
+    RoverAppFleetOdom(CFE_SB_MsgIdToValue(MsgId) - ROVER_APP_FLEET_ODOM_MID_BASE, &Msg->odom.pose);
+
+    return CFE_SUCCESS;
+
+} /* End of RoverAppProcessFleetOdom */
+#endif
+
+int32 HighRateControLoop(const CFE_MSG_Message_t *Msg) {
+
+    RoverAppStamp_t            Now = RoverAppTimeToStamp(CFE_TIME_GetTime());
+    RoverAppTlmRobotCommand_t *TwistTlm;
+    uint8                      Source = ROVER_APP_CDS_SOURCE_TWIST;
+#if ROVER_APP_DIAG_ENABLE || ROVER_APP_BLACKBOX_ENABLE
+    RoverAppStamp_t End;
+#endif
+
+#if ROVER_APP_DIAG_ENABLE
+    if (RoverAppData.LastTickStamp != 0)
+    {
+        RoverAppDiagAdd(ROVER_APP_DIAG_TICK_PERIOD, RoverAppData.LastTickStamp, Now);
+    }
+    RoverAppData.LastTickStamp = Now;
+#endif
+
+    ROVER_APP_TRACE(ROVER_APP_TRACE_LEVEL_DEBUG, ROVER_APP_TRACE_PT_HR_TICK, ROVER_APP_HR_CONTROL_MID, 0, 0, CFE_SUCCESS);
+
+    // Table updates the command task has made ready take effect here,
+    // between ticks
+    RoverAppParamsSwap();
+
+    // 0. Send the time-tagged commands that are due, they are handled
+    //    like any other command and take effect from the next tick
+    RoverAppSchedRelease(Now);
     
     // 1. Publish the twist to State in rosfsw (it is like sending a command to the robot)
     // (we should use another name, telemetry is not supposed to command anything)
 
-    // if (RoverAppData.square_counter%1000 == 0)    
+    // An uploaded path or trajectory takes the place of the commanded
+    // twist, the path steering from the state of the previous tick
+    if (RoverAppPathFollow(&lastOdomMsg.pose, &RoverAppData.TargetTwist))
+    {
+        Source = ROVER_APP_CDS_SOURCE_PATH;
+    }
+    else if (RoverAppTrajEval(Now, &RoverAppData.TargetTwist))
+    {
+        Source = ROVER_APP_CDS_SOURCE_TRAJ;
+    }
+    else if (!RoverAppTwistRead(&RoverAppData.TwistCell, &RoverAppData.TargetTwist))
+    {
+        __atomic_fetch_add(&RoverAppData.StaleReadCount, 1, __ATOMIC_RELAXED);
+    }
+
+    // Ramp to it within the acceleration and jerk limits
+    RoverAppShapeStep(&RoverAppData.TargetTwist, Now, &RoverAppData.LastTwist.twist);
+
+#if ROVER_APP_FLEET_SIZE > 0
+    // Same for every fleet vehicle, their twists go out in one packet
+    RoverAppFleetTick(Now);
+#endif
+
+    // Sent as often as its output policy asks
+    if (RoverAppOutputDue(ROVER_APP_OUTPUT_TWIST, &RoverAppData.LastTwist.twist, sizeof(RoverAppData.LastTwist.twist)))
     {
-    CFE_SB_TimeStampMsg(&RoverAppData.LastTwist.TlmHeader.Msg);
-    CFE_SB_TransmitMsg(&RoverAppData.LastTwist.TlmHeader.Msg, true);    
+        TwistTlm        = RoverAppTxBufGet(&RoverAppData.LastTwist.TlmHeader, sizeof(RoverAppData.LastTwist));
+        TwistTlm->twist = RoverAppData.LastTwist.twist;
+        RoverAppTxBufSend(TwistTlm, &RoverAppData.LastTwist.TlmHeader);
     }
 
  
     
-    // 2. Update the telemetry information        
-    RoverAppOdometry_t *st = &lastOdomMsg; //RoverAppGoal.StateTlm;
-
-    RoverAppData.HkTlm.Payload.state.pose.x = st->pose.x;
-    RoverAppData.HkTlm.Payload.state.pose.y = st->pose.y;
-    RoverAppData.HkTlm.Payload.state.pose.z = st->pose.z;
-    RoverAppData.HkTlm.Payload.state.pose.qx = st->pose.qx;
-    RoverAppData.HkTlm.Payload.state.pose.qy = st->pose.qy;
-    RoverAppData.HkTlm.Payload.state.pose.qz = st->pose.qz;
-    RoverAppData.HkTlm.Payload.state.pose.qw = st->pose.qw;
-
-    RoverAppData.HkTlm.Payload.state.twist.linear_x = st->twist.linear_x;
-    RoverAppData.HkTlm.Payload.state.twist.linear_y = st->twist.linear_y;
-    RoverAppData.HkTlm.Payload.state.twist.linear_z = st->twist.linear_z;
-    RoverAppData.HkTlm.Payload.state.twist.angular_x = st->twist.angular_x;
-    RoverAppData.HkTlm.Payload.state.twist.angular_y = st->twist.angular_y;
-    RoverAppData.HkTlm.Payload.state.twist.angular_z = st->twist.angular_z;                
+    // 2. Update the telemetry information with the state at this tick,
+    //    odometry may be older or arrive at a lower rate than the loop
+#if ROVER_APP_DEAD_RECKON_MODE == ROVER_APP_DEAD_RECKON_OFF
+    RoverAppOdomHistoryEval(&RoverAppData.OdomHistory, Now, &lastOdomMsg);
+#else
+    RoverAppDeadReckonStep(&RoverAppData.DeadReckon, &RoverAppData.OdomHistory,
+                           (ROVER_APP_DEAD_RECKON_MODE == ROVER_APP_DEAD_RECKON_COMMANDED) ? &RoverAppData.LastTwist.twist
+                                                                                           : NULL,
+                           Now, &lastOdomMsg);
+#endif
+
+    RoverAppOdomPublish(&RoverAppData.StateCell, &lastOdomMsg);
+
+#if ROVER_APP_BUNDLE_ENABLE
+    // and collected for the ground with the state of the ticks around it
+    RoverAppBundleAdd(Now, &lastOdomMsg);
+#endif
+
+#if ROVER_APP_DIAG_ENABLE || ROVER_APP_BLACKBOX_ENABLE
+    End = RoverAppTimeToStamp(CFE_TIME_GetTime());
+#endif
+#if ROVER_APP_DIAG_ENABLE
+    RoverAppDiagAdd(ROVER_APP_DIAG_TICK_EXEC, Now, End);
+#endif
+#if ROVER_APP_BLACKBOX_ENABLE
+    // The flight recorder keeps the tick with what it was computed from
+    RoverAppBlackBoxAdd(Now, End, &RoverAppData.OdomHistory, &lastOdomMsg, &RoverAppData.TargetTwist,
+                        &RoverAppData.LastTwist.twist);
+#endif
+
+#if ROVER_APP_CDS_ENABLE
+    // Kept for a warm restart, written to the CDS only when it changed
+    RoverAppCdsUpdate(Now, &lastOdomMsg, &RoverAppData.TargetTwist, &RoverAppData.LastTwist.twist, Source);
+#else
+    (void)Source;
+#endif
 
     // This data is sent when a Housekeeping request is received, 
     // (usually, at a low rate) so nothing sent here
     //memcpy(&st->joints, &RoverAppData.HkTlm.Payload.state, sizeof(RoverAppSSRMS_t) );
-    
+
+    return CFE_SUCCESS;
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
@@ -469,8 +1178,6 @@ bool RoverAppVerifyCmdLength(CFE_MSG_Message_t *MsgPtr, size_t ExpectedLength)
     CFE_SB_MsgId_t    MsgId        = CFE_SB_INVALID_MSG_ID;
     CFE_MSG_FcnCode_t FcnCode      = 0;
 
-    printf("RoverAppVerifyCmdLength() --\n");
-
     CFE_MSG_GetSize(MsgPtr, &ActualLength);
 
     /*
@@ -481,14 +1188,19 @@ bool RoverAppVerifyCmdLength(CFE_MSG_Message_t *MsgPtr, size_t ExpectedLength)
         CFE_MSG_GetMsgId(MsgPtr, &MsgId);
         CFE_MSG_GetFcnCode(MsgPtr, &FcnCode);
 
-        CFE_EVS_SendEvent(ROVER_APP_LEN_ERR_EID, CFE_EVS_EventType_ERROR,
-                          "Invalid Msg length: ID = 0x%X,  CC = %u, Len = %u, Expected = %u",
-                          (unsigned int)CFE_SB_MsgIdToValue(MsgId), (unsigned int)FcnCode, (unsigned int)ActualLength,
-                          (unsigned int)ExpectedLength);
+        ROVER_APP_EVENT(ROVER_APP_LEN_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Invalid Msg length: ID = 0x%X,  CC = %u, Len = %u, Expected = %u",
+                        (unsigned int)CFE_SB_MsgIdToValue(MsgId), (unsigned int)FcnCode, (unsigned int)ActualLength,
+                        (unsigned int)ExpectedLength);
+
+        ROVER_APP_TRACE(ROVER_APP_TRACE_LEVEL_ERROR, ROVER_APP_TRACE_PT_LEN_ERR, (uint16)CFE_SB_MsgIdToValue(MsgId),
+                        (uint8)FcnCode, (uint16)ActualLength, (int32)ExpectedLength);
 
         result = false;
 
-        RoverAppData.ErrCounter++;
+        /* Length errors come from both pipes, so from both tasks */
+        __atomic_fetch_add(&RoverAppData.ErrCounter, 1, __ATOMIC_RELAXED);
+        RoverAppBlackBoxTrigger(ROVER_APP_BLACKBOX_LEN_ERR);
     }
 
     return (result);
@@ -41,6 +41,9 @@
 #include "rover_app_perfids.h"
 #include "rover_app_msgids.h"
 #include "rover_app_msg.h"
+#include "rover_app_platform_cfg.h"
+#include "rover_app_seqlock.h"
+#include "rover_app_history.h"
 
 // #include "rover_app_msgids.h"
 
@@ -50,6 +53,30 @@
 ** Type Definitions
 *************************************************************************/
 
+/*
+** Newest message of a coalesced stream, held back while a batch is drained
+*/
+#define ROVER_APP_LATEST_ODOM  0
+#define ROVER_APP_LATEST_TWIST 1
+#define ROVER_APP_LATEST_COUNT 2
+
+#define ROVER_APP_SEQ_COUNT_MASK 0x3FFF /* CCSDS 14-bit sequence count */
+
+typedef struct
+{
+    bool   SeqValid;
+    uint16 LastSeq;
+    uint32 CoalescedCount; /* Superseded by a newer message in the same batch */
+    uint32 DroppedCount;   /* Sequence count gaps, lost before reaching the app */
+    uint32 Index;          /* Dispatch index of Msg */
+    union
+    {
+        CFE_SB_Buffer_t         Buf;
+        RoverAppCmdRobotState_t Odom;
+        RoverAppTwistCmd_t      Twist;
+    } Msg;
+} RoverAppLatest_t;
+
 /*
 ** Global Data
 */
@@ -57,18 +84,42 @@
 typedef struct
 {
     /*
-    ** Command interface counters...
+    ** Command interface counters, updated atomically: both tasks verify
+    ** message lengths, and the CDS copy is taken on the control task
     */
     uint8 CmdCounter;
     uint8 ErrCounter;
 
-    uint32 square_counter;
     uint32 hk_counter;
     /*
     ** Housekeeping telemetry packet...
     */
     RoverAppHkTlm_t HkTlm;
-    RoverAppTlmRobotCommand_t LastTwist;
+    RoverAppTlmRobotCommand_t LastTwist;   /* Shaped twist sent to the vehicle */
+    RoverAppTwist_t           TargetTwist; /* Commanded or trajectory twist it ramps to */
+    RoverAppCompactTlm_t      CompactTlm;  /* Quantized copy of the HK state */
+    float                     CompactScale[ROVER_APP_COMPACT_FIELDS];
+
+    /*
+    ** State handed between tasks (see rover_app_seqlock.h)
+    */
+    RoverAppTwistCell_t TwistCell; /* Commanded twist, written by RoverAppCmdTwist */
+    RoverAppOdomCell_t  StateCell; /* State for HK, written by HighRateControLoop */
+    uint32              StaleReadCount; /* Both tasks count, update atomically */
+
+    /*
+    ** Odometry samples for the control loop.  Odometry and HR wakeups
+    ** share a pipe, so one task owns the history and it needs no lock.
+    */
+    RoverAppOdomHistory_t OdomHistory;
+    RoverAppDeadReckon_t  DeadReckon;
+    RoverAppStamp_t       LastTickStamp; /* Start of the previous HR tick, for the period histogram */
+
+    /*
+    ** Pipe batching (see RoverAppDrainPipe), each slot is only used by the
+    ** task whose pipe carries that stream
+    */
+    RoverAppLatest_t Latest[ROVER_APP_LATEST_COUNT];
     
     /*
     ** Run Status variable used in the main processing loop
@@ -79,6 +130,8 @@ typedef struct
     ** Operational data (not reported in housekeeping)...
     */
     CFE_SB_PipeId_t CommandPipe;
+    CFE_SB_PipeId_t ControlPipe;     /* Same as CommandPipe without a control task */
+    CFE_ES_TaskId_t ControlTaskId;
 
     /*
     ** Initialization data (not reported in housekeeping)...
@@ -101,14 +154,42 @@ void  RoverAppMain(void);
 
 int32 RoverAppInit(void);
 
+void  RoverAppDrainPipe(CFE_SB_PipeId_t PipeId, CFE_SB_Buffer_t *SBBufPtr);
+bool  RoverAppCoalesce(const CFE_SB_Buffer_t *SBBufPtr, uint32 Index, uint32 *PendingMask);
+void  RoverAppFlushLatest(uint32 *PendingMask);
 void  RoverAppProcessCommandPacket(CFE_SB_Buffer_t *SBBufPtr);
-void  RoverAppProcessGroundCommand(CFE_SB_Buffer_t *SBBufPtr);
+void  RoverAppControlTask(void);
 
-int32 RoverAppReportHousekeeping(const CFE_MSG_CommandHeader_t *Msg);
-void RoverAppProcessFlightOdom(CFE_SB_Buffer_t *SBBufPtr);
+/*
+** Message handlers, see rover_app_schema.h
+*/
+int32 HighRateControLoop(const CFE_MSG_Message_t *Msg);
+int32 RoverAppReportHousekeeping(const CFE_MSG_Message_t *Msg);
+int32 RoverAppProcessFlightOdom(const RoverAppCmdRobotState_t *Msg);
 
 int32 RoverAppNoop(const RoverAppNoopCmd_t *Msg);
 int32 RoverAppCmdTwist(const RoverAppTwistCmd_t *Msg);
+int32 RoverAppTraceDumpCmd(const RoverAppTraceDumpCmd_t *Msg);
+int32 RoverAppResetDiagCmd(const RoverAppResetDiagCmd_t *Msg);
+int32 RoverAppSendStatsCmd(const RoverAppSendStatsCmd_t *Msg);
+int32 RoverAppTrajLoadCmd(const RoverAppTrajLoadCmd_t *Msg);
+int32 RoverAppTrajStartCmd(const RoverAppTrajStartCmd_t *Msg);
+int32 RoverAppTrajStopCmd(const RoverAppTrajStopCmd_t *Msg);
+int32 RoverAppPathLoadCmd(const RoverAppPathLoadCmd_t *Msg);
+int32 RoverAppPathStartCmd(const RoverAppPathStartCmd_t *Msg);
+int32 RoverAppPathStopCmd(const RoverAppPathStopCmd_t *Msg);
+int32 RoverAppSchedInsertCmd(const RoverAppSchedInsertCmd_t *Msg);
+int32 RoverAppSchedListCmd(const RoverAppSchedListCmd_t *Msg);
+int32 RoverAppSchedFlushCmd(const RoverAppSchedFlushCmd_t *Msg);
+int32 RoverAppSetOutputCmd(const RoverAppSetOutputCmd_t *Msg);
+int32 RoverAppSetEventLimitCmd(const RoverAppSetEventLimitCmd_t *Msg);
+int32 RoverAppRecordStartCmd(const RoverAppRecordStartCmd_t *Msg);
+int32 RoverAppRecordStopCmd(const RoverAppRecordStopCmd_t *Msg);
+int32 RoverAppBlackBoxDumpCmd(const RoverAppBlackBoxDumpCmd_t *Msg);
+#if ROVER_APP_FLEET_SIZE > 0
+int32 RoverAppFleetTwistCmd(const RoverAppTwistCmd_t *Msg);
+int32 RoverAppProcessFleetOdom(const RoverAppCmdRobotState_t *Msg);
+#endif
 
 bool RoverAppVerifyCmdLength(CFE_MSG_Message_t *MsgPtr, size_t ExpectedLength);
 
@@ -0,0 +1,293 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_blackbox.c
+**
+** Purpose:
+**   Flight recorder of the rover app control loop.
+**
+** Notes:
+**   The trigger reason doubles as the freeze flag: the control loop
+**   stops writing while it is set and the dump clears it.
+**
+*******************************************************************************/
+
+/*
+** Include Files:
+*/
+#include "rover_app_events.h"
+#include "rover_app_evlimit.h"
+#include "rover_app_blackbox.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define ROVER_APP_BLACKBOX_MASK (ROVER_APP_BLACKBOX_ENTRIES - 1)
+
+typedef struct
+{
+    RoverAppBlackBoxEntry_t Ring[ROVER_APP_BLACKBOX_ENTRIES];
+
+    uint32          Head;      /* Next tick index, control loop only */
+    RoverAppStamp_t LastStamp; /* Start of the previous tick */
+    bool            Stale;     /* Odometry stale at the last tick, so the trigger fires once per outage */
+
+    uint32 Reason; /* ROVER_APP_BLACKBOX_<trigger>, set while frozen */
+    uint32 TriggerSeconds;
+    uint32 TriggerSubseconds;
+    uint32 DumpCount;
+
+    uint32          AutoCount; /* Triggered dumps, numbers their files */
+    RoverAppStamp_t HoldUntil; /* No automatic trigger before, set by the command task */
+} RoverAppBlackBoxData_t;
+
+static RoverAppBlackBoxData_t RoverAppBlackBoxData;
+
+/*
+** Whole microseconds in a stamp difference, saturating below
+** ROVER_APP_BLACKBOX_NO_ODOM
+*/
+static uint32 RoverAppBlackBoxUs(RoverAppStamp_t Delta)
+{
+    uint64 Us = RoverAppStampToNs(Delta) / 1000;
+
+    return (Us < ROVER_APP_BLACKBOX_NO_ODOM) ? (uint32)Us : (ROVER_APP_BLACKBOX_NO_ODOM - 1);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppBlackBoxInit() -- empty the ring                                   */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppBlackBoxInit(void)
+{
+    memset(&RoverAppBlackBoxData, 0, sizeof(RoverAppBlackBoxData));
+
+} /* End of RoverAppBlackBoxInit() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppBlackBoxAdd() -- record one HR tick, control loop only            */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppBlackBoxAdd(RoverAppStamp_t Now, RoverAppStamp_t End, const RoverAppOdomHistory_t *Hist,
+                         const RoverAppOdometry_t *State, const RoverAppTwist_t *Target, const RoverAppTwist_t *Twist)
+{
+    RoverAppBlackBoxData_t  *Data = &RoverAppBlackBoxData;
+    RoverAppBlackBoxEntry_t *Entry;
+    RoverAppStamp_t          Newest;
+    uint32                   OdomAgeUs = ROVER_APP_BLACKBOX_NO_ODOM;
+
+    if (Hist->Count != 0)
+    {
+        Newest    = Hist->Stamp[(Hist->Head - 1) & (ROVER_APP_ODOM_HISTORY_SIZE - 1)];
+        OdomAgeUs = (Now > Newest) ? RoverAppBlackBoxUs(Now - Newest) : 0;
+    }
+
+    if (__atomic_load_n(&Data->Reason, __ATOMIC_ACQUIRE) == ROVER_APP_BLACKBOX_NONE)
+    {
+        Entry             = &Data->Ring[Data->Head & ROVER_APP_BLACKBOX_MASK];
+        Entry->Seq        = Data->Head + 1;
+        Entry->Seconds    = (uint32)(Now >> 32);
+        Entry->Subseconds = (uint32)Now;
+        Entry->PeriodUs   = (Data->LastStamp != 0 && Now > Data->LastStamp) ? RoverAppBlackBoxUs(Now - Data->LastStamp) : 0;
+        Entry->ExecUs     = (End > Now) ? RoverAppBlackBoxUs(End - Now) : 0;
+        Entry->OdomAgeUs  = OdomAgeUs;
+        Entry->State      = *State;
+        Entry->Target     = *Target;
+        Entry->Twist      = *Twist;
+        Entry->Spare      = 0;
+
+        __atomic_store_n(&Data->Head, Data->Head + 1, __ATOMIC_RELEASE);
+    }
+    Data->LastStamp = Now;
+
+    /* With this tick in the ring */
+    if (OdomAgeUs != ROVER_APP_BLACKBOX_NO_ODOM && OdomAgeUs > (uint32)ROVER_APP_BLACKBOX_STALE_MS * 1000)
+    {
+        if (!Data->Stale)
+        {
+            RoverAppBlackBoxTrigger(ROVER_APP_BLACKBOX_ODOM_STALE);
+        }
+        Data->Stale = true;
+    }
+    else
+    {
+        Data->Stale = false;
+    }
+
+} /* End of RoverAppBlackBoxAdd() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppBlackBoxTrigger() -- freeze the ring, from any task; the first    */
+/*                              trigger until the dump wins                   */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppBlackBoxTrigger(uint32 Reason)
+{
+    RoverAppBlackBoxData_t *Data = &RoverAppBlackBoxData;
+    CFE_TIME_SysTime_t      Time;
+    uint32                  None = ROVER_APP_BLACKBOX_NONE;
+
+    /* Without the per-tick entries only the dump command does anything */
+    if ((Reason != ROVER_APP_BLACKBOX_COMMAND &&
+         (!ROVER_APP_BLACKBOX_ENABLE || (Reason & ROVER_APP_BLACKBOX_TRIGGERS) == 0)) ||
+        __atomic_load_n(&Data->Reason, __ATOMIC_RELAXED) != ROVER_APP_BLACKBOX_NONE)
+    {
+        return;
+    }
+
+    /* Keep a burst of anomalies from rewriting the dumps one after another */
+    Time = CFE_TIME_GetTime();
+    if (Reason != ROVER_APP_BLACKBOX_COMMAND && Reason != ROVER_APP_BLACKBOX_APP_ERROR &&
+        RoverAppTimeToStamp(Time) < __atomic_load_n(&Data->HoldUntil, __ATOMIC_RELAXED))
+    {
+        return;
+    }
+
+    /* Two triggers at once may leave the time of the other one */
+    __atomic_store_n(&Data->TriggerSeconds, Time.Seconds, __ATOMIC_RELAXED);
+    __atomic_store_n(&Data->TriggerSubseconds, Time.Subseconds, __ATOMIC_RELAXED);
+    __atomic_compare_exchange_n(&Data->Reason, &None, Reason, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+
+} /* End of RoverAppBlackBoxTrigger() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppBlackBoxDump() -- freeze the ring if it is not already, write it  */
+/*                           to a file and resume recording; command task    */
+/*                           only                                             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppBlackBoxDump(const char *Filename)
+{
+    RoverAppBlackBoxData_t   *Data = &RoverAppBlackBoxData;
+    RoverAppBlackBoxFileHdr_t Hdr;
+    osal_id_t                 Fd;
+    uint32                    Head;
+    uint32                    Start;
+    uint32                    First;
+    size_t                    Bytes;
+    int32                     status;
+
+    if (Filename == NULL || Filename[0] == '\0')
+    {
+        Filename = ROVER_APP_BLACKBOX_FILE;
+    }
+
+    RoverAppBlackBoxTrigger(ROVER_APP_BLACKBOX_COMMAND);
+
+    memset(&Hdr, 0, sizeof(Hdr));
+    Hdr.Magic             = ROVER_APP_BLACKBOX_FILE_MAGIC;
+    Hdr.Version           = ROVER_APP_BLACKBOX_FILE_VERSION;
+    Hdr.EntrySize         = sizeof(RoverAppBlackBoxEntry_t);
+    Hdr.Reason            = __atomic_load_n(&Data->Reason, __ATOMIC_ACQUIRE);
+    Hdr.TriggerSeconds    = __atomic_load_n(&Data->TriggerSeconds, __ATOMIC_RELAXED);
+    Hdr.TriggerSubseconds = __atomic_load_n(&Data->TriggerSubseconds, __ATOMIC_RELAXED);
+
+    /* The oldest slot may still take the entry of a tick in progress */
+    Head           = __atomic_load_n(&Data->Head, __ATOMIC_ACQUIRE);
+    Hdr.EntryCount = (Head < ROVER_APP_BLACKBOX_ENTRIES - 1) ? Head : (ROVER_APP_BLACKBOX_ENTRIES - 1);
+
+    status = OS_OpenCreate(&Fd, Filename, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_WRITE_ONLY);
+    if (status == OS_SUCCESS)
+    {
+        Start = (Head - Hdr.EntryCount) & ROVER_APP_BLACKBOX_MASK;
+        First = ROVER_APP_BLACKBOX_ENTRIES - Start;
+        if (First > Hdr.EntryCount)
+        {
+            First = Hdr.EntryCount;
+        }
+
+        Bytes = (Hdr.EntryCount - First) * sizeof(RoverAppBlackBoxEntry_t);
+        if (OS_write(Fd, &Hdr, sizeof(Hdr)) != (int32)sizeof(Hdr) ||
+            OS_write(Fd, &Data->Ring[Start], First * sizeof(RoverAppBlackBoxEntry_t)) !=
+                (int32)(First * sizeof(RoverAppBlackBoxEntry_t)) ||
+            (Bytes != 0 && OS_write(Fd, &Data->Ring[0], Bytes) != (int32)Bytes))
+        {
+            status = OS_ERROR;
+        }
+        OS_close(Fd);
+    }
+
+    __atomic_store_n(&Data->Reason, ROVER_APP_BLACKBOX_NONE, __ATOMIC_RELEASE);
+
+    if (status != OS_SUCCESS)
+    {
+        ROVER_APP_EVENT(ROVER_APP_BLACKBOX_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: error writing black box to %s, RC = %d", Filename, (int)status);
+        return status;
+    }
+
+    Data->DumpCount++;
+    ROVER_APP_EVENT(ROVER_APP_BLACKBOX_INF_EID, CFE_EVS_EventType_INFORMATION,
+                    "rover app: black box trigger 0x%02X, %u ticks dumped to %s", (unsigned int)Hdr.Reason,
+                    (unsigned int)Hdr.EntryCount, Filename);
+
+    return CFE_SUCCESS;
+
+} /* End of RoverAppBlackBoxDump() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppBlackBoxService() -- dump the ring if a trigger froze it, to the  */
+/*                              next of the triggered dump files; command    */
+/*                              task only                                     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppBlackBoxService(void)
+{
+    RoverAppBlackBoxData_t *Data = &RoverAppBlackBoxData;
+    char                    Filename[CFE_MISSION_MAX_PATH_LEN];
+
+    if (__atomic_load_n(&Data->Reason, __ATOMIC_ACQUIRE) == ROVER_APP_BLACKBOX_NONE)
+    {
+        return;
+    }
+
+    snprintf(Filename, sizeof(Filename), ROVER_APP_BLACKBOX_AUTO_FILE,
+             (unsigned int)(Data->AutoCount % ROVER_APP_BLACKBOX_AUTO_FILES));
+    Data->AutoCount++;
+
+    RoverAppBlackBoxDump(Filename);
+
+    /* Failed or not, the next automatic dump waits */
+    __atomic_store_n(&Data->HoldUntil,
+                     RoverAppTimeToStamp(CFE_TIME_GetTime()) +
+                         (((RoverAppStamp_t)ROVER_APP_BLACKBOX_HOLDOFF_MS << 32) / 1000),
+                     __ATOMIC_RELAXED);
+
+} /* End of RoverAppBlackBoxService() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppBlackBoxDumps() -- dumps written since init                        */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+uint32 RoverAppBlackBoxDumps(void)
+{
+    return RoverAppBlackBoxData.DumpCount;
+
+} /* End of RoverAppBlackBoxDumps() */
+
+/************************/
+/*  End of File Comment */
+/************************/
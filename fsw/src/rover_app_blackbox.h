@@ -0,0 +1,113 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_blackbox.h
+**
+** Purpose:
+**   Flight recorder.  Every HR tick leaves one fixed-size entry in a ring
+**   holding the last ROVER_APP_BLACKBOX_ENTRIES ticks: the state the loop
+**   published, the twist it aimed for and the one it sent, and the tick
+**   timing.  A trigger freezes the ring and it is dumped to a file.
+**
+** Notes:
+**   Only the control loop writes entries.  Triggers latch from any task:
+**   the dump command, odometry older than ROVER_APP_BLACKBOX_STALE_MS,
+**   message length errors and the app exiting on an error, as selected
+**   by ROVER_APP_BLACKBOX_TRIGGERS.  The dump runs on the command task,
+**   at once for the command and on the next HK request or at exit
+**   otherwise, and recording resumes after it.  Triggered dumps rotate
+**   through ROVER_APP_BLACKBOX_AUTO_FILES files, and for
+**   ROVER_APP_BLACKBOX_HOLDOFF_MS after one only an app error or the
+**   command freezes the ring again.  A tick already past its check of
+**   the trigger when it fires still writes its entry, over the oldest
+**   one, so dumps leave the oldest entry out.
+**
+*******************************************************************************/
+#ifndef _rover_app_blackbox_h_
+#define _rover_app_blackbox_h_
+
+#include "cfe.h"
+
+#include "rover_app_history.h"
+#include "rover_app_msg.h"
+#include "rover_app_platform_cfg.h"
+
+#define ROVER_APP_BLACKBOX_FILE_MAGIC   0x52564242 /* "RVBB" */
+#define ROVER_APP_BLACKBOX_FILE_VERSION 1
+
+#if (ROVER_APP_BLACKBOX_ENTRIES & (ROVER_APP_BLACKBOX_ENTRIES - 1)) != 0
+#error ROVER_APP_BLACKBOX_ENTRIES must be a power of two
+#endif
+
+/*
+** Triggers, also the bits of ROVER_APP_BLACKBOX_TRIGGERS
+*/
+#define ROVER_APP_BLACKBOX_NONE       0x00
+#define ROVER_APP_BLACKBOX_COMMAND    0x01
+#define ROVER_APP_BLACKBOX_ODOM_STALE 0x02
+#define ROVER_APP_BLACKBOX_LEN_ERR    0x04
+#define ROVER_APP_BLACKBOX_APP_ERROR  0x08 /* Pipe errors, or exiting with CFE_ES_RunStatus_APP_ERROR */
+
+#define ROVER_APP_BLACKBOX_NO_ODOM 0xFFFFFFFF /* OdomAgeUs before the first odometry sample */
+
+/*
+** One HR tick, as stored in the ring and in dump files
+*/
+typedef struct
+{
+    uint32             Seq;        /* Tick index + 1, gaps are ticks not recorded */
+    uint32             Seconds;    /* Tick start */
+    uint32             Subseconds;
+    uint32             PeriodUs;   /* Since the previous tick start */
+    uint32             ExecUs;     /* Tick start to the state being published */
+    uint32             OdomAgeUs;  /* Tick start minus the newest odometry sample, saturating */
+    RoverAppOdometry_t State;      /* Published this tick */
+    RoverAppTwist_t    Target;     /* Commanded, trajectory or path twist */
+    RoverAppTwist_t    Twist;      /* Shaped twist sent */
+    uint32             Spare;
+} RoverAppBlackBoxEntry_t;
+
+typedef struct
+{
+    uint32 Magic;
+    uint16 Version;
+    uint16 EntrySize;
+    uint32 Reason;            /* ROVER_APP_BLACKBOX_<trigger> that froze the ring */
+    uint32 TriggerSeconds;
+    uint32 TriggerSubseconds;
+    uint32 EntryCount;        /* Oldest first */
+} RoverAppBlackBoxFileHdr_t;
+
+/*
+** Exported functions
+*/
+void   RoverAppBlackBoxInit(void);
+void   RoverAppBlackBoxAdd(RoverAppStamp_t Now, RoverAppStamp_t End, const RoverAppOdomHistory_t *Hist,
+                           const RoverAppOdometry_t *State, const RoverAppTwist_t *Target, const RoverAppTwist_t *Twist);
+void   RoverAppBlackBoxTrigger(uint32 Reason);
+int32  RoverAppBlackBoxDump(const char *Filename);
+void   RoverAppBlackBoxService(void);
+uint32 RoverAppBlackBoxDumps(void);
+
+#endif /* _rover_app_blackbox_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -0,0 +1,172 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_bundle.c
+**
+** Purpose:
+**   HR state bundles for the rover app.
+**
+** Notes:
+**   The packet is built in place, one sample per tick, in an SB buffer
+**   held from its first sample (see rover_app_txbuf.h), and sent with its
+**   size cut to the samples it holds.
+**
+*******************************************************************************/
+
+/*
+** Include Files:
+*/
+#include "rover_app_bundle.h"
+#include "rover_app_msgids.h"
+#include "rover_app_txbuf.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* Latest sample time a sample offset holds, well inside its 2^32 us */
+#define ROVER_APP_BUNDLE_MAX_OFFSET ((RoverAppStamp_t)4000 << 32)
+
+typedef struct
+{
+    uint32          Samples; /* Per bundle, 1 to ROVER_APP_BUNDLE_MAX_SAMPLES */
+    RoverAppStamp_t Timeout; /* 0 for none */
+
+    RoverAppStamp_t           First;  /* Tick time of Sample[0] */
+    RoverAppStateBundleTlm_t *Bundle; /* Being filled, NULL when empty */
+    RoverAppStateBundleTlm_t  Tlm;    /* Header, and the bundle when SB has no buffer */
+} RoverAppBundleData_t;
+
+static RoverAppBundleData_t RoverAppBundleData;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppBundleInit() -- empty bundle with the table's size and timeout     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppBundleInit(const RoverAppParams_t *Params)
+{
+    memset(&RoverAppBundleData, 0, sizeof(RoverAppBundleData));
+    CFE_MSG_Init(&RoverAppBundleData.Tlm.TlmHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_STATE_BUNDLE_TLM_MID),
+                 sizeof(RoverAppBundleData.Tlm));
+    RoverAppBundleConfig(Params);
+
+} /* End of RoverAppBundleInit() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppBundleConfig() -- take the size and timeout, control task only     */
+/*                                                                            */
+/*   Samples already collected go out first, in a bundle of the old size.    */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppBundleConfig(const RoverAppParams_t *Params)
+{
+    RoverAppBundleFlush();
+
+    RoverAppBundleData.Samples = Params->BundleSamples;
+    RoverAppBundleData.Timeout = Params->BundleTimeout;
+
+} /* End of RoverAppBundleConfig() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppBundleAdd() -- add the state of a tick, control task only          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppBundleAdd(RoverAppStamp_t Now, const RoverAppOdometry_t *State)
+{
+    RoverAppBundleData_t  *Data = &RoverAppBundleData;
+    RoverAppStateSample_t *Sample;
+
+    /* A tick the offsets cannot hold, after a time jump, starts a bundle */
+    if (Data->Bundle != NULL && (Now < Data->First || (Now - Data->First) >= ROVER_APP_BUNDLE_MAX_OFFSET))
+    {
+        RoverAppBundleFlush();
+    }
+
+    if (Data->Bundle == NULL)
+    {
+        Data->Bundle                     = RoverAppTxBufGet(&Data->Tlm.TlmHeader, sizeof(Data->Tlm));
+        Data->First                      = Now;
+        Data->Bundle->Payload.Seconds    = (uint32)(Now >> 32);
+        Data->Bundle->Payload.Subseconds = (uint32)Now;
+        Data->Bundle->Payload.Count      = 0;
+        Data->Bundle->Payload.Spare      = 0;
+    }
+
+    Sample           = &Data->Bundle->Payload.Sample[Data->Bundle->Payload.Count++];
+    Sample->OffsetUs = (uint32)(((Now - Data->First) * 1000000) >> 32);
+    Sample->State    = *State;
+
+    if (Data->Bundle->Payload.Count >= Data->Samples)
+    {
+        RoverAppBundleFlush();
+    }
+    else
+    {
+        RoverAppBundlePoll(Now);
+    }
+
+} /* End of RoverAppBundleAdd() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppBundlePoll() -- send the bundle if its first sample timed out,     */
+/*                         control task only                                  */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppBundlePoll(RoverAppStamp_t Now)
+{
+    RoverAppBundleData_t *Data = &RoverAppBundleData;
+
+    if (Data->Bundle != NULL && Data->Timeout != 0 && Now >= Data->First && (Now - Data->First) >= Data->Timeout)
+    {
+        RoverAppBundleFlush();
+    }
+
+} /* End of RoverAppBundlePoll() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppBundleFlush() -- send the samples collected so far, control task   */
+/*                          only                                              */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppBundleFlush(void)
+{
+    RoverAppBundleData_t *Data = &RoverAppBundleData;
+
+    if (Data->Bundle == NULL)
+    {
+        return;
+    }
+
+    CFE_MSG_SetSize(&Data->Bundle->TlmHeader.Msg,
+                    offsetof(RoverAppStateBundleTlm_t, Payload.Sample) +
+                        (Data->Bundle->Payload.Count * sizeof(RoverAppStateSample_t)));
+    RoverAppTxBufSend(Data->Bundle, &Data->Tlm.TlmHeader);
+
+    Data->Bundle = NULL;
+
+} /* End of RoverAppBundleFlush() */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -0,0 +1,58 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_bundle.h
+**
+** Purpose:
+**   HR state bundles: the state of every HR tick, collected into
+**   ROVER_APP_STATE_BUNDLE_TLM_MID packets of several samples each so the
+**   ground gets the full-rate history without a packet per tick.
+**
+** Notes:
+**   Everything runs on the task that services the control pipe, which owns
+**   the packet.  A bundle goes out when it holds the table's BundleSamples,
+**   or once its first sample is BundleTimeoutMs old; the timeout is also
+**   checked on odometry, so the last samples still go out when the HR
+**   ticks stop.
+**
+*******************************************************************************/
+#ifndef _rover_app_bundle_h_
+#define _rover_app_bundle_h_
+
+#include "cfe.h"
+
+#include "rover_app_history.h"
+#include "rover_app_msg.h"
+#include "rover_app_params.h"
+
+/*
+** Exported functions
+*/
+void RoverAppBundleInit(const RoverAppParams_t *Params);
+void RoverAppBundleConfig(const RoverAppParams_t *Params);
+void RoverAppBundleAdd(RoverAppStamp_t Now, const RoverAppOdometry_t *State);
+void RoverAppBundlePoll(RoverAppStamp_t Now);
+void RoverAppBundleFlush(void);
+
+#endif /* _rover_app_bundle_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
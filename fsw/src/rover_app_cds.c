@@ -0,0 +1,268 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_cds.c
+**
+** Purpose:
+**   Critical Data Store block of the rover app, for warm restarts.
+**
+** Notes:
+**   RoverAppCdsInit() runs before the control task starts.  After that,
+**   RoverAppCdsUpdate() runs on the control task only, and the write count
+**   is read for HK with a relaxed load.
+**
+*******************************************************************************/
+
+/*
+** Include Files:
+*/
+#include "rover_app_events.h"
+#include "rover_app.h"
+#include "rover_app_evlimit.h"
+#include "rover_app_cds.h"
+
+#include <math.h>
+#include <string.h>
+
+typedef struct
+{
+    CFE_ES_CDSHandle_t Handle;
+    bool               Registered;
+    bool               Dirty;    /* Block differs from the copy in the CDS */
+    RoverAppStamp_t    NextSave; /* Earliest HR tick of the next write */
+    RoverAppCdsBlock_t Block;    /* Last offered by the control loop */
+
+    uint32 SaveCount;
+    uint32 ErrorCount;
+} RoverAppCdsData_t;
+
+static RoverAppCdsData_t RoverAppCdsData;
+
+extern RoverAppData_t RoverAppData;
+
+/*
+** Every float of a struct of floats is finite
+*/
+static bool RoverAppCdsFinite(const void *Values, size_t Size)
+{
+    float  Value;
+    size_t i;
+
+    for (i = 0; i < Size; i += sizeof(float))
+    {
+        memcpy(&Value, (const uint8 *)Values + i, sizeof(Value));
+        if (!isfinite(Value))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+** Copies Src over Dst if they differ, true if they did
+*/
+static bool RoverAppCdsMerge(void *Dst, const void *Src, size_t Size)
+{
+    if (memcmp(Dst, Src, Size) == 0)
+    {
+        return false;
+    }
+
+    memcpy(Dst, Src, Size);
+
+    return true;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppCdsInit() -- register the block and restore it if it survived      */
+/*                                                                            */
+/*   Returns the ROVER_APP_CDS_RESTORE_<x> parts of Block fit to use, 0       */
+/*   when there is nothing to restore.  The app runs without the CDS if it    */
+/*   cannot register the block.                                               */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+uint32 RoverAppCdsInit(RoverAppCdsBlock_t *Block)
+{
+    RoverAppCdsData_t    *Data    = &RoverAppCdsData;
+    const RoverAppPose_t *Pose    = &Block->State.pose;
+    RoverAppStamp_t       Now     = RoverAppTimeToStamp(CFE_TIME_GetTime());
+    RoverAppStamp_t       MaxAge  = ((RoverAppStamp_t)ROVER_APP_CDS_TWIST_MAX_AGE_MS << 32) / 1000;
+    uint32                Restore = 0;
+    float                 Norm;
+    int32                 Status;
+
+    memset(Data, 0, sizeof(*Data));
+    memset(Block, 0, sizeof(*Block));
+
+    Status = CFE_ES_RegisterCDS(&Data->Handle, sizeof(Data->Block), ROVER_APP_CDS_NAME);
+    if (Status == CFE_ES_CDS_ALREADY_EXISTS)
+    {
+        Status = CFE_ES_RestoreFromCDS(Block, Data->Handle);
+        if (Status != CFE_SUCCESS)
+        {
+            ROVER_APP_EVENT(ROVER_APP_CDS_ERR_EID, CFE_EVS_EventType_ERROR,
+                            "rover app: CDS block not restored, RC = 0x%08lX", (unsigned long)Status);
+        }
+        else if (Block->Version != ROVER_APP_CDS_VERSION || Block->Source > ROVER_APP_CDS_SOURCE_PATH ||
+                 !RoverAppCdsFinite(&Block->State, sizeof(Block->State)) ||
+                 !RoverAppCdsFinite(&Block->Target, sizeof(Block->Target)) ||
+                 !RoverAppCdsFinite(&Block->Twist, sizeof(Block->Twist)))
+        {
+            ROVER_APP_EVENT(ROVER_APP_CDS_ERR_EID, CFE_EVS_EventType_ERROR,
+                            "rover app: CDS block version %u not usable, starting cold", (unsigned int)Block->Version);
+        }
+        else
+        {
+            Restore = ROVER_APP_CDS_RESTORE_COUNTERS;
+
+            /* The startup state has a zero quaternion */
+            Norm = (Pose->qx * Pose->qx) + (Pose->qy * Pose->qy) + (Pose->qz * Pose->qz) + (Pose->qw * Pose->qw);
+            if (Norm > 0.9f && Norm < 1.1f)
+            {
+                Restore |= ROVER_APP_CDS_RESTORE_POSE;
+            }
+
+            if (Now >= Block->Stamp && Now - Block->Stamp <= MaxAge)
+            {
+                Restore |= ROVER_APP_CDS_RESTORE_TWIST;
+                if (Block->Source == ROVER_APP_CDS_SOURCE_TWIST)
+                {
+                    Restore |= ROVER_APP_CDS_RESTORE_COMMAND;
+                }
+            }
+
+            ROVER_APP_EVENT(ROVER_APP_CDS_INF_EID, CFE_EVS_EventType_INFORMATION,
+                            "rover app: warm restart from CDS write %u, %.3f s old: pose %s, twist %s, %s",
+                            (unsigned int)Block->SaveCount,
+                            (Now >= Block->Stamp) ? (double)RoverAppStampToSeconds((int64)(Now - Block->Stamp)) : 0.0,
+                            (Restore & ROVER_APP_CDS_RESTORE_POSE) ? "restored" : "none",
+                            (Restore & ROVER_APP_CDS_RESTORE_TWIST) ? "restored" : "too old",
+                            (Restore & ROVER_APP_CDS_RESTORE_COMMAND)     ? "command restored"
+                            : (Block->Source == ROVER_APP_CDS_SOURCE_TRAJ) ? "trajectory to upload again"
+                            : (Block->Source == ROVER_APP_CDS_SOURCE_PATH) ? "path to upload again"
+                                                                           : "no command");
+        }
+    }
+    else if (Status != CFE_SUCCESS)
+    {
+        ROVER_APP_EVENT(ROVER_APP_CDS_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: no CDS block, no warm restart, RC = 0x%08lX", (unsigned long)Status);
+        return 0;
+    }
+
+    Data->Registered = true;
+
+    /* Start from what was restored, the first change writes the block */
+    if (Restore != 0)
+    {
+        Data->Block = *Block;
+    }
+    else
+    {
+        memset(Block, 0, sizeof(*Block));
+    }
+    Data->Block.Version = ROVER_APP_CDS_VERSION;
+
+    return Restore;
+
+} /* End of RoverAppCdsInit() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppCdsUpdate() -- offer the state of an HR tick, control loop only    */
+/*                                                                            */
+/*   Writes the block when it changed and the last write is at least          */
+/*   ROVER_APP_CDS_PERIOD_MS old.                                             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppCdsUpdate(RoverAppStamp_t Now, const RoverAppOdometry_t *State, const RoverAppTwist_t *Target,
+                       const RoverAppTwist_t *Twist, uint8 Source)
+{
+    RoverAppCdsData_t  *Data  = &RoverAppCdsData;
+    RoverAppCdsBlock_t *Block = &Data->Block;
+    uint8               CmdCounter;
+    uint8               ErrCounter;
+    int32               Status;
+
+    if (!Data->Registered)
+    {
+        return;
+    }
+
+    CmdCounter = __atomic_load_n(&RoverAppData.CmdCounter, __ATOMIC_RELAXED);
+    ErrCounter = __atomic_load_n(&RoverAppData.ErrCounter, __ATOMIC_RELAXED);
+
+    Data->Dirty |= RoverAppCdsMerge(&Block->State, State, sizeof(Block->State));
+    Data->Dirty |= RoverAppCdsMerge(&Block->Target, Target, sizeof(Block->Target));
+    Data->Dirty |= RoverAppCdsMerge(&Block->Twist, Twist, sizeof(Block->Twist));
+    if (Block->CmdCounter != CmdCounter || Block->ErrCounter != ErrCounter || Block->Source != Source)
+    {
+        Block->CmdCounter = CmdCounter;
+        Block->ErrCounter = ErrCounter;
+        Block->Source     = Source;
+        Data->Dirty       = true;
+    }
+
+    if (!Data->Dirty || Now < Data->NextSave)
+    {
+        return;
+    }
+
+    /* The block carries its own number; it only counts if the write lands */
+    Block->Stamp = Now;
+    Block->SaveCount++;
+
+    Status = CFE_ES_CopyToCDS(Data->Handle, Block);
+    if (Status != CFE_SUCCESS)
+    {
+        Block->SaveCount--;
+        Data->ErrorCount++;
+        ROVER_APP_EVENT(ROVER_APP_CDS_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: CDS write failed, RC = 0x%08lX, %u failures", (unsigned long)Status,
+                        (unsigned int)Data->ErrorCount);
+    }
+    else
+    {
+        __atomic_store_n(&Data->SaveCount, Data->SaveCount + 1, __ATOMIC_RELAXED);
+    }
+
+    /* A failed write is retried no sooner than a successful one */
+    Data->Dirty    = (Status != CFE_SUCCESS);
+    Data->NextSave = Now + (((RoverAppStamp_t)ROVER_APP_CDS_PERIOD_MS << 32) / 1000);
+
+} /* End of RoverAppCdsUpdate() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppCdsSaves() -- CDS writes since startup                             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+uint32 RoverAppCdsSaves(void)
+{
+    return __atomic_load_n(&RoverAppCdsData.SaveCount, __ATOMIC_RELAXED);
+
+} /* End of RoverAppCdsSaves() */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -0,0 +1,96 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_cds.h
+**
+** Purpose:
+**   Warm restart.  The state the rover needs to carry on after an app
+**   restart or a processor reset (pose estimate, the twists being sent
+**   and aimed for, what drove them, and the command counters) is kept in
+**   a Critical Data Store block and restored at startup.
+**
+** Notes:
+**   The control loop offers the block its state every HR tick.  It is
+**   compared with the copy last written and the CDS is only written when
+**   something changed, at most every ROVER_APP_CDS_PERIOD_MS, so a rover
+**   at rest writes nothing and a moving one writes the block at that
+**   rate.  The command counters belong to the command task and are read
+**   with relaxed loads.  cFE checks the block's CRC on restore; the app
+**   also checks its version and values.  The pose is restored as the
+**   dead-reckoning anchor until fresh odometry arrives.  The twists are
+**   only restored from a block at most ROVER_APP_CDS_TWIST_MAX_AGE_MS
+**   old: shaping ramps on from the twist sent, to the commanded twist if
+**   the twist command drove the vehicle.  A trajectory or path has to be
+**   uploaded again, and the vehicle ramps down until it is.
+**
+*******************************************************************************/
+#ifndef _rover_app_cds_h_
+#define _rover_app_cds_h_
+
+#include "cfe.h"
+
+#include "rover_app_history.h"
+#include "rover_app_msg.h"
+#include "rover_app_platform_cfg.h"
+
+#define ROVER_APP_CDS_VERSION 1
+
+/*
+** What set the target twist
+*/
+#define ROVER_APP_CDS_SOURCE_TWIST 0
+#define ROVER_APP_CDS_SOURCE_TRAJ  1
+#define ROVER_APP_CDS_SOURCE_PATH  2
+
+/*
+** Parts of a restored block fit to use, see RoverAppCdsInit()
+*/
+#define ROVER_APP_CDS_RESTORE_COUNTERS 0x01
+#define ROVER_APP_CDS_RESTORE_POSE     0x02 /* State holds an estimate, not the startup zeros */
+#define ROVER_APP_CDS_RESTORE_TWIST    0x04 /* Twist is recent enough to ramp on from */
+#define ROVER_APP_CDS_RESTORE_COMMAND  0x08 /* Target is a recent twist command */
+
+typedef struct
+{
+    uint32             Version;   /* ROVER_APP_CDS_VERSION */
+    uint32             SaveCount; /* Writes since the block was created */
+    RoverAppStamp_t    Stamp;     /* HR tick of the last write */
+    RoverAppOdometry_t State;     /* Pose estimate and measured twist */
+    RoverAppTwist_t    Target;    /* Commanded, trajectory or path twist */
+    RoverAppTwist_t    Twist;     /* Shaped twist sent */
+    uint8              CmdCounter;
+    uint8              ErrCounter;
+    uint8              Source;    /* ROVER_APP_CDS_SOURCE_<x> of Target */
+    uint8              Spare;
+} RoverAppCdsBlock_t;
+
+/*
+** Exported functions
+*/
+uint32 RoverAppCdsInit(RoverAppCdsBlock_t *Block);
+void   RoverAppCdsUpdate(RoverAppStamp_t Now, const RoverAppOdometry_t *State, const RoverAppTwist_t *Target,
+                         const RoverAppTwist_t *Twist, uint8 Source);
+uint32 RoverAppCdsSaves(void);
+
+#endif /* _rover_app_cds_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -0,0 +1,185 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_compact.c
+**
+** Purpose:
+**   Compact odometry encoding for the rover app.
+**
+** Notes:
+**   No state; safe to call from any task.
+**
+*******************************************************************************/
+
+/*
+** Include Files:
+*/
+#include "rover_app_compact.h"
+
+#include <math.h>
+
+#define ROVER_APP_COMPACT_COUNT_MAX 32767.0f
+#define ROVER_APP_COMPACT_QUAT_UNIT (ROVER_APP_COMPACT_COUNT_MAX * 1.41421356f) /* Counts per unit component */
+
+/*
+** Nearest count to Value / Step, clamped to +-32767; NaN and clamped
+** values set Bit in *Flags
+*/
+static inline int16 RoverAppCompactQuantize(float Value, float Step, uint16 Bit, uint16 *Flags)
+{
+    float Counts = Value / Step;
+
+    if (!(Counts >= -ROVER_APP_COMPACT_COUNT_MAX && Counts <= ROVER_APP_COMPACT_COUNT_MAX))
+    {
+        *Flags |= Bit;
+        if (isnan(Counts))
+        {
+            return 0;
+        }
+        return (Counts > 0.0f) ? (int16)ROVER_APP_COMPACT_COUNT_MAX : (int16)-ROVER_APP_COMPACT_COUNT_MAX;
+    }
+
+    return (int16)lrintf(Counts);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppCompactScales() -- quantization steps of a table, in field order   */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppCompactScales(const RoverAppTable_t *Table, float *Scale)
+{
+    uint32 i;
+
+    for (i = 0; i < 3; i++)
+    {
+        Scale[i]     = Table->PositionScale[i];
+        Scale[i + 3] = Table->LinearScale[i];
+        Scale[i + 6] = Table->AngularScale[i];
+    }
+
+} /* End of RoverAppCompactScales() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppCompactEncode() -- quantize an odometry state                      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppCompactEncode(const RoverAppOdometry_t *Odom, const float *Scale, RoverAppCompactState_t *State)
+{
+    const float Field[ROVER_APP_COMPACT_FIELDS] = {Odom->pose.x,          Odom->pose.y,          Odom->pose.z,
+                                                   Odom->twist.linear_x,  Odom->twist.linear_y,  Odom->twist.linear_z,
+                                                   Odom->twist.angular_x, Odom->twist.angular_y, Odom->twist.angular_z};
+    float       q[4] = {Odom->pose.qx, Odom->pose.qy, Odom->pose.qz, Odom->pose.qw};
+    float       Norm;
+    uint16      Flags   = 0;
+    uint32      Largest = 3;
+    uint32      i;
+    uint32      j;
+
+    for (i = 0; i < 3; i++)
+    {
+        State->Position[i] = RoverAppCompactQuantize(Field[i], Scale[i], (uint16)(1U << i), &Flags);
+        State->Linear[i]   = RoverAppCompactQuantize(Field[i + 3], Scale[i + 3], (uint16)(1U << (i + 3)), &Flags);
+        State->Angular[i]  = RoverAppCompactQuantize(Field[i + 6], Scale[i + 6], (uint16)(1U << (i + 6)), &Flags);
+    }
+
+    /* Unit quaternion, identity if there is none */
+    Norm = sqrtf((q[0] * q[0]) + (q[1] * q[1]) + (q[2] * q[2]) + (q[3] * q[3]));
+    if (!(Norm > 0.0f) || !isfinite(Norm))
+    {
+        q[0] = 0.0f;
+        q[1] = 0.0f;
+        q[2] = 0.0f;
+        q[3] = 1.0f;
+        Norm = 1.0f;
+    }
+
+    for (i = 0; i < 3; i++)
+    {
+        if (fabsf(q[i]) > fabsf(q[Largest]))
+        {
+            Largest = i;
+        }
+    }
+
+    /* q and -q are the same rotation: make the one left out positive */
+    if (q[Largest] < 0.0f)
+    {
+        Norm = -Norm;
+    }
+
+    for (i = 0, j = 0; i < 4; i++)
+    {
+        if (i != Largest)
+        {
+            State->Quat[j++] = (int16)lrintf(fmaxf(-ROVER_APP_COMPACT_COUNT_MAX,
+                                                   fminf(ROVER_APP_COMPACT_COUNT_MAX,
+                                                         (q[i] / Norm) * ROVER_APP_COMPACT_QUAT_UNIT)));
+        }
+    }
+
+    State->Flags = Flags | (uint16)(Largest << ROVER_APP_COMPACT_QUAT_SHIFT);
+
+} /* End of RoverAppCompactEncode() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppCompactDecode() -- odometry state back from its compact form       */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppCompactDecode(const RoverAppCompactState_t *State, const float *Scale, RoverAppOdometry_t *Odom)
+{
+    float  q[4];
+    float  Sum     = 0.0f;
+    uint32 Largest = (uint32)(State->Flags >> ROVER_APP_COMPACT_QUAT_SHIFT) & 3;
+    uint32 i;
+    uint32 j;
+
+    Odom->pose.x          = State->Position[0] * Scale[0];
+    Odom->pose.y          = State->Position[1] * Scale[1];
+    Odom->pose.z          = State->Position[2] * Scale[2];
+    Odom->twist.linear_x  = State->Linear[0] * Scale[3];
+    Odom->twist.linear_y  = State->Linear[1] * Scale[4];
+    Odom->twist.linear_z  = State->Linear[2] * Scale[5];
+    Odom->twist.angular_x = State->Angular[0] * Scale[6];
+    Odom->twist.angular_y = State->Angular[1] * Scale[7];
+    Odom->twist.angular_z = State->Angular[2] * Scale[8];
+
+    for (i = 0, j = 0; i < 4; i++)
+    {
+        if (i != Largest)
+        {
+            q[i] = State->Quat[j++] / ROVER_APP_COMPACT_QUAT_UNIT;
+            Sum += q[i] * q[i];
+        }
+    }
+    q[Largest] = sqrtf(fmaxf(0.0f, 1.0f - Sum));
+
+    Odom->pose.qx = q[0];
+    Odom->pose.qy = q[1];
+    Odom->pose.qz = q[2];
+    Odom->pose.qw = q[3];
+
+} /* End of RoverAppCompactDecode() */
+
+/************************/
+/*  End of File Comment */
+/************************/
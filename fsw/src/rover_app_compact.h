@@ -0,0 +1,58 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_compact.h
+**
+** Purpose:
+**   Encoding of the odometry state into RoverAppCompactState_t and back,
+**   for ROVER_APP_COMPACT_TLM_MID and for ground tools.
+**
+** Notes:
+**   Scale[] holds the ROVER_APP_COMPACT_FIELDS quantization steps in
+**   field order (pose x y z, linear x y z, angular x y z), as given by
+**   RoverAppCompactScales(); decoding needs the table the packet was
+**   encoded with, which the packet's TableGeneration identifies.  Fields
+**   round to the nearest count, so the error is at most half a step
+**   unless the field's saturation flag is set.  The
+**   quaternion is normalized and sent as the three components other than
+**   the largest one, with its sign chosen to make that one positive; the
+**   rotation is kept to within about 3e-5 rad.
+**
+*******************************************************************************/
+#ifndef _rover_app_compact_h_
+#define _rover_app_compact_h_
+
+#include "cfe.h"
+
+#include "rover_app_msg.h"
+#include "rover_app_table.h"
+
+/*
+** Exported functions
+*/
+void RoverAppCompactScales(const RoverAppTable_t *Table, float *Scale);
+void RoverAppCompactEncode(const RoverAppOdometry_t *Odom, const float *Scale, RoverAppCompactState_t *State);
+void RoverAppCompactDecode(const RoverAppCompactState_t *State, const float *Scale, RoverAppOdometry_t *Odom);
+
+#endif /* _rover_app_compact_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
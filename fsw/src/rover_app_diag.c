@@ -0,0 +1,231 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_diag.c
+**
+** Purpose:
+**   Control loop timing histograms for the rover app.
+**
+** Notes:
+**   The report is built from live histograms without stopping the writer,
+**   so a sample landing mid-report may be counted in some fields only.
+**
+*******************************************************************************/
+
+/*
+** Include Files:
+*/
+#include "rover_app_diag.h"
+#include "rover_app_msg.h"
+#include "rover_app_msgids.h"
+
+#include <string.h>
+
+typedef struct
+{
+    RoverAppDiagHist_t Hist[ROVER_APP_DIAG_COUNT];
+
+    uint32 ResetRequests; /* Bumped by RoverAppDiagReset() */
+    uint32 ResetsDone;    /* Writer side */
+
+    RoverAppDiagTlm_t Tlm;
+} RoverAppDiagData_t;
+
+static RoverAppDiagData_t RoverAppDiagData;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppDiagBucket() -- histogram bucket of a value                        */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static uint32 RoverAppDiagBucket(uint32 Value)
+{
+    uint32 Exp;
+
+    if (Value < ROVER_APP_DIAG_SUB_BUCKETS)
+    {
+        return Value;
+    }
+
+    Exp = 31 - (uint32)__builtin_clz(Value);
+
+    return ((Exp - 2) * ROVER_APP_DIAG_SUB_BUCKETS) + ((Value >> (Exp - 3)) & (ROVER_APP_DIAG_SUB_BUCKETS - 1));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppDiagBucketLimit() -- largest value in a bucket                     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static uint32 RoverAppDiagBucketLimit(uint32 Bucket)
+{
+    uint32 Shift;
+
+    if (Bucket < ROVER_APP_DIAG_SUB_BUCKETS)
+    {
+        return Bucket;
+    }
+
+    Shift = (Bucket / ROVER_APP_DIAG_SUB_BUCKETS) - 1;
+
+    return (uint32)((((uint64)ROVER_APP_DIAG_SUB_BUCKETS + (Bucket % ROVER_APP_DIAG_SUB_BUCKETS) + 1) << Shift) - 1);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppDiagPercentile() -- Pct (per thousand) of a histogram              */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static uint32 RoverAppDiagPercentile(const RoverAppDiagHist_t *Hist, uint32 Count, uint32 PerMille)
+{
+    uint64 Target = (((uint64)Count * PerMille) + 999) / 1000;
+    uint64 Seen   = 0;
+    uint32 Limit;
+    uint32 i;
+
+    for (i = 0; i < ROVER_APP_DIAG_BUCKETS; i++)
+    {
+        Seen += Hist->Buckets[i];
+        if (Seen >= Target && Hist->Buckets[i] != 0)
+        {
+            Limit = RoverAppDiagBucketLimit(i);
+            return (Limit < Hist->Max) ? Limit : Hist->Max;
+        }
+    }
+
+    return Hist->Max;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppDiagSummarize() -- fill a telemetry entry from a histogram         */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void RoverAppDiagSummarize(const RoverAppDiagHist_t *Hist, RoverAppDiagStats_t *Stats)
+{
+    uint32 Count = Hist->Count;
+
+    memset(Stats, 0, sizeof(*Stats));
+
+    if (Count == 0)
+    {
+        return;
+    }
+
+    Stats->Count  = Count;
+    Stats->MinNs  = Hist->Min;
+    Stats->MaxNs  = Hist->Max;
+    Stats->MeanNs = (uint32)(Hist->Sum / Count);
+    Stats->P50Ns  = RoverAppDiagPercentile(Hist, Count, 500);
+    Stats->P99Ns  = RoverAppDiagPercentile(Hist, Count, 990);
+    Stats->P999Ns = RoverAppDiagPercentile(Hist, Count, 999);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppDiagInit() -- clear the histograms, set up the packet              */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppDiagInit(void)
+{
+    memset(&RoverAppDiagData, 0, sizeof(RoverAppDiagData));
+
+    CFE_MSG_Init(&RoverAppDiagData.Tlm.TlmHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_DIAG_TLM_MID),
+                 sizeof(RoverAppDiagData.Tlm));
+
+} /* End of RoverAppDiagInit() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppDiagAdd() -- record the time from Start to End                     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppDiagAdd(uint32 Hist, RoverAppStamp_t Start, RoverAppStamp_t End)
+{
+    RoverAppDiagHist_t *H;
+    uint64              Ns;
+    uint32              Value;
+    uint32              Requests;
+
+    Requests = __atomic_load_n(&RoverAppDiagData.ResetRequests, __ATOMIC_ACQUIRE);
+    if (Requests != RoverAppDiagData.ResetsDone)
+    {
+        memset(RoverAppDiagData.Hist, 0, sizeof(RoverAppDiagData.Hist));
+        RoverAppDiagData.ResetsDone = Requests;
+    }
+
+    if (Hist >= ROVER_APP_DIAG_COUNT || End < Start)
+    {
+        return;
+    }
+
+    Ns    = RoverAppStampToNs(End - Start);
+    Value = (Ns > 0xFFFFFFFFULL) ? 0xFFFFFFFFU : (uint32)Ns;
+    H     = &RoverAppDiagData.Hist[Hist];
+
+    if (H->Count == 0 || Value < H->Min)
+    {
+        H->Min = Value;
+    }
+    if (Value > H->Max)
+    {
+        H->Max = Value;
+    }
+
+    H->Sum += Value;
+    H->Buckets[RoverAppDiagBucket(Value)]++;
+    H->Count++;
+
+} /* End of RoverAppDiagAdd() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppDiagReset() -- ask the writer to clear the histograms              */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppDiagReset(void)
+{
+    __atomic_add_fetch(&RoverAppDiagData.ResetRequests, 1, __ATOMIC_RELEASE);
+
+} /* End of RoverAppDiagReset() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppDiagReport() -- send the diagnostics packet                        */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppDiagReport(void)
+{
+    RoverAppDiagTlmPayload_t *Payload = &RoverAppDiagData.Tlm.Payload;
+
+    RoverAppDiagSummarize(&RoverAppDiagData.Hist[ROVER_APP_DIAG_TICK_EXEC], &Payload->TickExec);
+    RoverAppDiagSummarize(&RoverAppDiagData.Hist[ROVER_APP_DIAG_TICK_PERIOD], &Payload->TickPeriod);
+    RoverAppDiagSummarize(&RoverAppDiagData.Hist[ROVER_APP_DIAG_ODOM_EXEC], &Payload->OdomExec);
+    RoverAppDiagSummarize(&RoverAppDiagData.Hist[ROVER_APP_DIAG_SCHED_LATE], &Payload->SchedLate);
+
+    CFE_SB_TimeStampMsg(&RoverAppDiagData.Tlm.TlmHeader.Msg);
+
+    return CFE_SB_TransmitMsg(&RoverAppDiagData.Tlm.TlmHeader.Msg, true);
+
+} /* End of RoverAppDiagReport() */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -0,0 +1,74 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_diag.h
+**
+** Purpose:
+**   Control loop timing histograms and the diagnostics telemetry packet.
+**
+** Notes:
+**   Histograms are log-linear (8 buckets per power of two) over
+**   nanoseconds, fixed size, and updated by the task that services the
+**   control pipe only.  A reset requested from another task is applied
+**   by that task before its next sample.
+**
+*******************************************************************************/
+#ifndef _rover_app_diag_h_
+#define _rover_app_diag_h_
+
+#include "cfe.h"
+
+#include "rover_app_history.h"
+#include "rover_app_platform_cfg.h"
+
+/*
+** Histograms
+*/
+#define ROVER_APP_DIAG_TICK_EXEC   0
+#define ROVER_APP_DIAG_TICK_PERIOD 1
+#define ROVER_APP_DIAG_ODOM_EXEC   2
+#define ROVER_APP_DIAG_SCHED_LATE  3
+#define ROVER_APP_DIAG_COUNT       4
+
+#define ROVER_APP_DIAG_SUB_BUCKETS 8
+#define ROVER_APP_DIAG_BUCKETS     (ROVER_APP_DIAG_SUB_BUCKETS * 30) /* Up to 2^32 ns */
+
+typedef struct
+{
+    uint32 Count;
+    uint32 Min;
+    uint32 Max;
+    uint64 Sum;
+    uint32 Buckets[ROVER_APP_DIAG_BUCKETS];
+} RoverAppDiagHist_t;
+
+/*
+** Exported functions
+*/
+void  RoverAppDiagInit(void);
+void  RoverAppDiagAdd(uint32 Hist, RoverAppStamp_t Start, RoverAppStamp_t End);
+void  RoverAppDiagReset(void);
+int32 RoverAppDiagReport(void);
+
+#endif /* _rover_app_diag_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
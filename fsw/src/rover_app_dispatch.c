@@ -0,0 +1,323 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_dispatch.c
+**
+** Purpose:
+**   Table driven message dispatch for the rover app.
+**
+** Notes:
+**   The tables below are expanded from rover_app_schema.h; nothing in
+**   this file needs editing when messages are added.
+**
+*******************************************************************************/
+
+/*
+** Include Files:
+*/
+#include "rover_app_events.h"
+#include "rover_app_evlimit.h"
+#include "rover_app.h"
+#include "rover_app_dispatch.h"
+#include "rover_app_stats.h"
+#include "rover_app_trace.h"
+#include "rover_app_record.h"
+
+#include <string.h>
+
+typedef struct
+{
+    bool   Used;
+    bool   Ground;
+    uint16 MsgId;
+    uint8  Base;  /* First CcMap[] entry of this MID */
+    uint8  Limit; /* Highest command code + 1 */
+} RoverAppDispatchSlot_t;
+
+typedef struct
+{
+    uint16 MsgId; /* First MID of the range, the one in Slot[] */
+    uint16 Count;
+    uint8  Slot;
+} RoverAppDispatchRange_t;
+
+typedef struct
+{
+    RoverAppDispatchSlot_t  Slot[ROVER_APP_DISPATCH_HASH_SIZE];
+    RoverAppDispatchRange_t Range[ROVER_APP_SUBSCRIPTION_COUNT];
+    uint32                  RangeCount;
+    uint8                  CcMap[ROVER_APP_DISPATCH_CC_MAP_SIZE];
+    bool                   Ground[ROVER_APP_MSG_COUNT];
+} RoverAppDispatchData_t;
+
+static RoverAppDispatchData_t RoverAppDispatchData;
+
+/*
+** One wrapper per message, casting the buffer to the handler's type
+*/
+#define ROVER_APP_DISPATCH_WRAPPER(Name, MsgId, FcnCode, Type, Length, Handler) \
+    static int32 RoverAppDispatch_##Name(const CFE_SB_Buffer_t *SBBufPtr)        \
+    {                                                                             \
+        return Handler((const Type *)SBBufPtr);                                   \
+    }
+ROVER_APP_SCHEMA_MESSAGES(ROVER_APP_DISPATCH_WRAPPER)
+#undef ROVER_APP_DISPATCH_WRAPPER
+
+#define ROVER_APP_DISPATCH_ENTRY(Name, MsgId, FcnCode, Type, Length, Handler) \
+    {MsgId, FcnCode, Length, sizeof(Type), RoverAppDispatch_##Name},
+const RoverAppDispatchEntry_t RoverAppDispatchTable[ROVER_APP_MSG_COUNT] = {
+    ROVER_APP_SCHEMA_MESSAGES(ROVER_APP_DISPATCH_ENTRY)};
+#undef ROVER_APP_DISPATCH_ENTRY
+
+#define ROVER_APP_DISPATCH_SUBSCRIPTION(MsgId, Count, Pipe, Ground, Name) {MsgId, Count, Pipe, Ground, Name},
+const RoverAppSubscription_t RoverAppSubscriptions[ROVER_APP_SUBSCRIPTION_COUNT] = {
+    ROVER_APP_SCHEMA_SUBSCRIPTIONS(ROVER_APP_DISPATCH_SUBSCRIPTION)};
+#undef ROVER_APP_DISPATCH_SUBSCRIPTION
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppDispatchFind() -- hash slot of a MID, or the empty slot for it     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static RoverAppDispatchSlot_t *RoverAppDispatchFind(uint32 MsgId)
+{
+    uint32 h = (MsgId * 0x9E3779B1U) >> (32 - ROVER_APP_DISPATCH_HASH_BITS);
+
+    /* The table is never more than half full, so this ends */
+    while (RoverAppDispatchData.Slot[h].Used && RoverAppDispatchData.Slot[h].MsgId != MsgId)
+    {
+        h = (h + 1) & (ROVER_APP_DISPATCH_HASH_SIZE - 1);
+    }
+
+    return &RoverAppDispatchData.Slot[h];
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppDispatchFindRange() -- hash slot of the range holding a MID        */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static const RoverAppDispatchSlot_t *RoverAppDispatchFindRange(uint32 MsgId)
+{
+    const RoverAppDispatchRange_t *Range;
+    uint32                         i;
+
+    for (i = 0; i < RoverAppDispatchData.RangeCount; i++)
+    {
+        Range = &RoverAppDispatchData.Range[i];
+        if ((MsgId - Range->MsgId) < Range->Count)
+        {
+            return &RoverAppDispatchData.Slot[Range->Slot];
+        }
+    }
+
+    return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppDispatchInit() -- build the lookup tables from the schema          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppDispatchInit(void)
+{
+    const RoverAppDispatchEntry_t *Entry;
+    const RoverAppSubscription_t  *Sub;
+    const RoverAppSubscription_t  *Other;
+    RoverAppDispatchSlot_t        *Slot;
+    uint32                         Base = 0;
+    uint32                         i;
+    uint32                         j;
+
+    memset(&RoverAppDispatchData, 0, sizeof(RoverAppDispatchData));
+    memset(RoverAppDispatchData.CcMap, ROVER_APP_MSG_UNKNOWN_CC, sizeof(RoverAppDispatchData.CcMap));
+
+    for (i = 0; i < ROVER_APP_SUBSCRIPTION_COUNT; i++)
+    {
+        Sub = &RoverAppSubscriptions[i];
+        for (j = 0; j < i; j++)
+        {
+            Other = &RoverAppSubscriptions[j];
+            if (Sub->MsgId < Other->MsgId + Other->Count && Other->MsgId < Sub->MsgId + Sub->Count)
+            {
+                CFE_ES_WriteToSysLog("Rover App: MID 0x%04X subscribed twice\n", (unsigned int)Sub->MsgId);
+                return CFE_SB_BAD_ARGUMENT;
+            }
+        }
+
+        Slot         = RoverAppDispatchFind(Sub->MsgId);
+        Slot->Used   = true;
+        Slot->MsgId  = Sub->MsgId;
+        Slot->Ground = Sub->Ground;
+
+        if (Sub->Count > 1)
+        {
+            RoverAppDispatchData.Range[RoverAppDispatchData.RangeCount].MsgId = Sub->MsgId;
+            RoverAppDispatchData.Range[RoverAppDispatchData.RangeCount].Count = Sub->Count;
+            RoverAppDispatchData.Range[RoverAppDispatchData.RangeCount].Slot =
+                (uint8)(Slot - RoverAppDispatchData.Slot);
+            RoverAppDispatchData.RangeCount++;
+        }
+    }
+
+    for (i = 0; i < ROVER_APP_MSG_COUNT; i++)
+    {
+        Entry = &RoverAppDispatchTable[i];
+        Slot  = RoverAppDispatchFind(Entry->MsgId);
+        if (!Slot->Used)
+        {
+            CFE_ES_WriteToSysLog("Rover App: MID 0x%04X handled but not subscribed\n", (unsigned int)Entry->MsgId);
+            return CFE_SB_BAD_ARGUMENT;
+        }
+        if (Entry->FcnCode >= Slot->Limit)
+        {
+            Slot->Limit = Entry->FcnCode + 1;
+        }
+    }
+
+    for (i = 0; i < ROVER_APP_DISPATCH_HASH_SIZE; i++)
+    {
+        Slot = &RoverAppDispatchData.Slot[i];
+        if (Base + Slot->Limit > ROVER_APP_DISPATCH_CC_MAP_SIZE)
+        {
+            CFE_ES_WriteToSysLog("Rover App: ROVER_APP_DISPATCH_CC_MAP_SIZE too small\n");
+            return CFE_SB_BAD_ARGUMENT;
+        }
+        Slot->Base = (uint8)Base;
+        Base += Slot->Limit;
+    }
+
+    for (i = 0; i < ROVER_APP_MSG_COUNT; i++)
+    {
+        Entry = &RoverAppDispatchTable[i];
+        Slot  = RoverAppDispatchFind(Entry->MsgId);
+        if (RoverAppDispatchData.CcMap[Slot->Base + Entry->FcnCode] != ROVER_APP_MSG_UNKNOWN_CC)
+        {
+            CFE_ES_WriteToSysLog("Rover App: MID 0x%04X CC %u handled twice\n", (unsigned int)Entry->MsgId,
+                                 (unsigned int)Entry->FcnCode);
+            return CFE_SB_BAD_ARGUMENT;
+        }
+        RoverAppDispatchData.CcMap[Slot->Base + Entry->FcnCode] = (uint8)i;
+        RoverAppDispatchData.Ground[i]                          = Slot->Ground;
+    }
+
+    return CFE_SUCCESS;
+
+} /* End of RoverAppDispatchInit() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppDispatchLookup() -- dispatch index of a message                    */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+uint32 RoverAppDispatchLookup(const CFE_MSG_Message_t *MsgPtr)
+{
+    const RoverAppDispatchSlot_t *Slot;
+    CFE_SB_MsgId_t                MsgId   = CFE_SB_INVALID_MSG_ID;
+    CFE_MSG_FcnCode_t             FcnCode = 0;
+
+    CFE_MSG_GetMsgId(MsgPtr, &MsgId);
+
+    Slot = RoverAppDispatchFind(CFE_SB_MsgIdToValue(MsgId));
+    if (!Slot->Used)
+    {
+        Slot = RoverAppDispatchFindRange(CFE_SB_MsgIdToValue(MsgId));
+        if (Slot == NULL)
+        {
+            return ROVER_APP_MSG_UNKNOWN_MID;
+        }
+    }
+
+    CFE_MSG_GetFcnCode(MsgPtr, &FcnCode);
+    if (FcnCode >= Slot->Limit)
+    {
+        return ROVER_APP_MSG_UNKNOWN_CC;
+    }
+
+    return RoverAppDispatchData.CcMap[Slot->Base + FcnCode];
+
+} /* End of RoverAppDispatchLookup() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppDispatchMsg() -- check a message's length and run its handler      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppDispatchMsg(CFE_SB_Buffer_t *SBBufPtr, uint32 Index)
+{
+    const RoverAppDispatchEntry_t *Entry;
+    CFE_SB_MsgId_t                 MsgId   = CFE_SB_INVALID_MSG_ID;
+    CFE_MSG_FcnCode_t              FcnCode = 0;
+    CFE_MSG_Size_t                 Size    = 0;
+    RoverAppStamp_t                Start;
+
+    ROVER_APP_RECORD_MSG(&SBBufPtr->Msg);
+
+    if (Index == ROVER_APP_MSG_UNKNOWN_CC)
+    {
+        CFE_MSG_GetFcnCode(&SBBufPtr->Msg, &FcnCode);
+
+        ROVER_APP_TRACE_MSG(ROVER_APP_TRACE_LEVEL_INFO, ROVER_APP_TRACE_PT_GROUND_CMD, &SBBufPtr->Msg,
+                            CFE_STATUS_BAD_COMMAND_CODE);
+
+        ROVER_APP_EVENT(ROVER_APP_COMMAND_ERR_EID, CFE_EVS_EventType_ERROR, "Invalid ground command code: CC = %d",
+                        FcnCode);
+        return;
+    }
+
+    if (Index >= ROVER_APP_MSG_COUNT)
+    {
+        CFE_MSG_GetMsgId(&SBBufPtr->Msg, &MsgId);
+
+        ROVER_APP_EVENT(ROVER_APP_INVALID_MSGID_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: invalid command packet,MID = 0x%x", (unsigned int)CFE_SB_MsgIdToValue(MsgId));
+        return;
+    }
+
+    Entry = &RoverAppDispatchTable[Index];
+
+    if (RoverAppDispatchData.Ground[Index])
+    {
+        ROVER_APP_TRACE_MSG(ROVER_APP_TRACE_LEVEL_INFO, ROVER_APP_TRACE_PT_GROUND_CMD, &SBBufPtr->Msg, CFE_SUCCESS);
+    }
+
+    /* Long enough is enough for a wakeup; the rest get the exact check */
+    if (Entry->LengthRule == ROVER_APP_LENGTH_MIN)
+    {
+        CFE_MSG_GetSize(&SBBufPtr->Msg, &Size);
+    }
+    if ((Entry->LengthRule != ROVER_APP_LENGTH_MIN || Size < Entry->ExpectedLength) &&
+        !RoverAppVerifyCmdLength(&SBBufPtr->Msg, Entry->ExpectedLength))
+    {
+        RoverAppStatsLengthError(Index);
+        return;
+    }
+
+    Start = RoverAppTimeToStamp(CFE_TIME_GetTime());
+
+    Entry->Handler(SBBufPtr);
+
+    RoverAppStatsProcessed(Index, Start, RoverAppTimeToStamp(CFE_TIME_GetTime()));
+
+} /* End of RoverAppDispatchMsg() */
+
+/************************/
+/*  End of File Comment */
+/************************/
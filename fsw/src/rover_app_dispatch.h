@@ -0,0 +1,103 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_dispatch.h
+**
+** Purpose:
+**   Table driven message dispatch, built from rover_app_schema.h.
+**
+** Notes:
+**   RoverAppDispatchLookup() maps a message to its ROVER_APP_MSG_<Name>
+**   index in constant time: a small open addressing table keyed by MID,
+**   then a per-MID array indexed by command code.  MIDs subscribed as a
+**   range are not in the table; a miss falls back to comparing against
+**   each range, which stays cheap while ranges are few.  All are filled by
+**   RoverAppDispatchInit() and read only afterwards, so any task may
+**   look messages up.
+**
+*******************************************************************************/
+#ifndef _rover_app_dispatch_h_
+#define _rover_app_dispatch_h_
+
+#include "cfe.h"
+
+#include "rover_app_schema.h"
+
+/*
+** Dispatch indices, ROVER_APP_MSG_<Name>, in schema order
+*/
+#define ROVER_APP_DISPATCH_ENUM(Name, MsgId, FcnCode, Type, Length, Handler) ROVER_APP_MSG_##Name,
+enum
+{
+    ROVER_APP_SCHEMA_MESSAGES(ROVER_APP_DISPATCH_ENUM)
+};
+#undef ROVER_APP_DISPATCH_ENUM
+
+#define ROVER_APP_MSG_UNKNOWN_MID (ROVER_APP_MSG_COUNT)     /* MID not subscribed */
+#define ROVER_APP_MSG_UNKNOWN_CC  (ROVER_APP_MSG_COUNT + 1) /* Known MID, no such command code */
+
+/*
+** Lookup table sizes, checked against the schema
+*/
+#define ROVER_APP_DISPATCH_HASH_BITS   4
+#define ROVER_APP_DISPATCH_HASH_SIZE   (1 << ROVER_APP_DISPATCH_HASH_BITS)
+#define ROVER_APP_DISPATCH_CC_MAP_SIZE 64
+
+#if (ROVER_APP_SUBSCRIPTION_COUNT * 2) > ROVER_APP_DISPATCH_HASH_SIZE
+#error ROVER_APP_DISPATCH_HASH_BITS too small for the subscriptions in rover_app_schema.h
+#endif
+
+#if ROVER_APP_MSG_UNKNOWN_CC > 255
+#error Too many messages in rover_app_schema.h for 8-bit dispatch indices
+#endif
+
+typedef struct
+{
+    uint16 MsgId;
+    uint8  FcnCode;
+    uint8  LengthRule; /* ROVER_APP_LENGTH_<x> */
+    size_t ExpectedLength;
+    int32 (*Handler)(const CFE_SB_Buffer_t *SBBufPtr);
+} RoverAppDispatchEntry_t;
+
+typedef struct
+{
+    uint16      MsgId;
+    uint16      Count; /* MIDs from MsgId, 1 for a single MID */
+    uint8       Pipe;
+    bool        Ground;
+    const char *Name;
+} RoverAppSubscription_t;
+
+extern const RoverAppDispatchEntry_t RoverAppDispatchTable[ROVER_APP_MSG_COUNT];
+extern const RoverAppSubscription_t  RoverAppSubscriptions[ROVER_APP_SUBSCRIPTION_COUNT];
+
+/*
+** Exported functions
+*/
+int32  RoverAppDispatchInit(void);
+uint32 RoverAppDispatchLookup(const CFE_MSG_Message_t *MsgPtr);
+void   RoverAppDispatchMsg(CFE_SB_Buffer_t *SBBufPtr, uint32 Index);
+
+#endif /* _rover_app_dispatch_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
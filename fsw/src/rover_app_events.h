@@ -37,8 +37,32 @@
 #define ROVER_APP_INVALID_MSGID_ERR_EID 5
 #define ROVER_APP_LEN_ERR_EID           6
 #define ROVER_APP_PIPE_ERR_EID          7
+#define ROVER_APP_TRACE_DUMP_INF_EID    8
+#define ROVER_APP_TRACE_ERR_EID         9
+#define ROVER_APP_DIAG_RESET_INF_EID    10
+#define ROVER_APP_TRAJ_INF_EID          11
+#define ROVER_APP_TRAJ_ERR_EID          12
+#define ROVER_APP_SCHED_INF_EID         13
+#define ROVER_APP_SCHED_ERR_EID         14
+#define ROVER_APP_PATH_INF_EID          15
+#define ROVER_APP_PATH_ERR_EID          16
+#define ROVER_APP_FLEET_INF_EID         17
+#define ROVER_APP_OUTPUT_INF_EID        18
+#define ROVER_APP_OUTPUT_ERR_EID        19
+#define ROVER_APP_EVLIMIT_INF_EID       20
+#define ROVER_APP_EVLIMIT_ERR_EID       21
+#define ROVER_APP_EVLIMIT_SUMMARY_EID   22
+#define ROVER_APP_RECORD_INF_EID        23
+#define ROVER_APP_RECORD_ERR_EID        24
+#define ROVER_APP_BLACKBOX_INF_EID      25
+#define ROVER_APP_BLACKBOX_ERR_EID      26
+#define ROVER_APP_TABLE_INF_EID         27
+#define ROVER_APP_TABLE_ERR_EID         28
+#define ROVER_APP_CDS_INF_EID           29
+#define ROVER_APP_CDS_ERR_EID           30
+#define ROVER_APP_ODOM_RESEED_INF_EID   31
 
-#define ROVER_APP_EVENT_COUNTS 7
+#define ROVER_APP_EVENT_COUNTS 31
 
 #endif /* _rover_app_events_h_ */
 
@@ -0,0 +1,307 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_evlimit.c
+**
+** Purpose:
+**   Event rate limiting for the rover app.
+**
+** Notes:
+**   Bucket times are in units of 2^-16 s, kept in 32 bits and compared
+**   as wrapping differences; the summary moves idle buckets forward so a
+**   difference never wraps.
+**
+*******************************************************************************/
+
+/*
+** Include Files:
+*/
+#include "rover_app_evlimit.h"
+#include "rover_app_events.h"
+#include "rover_app_seqlock.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ROVER_APP_EVLIMIT_SHIFT 16                                  /* Stamp to bucket time units */
+#define ROVER_APP_EVLIMIT_UNITS ((float)(1U << (32 - ROVER_APP_EVLIMIT_SHIFT))) /* Per second */
+#define ROVER_APP_EVLIMIT_IDS   (ROVER_APP_EVENT_COUNTS + 1)        /* Indexed by event ID */
+
+typedef struct
+{
+    uint32 Seq; /* Odd while a write is in progress */
+    union
+    {
+        RoverAppEvLimit_t Value;
+        uint32            Words[ROVER_APP_SEQLOCK_WORDS(RoverAppEvLimit_t)];
+    } Data;
+} RoverAppEvLimitCell_t;
+
+typedef struct
+{
+    RoverAppEvLimitCell_t Cell[ROVER_APP_EVLIMIT_IDS];
+    uint32                Full[ROVER_APP_EVLIMIT_IDS];       /* Time the bucket is full again */
+    uint32                Suppressed[ROVER_APP_EVLIMIT_IDS]; /* Since init */
+
+    /* Summary, command task only */
+    uint32          Reported[ROVER_APP_EVLIMIT_IDS]; /* Suppressed at the last summary */
+    RoverAppStamp_t LastSummary;
+} RoverAppEvLimitData_t;
+
+static RoverAppEvLimitData_t RoverAppEvLimitData;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppEvLimitMake() -- bucket of Burst events refilled at Rate, false if */
+/*                          out of range                                      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+bool RoverAppEvLimitMake(float Rate, uint16 Burst, RoverAppEvLimit_t *Limit)
+{
+    float Interval;
+
+    if (!isfinite(Rate) || Rate < 0.0f || Burst < 1)
+    {
+        return false;
+    }
+
+    Limit->Interval = 0;
+    Limit->Tau      = 0;
+    if (Rate > 0.0f)
+    {
+        Interval = ROVER_APP_EVLIMIT_UNITS / Rate;
+        if (Interval < 1.0f || (Interval * (float)Burst) >= 2147483648.0f)
+        {
+            return false;
+        }
+        Limit->Interval = (uint32)lrintf(Interval);
+        Limit->Tau      = Limit->Interval * (uint32)(Burst - 1);
+    }
+
+    return true;
+
+} /* End of RoverAppEvLimitMake() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppEvLimitInit() -- full buckets with the table's limit               */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppEvLimitInit(const RoverAppEvLimit_t *Limit)
+{
+    uint32 i;
+
+    memset(&RoverAppEvLimitData, 0, sizeof(RoverAppEvLimitData));
+    RoverAppEvLimitData.LastSummary = RoverAppTimeToStamp(CFE_TIME_GetTime());
+    for (i = 0; i < ROVER_APP_EVLIMIT_IDS; i++)
+    {
+        RoverAppEvLimitData.Full[i] = (uint32)(RoverAppEvLimitData.LastSummary >> ROVER_APP_EVLIMIT_SHIFT);
+    }
+    RoverAppEvLimitConfig(Limit);
+
+} /* End of RoverAppEvLimitInit() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppEvLimitConfig() -- give every event ID the table's limit, command  */
+/*                            task only                                       */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppEvLimitConfig(const RoverAppEvLimit_t *Limit)
+{
+    RoverAppEvLimitCell_t *Cell;
+    uint32                 i;
+
+    for (i = 0; i < ROVER_APP_EVLIMIT_IDS; i++)
+    {
+        Cell = &RoverAppEvLimitData.Cell[i];
+        RoverAppSeqLockWrite(&Cell->Seq, Cell->Data.Words, Limit, ROVER_APP_SEQLOCK_WORDS(RoverAppEvLimit_t));
+    }
+
+} /* End of RoverAppEvLimitConfig() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppEvLimitSet() -- limit of one event ID, or all of them for 0,       */
+/*                         command task only                                  */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppEvLimitSet(uint16 EventId, float Rate, uint16 Burst)
+{
+    RoverAppEvLimitCell_t *Cell;
+    RoverAppEvLimit_t      Limit;
+    uint32                 i;
+
+    if (EventId >= ROVER_APP_EVLIMIT_IDS || !RoverAppEvLimitMake(Rate, Burst, &Limit))
+    {
+        ROVER_APP_EVENT(ROVER_APP_EVLIMIT_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: bad event limit for event %u: %.3f/s, burst %u", (unsigned int)EventId,
+                        (double)Rate, (unsigned int)Burst);
+        return CFE_STATUS_VALIDATION_FAILURE;
+    }
+
+    for (i = 0; i < ROVER_APP_EVLIMIT_IDS; i++)
+    {
+        if (EventId == 0 || EventId == i)
+        {
+            Cell = &RoverAppEvLimitData.Cell[i];
+            RoverAppSeqLockWrite(&Cell->Seq, Cell->Data.Words, &Limit, ROVER_APP_SEQLOCK_WORDS(RoverAppEvLimit_t));
+        }
+    }
+
+    ROVER_APP_EVENT(ROVER_APP_EVLIMIT_INF_EID, CFE_EVS_EventType_INFORMATION,
+                    "rover app: event %u limited to %.3f/s, burst %u", (unsigned int)EventId, (double)Rate,
+                    (unsigned int)Burst);
+
+    return CFE_SUCCESS;
+
+} /* End of RoverAppEvLimitSet() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppEvLimitAllow() -- take a token for an event, false to drop it      */
+/*                                                                            */
+/*   Unknown event IDs, and limits being changed right now, always pass.    */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+bool RoverAppEvLimitAllow(uint16 EventId)
+{
+    const RoverAppEvLimitCell_t *Cell;
+    RoverAppEvLimit_t            Limit;
+    uint32                       Now;
+    uint32                       Full;
+    uint32                       Next;
+
+    if (EventId >= ROVER_APP_EVLIMIT_IDS)
+    {
+        return true;
+    }
+
+    Cell = &RoverAppEvLimitData.Cell[EventId];
+    if (!RoverAppSeqLockRead(&Cell->Seq, Cell->Data.Words, &Limit, ROVER_APP_SEQLOCK_WORDS(RoverAppEvLimit_t)) ||
+        Limit.Interval == 0)
+    {
+        return true;
+    }
+
+    Now  = (uint32)(RoverAppTimeToStamp(CFE_TIME_GetTime()) >> ROVER_APP_EVLIMIT_SHIFT);
+    Full = __atomic_load_n(&RoverAppEvLimitData.Full[EventId], __ATOMIC_RELAXED);
+    do
+    {
+        /* A full bucket is full from now on; take a token if one is left */
+        Next = ((int32)(Full - Now) > 0) ? Full : Now;
+        if ((int32)(Next - Now) > (int32)Limit.Tau)
+        {
+            __atomic_fetch_add(&RoverAppEvLimitData.Suppressed[EventId], 1, __ATOMIC_RELAXED);
+            return false;
+        }
+        Next += Limit.Interval;
+    } while (!__atomic_compare_exchange_n(&RoverAppEvLimitData.Full[EventId], &Full, Next, true, __ATOMIC_RELAXED,
+                                          __ATOMIC_RELAXED));
+
+    return true;
+
+} /* End of RoverAppEvLimitAllow() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppEvLimitSummary() -- every ROVER_APP_EVLIMIT_SUMMARY_S, report the  */
+/*                             events held back since the last report,        */
+/*                             command task only                              */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppEvLimitSummary(RoverAppStamp_t Now)
+{
+    RoverAppEvLimitData_t *Data = &RoverAppEvLimitData;
+    char                   List[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH];
+    size_t                 Used  = 0;
+    uint32                 Total = 0;
+    uint32                 Tick;
+    uint32                 Full;
+    uint32                 Count;
+    uint32                 Delta;
+    uint32                 i;
+    int                    n;
+
+    if (Now < Data->LastSummary || (Now - Data->LastSummary) < ((RoverAppStamp_t)ROVER_APP_EVLIMIT_SUMMARY_S << 32))
+    {
+        return;
+    }
+    Data->LastSummary = Now;
+
+    List[0] = '\0';
+    Tick    = (uint32)(Now >> ROVER_APP_EVLIMIT_SHIFT);
+    for (i = 0; i < ROVER_APP_EVLIMIT_IDS; i++)
+    {
+        /* Keep idle buckets from falling a wrap behind */
+        Full = __atomic_load_n(&Data->Full[i], __ATOMIC_RELAXED);
+        if ((int32)(Tick - Full) > 0)
+        {
+            __atomic_compare_exchange_n(&Data->Full[i], &Full, Tick, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+        }
+
+        Count             = __atomic_load_n(&Data->Suppressed[i], __ATOMIC_RELAXED);
+        Delta             = Count - Data->Reported[i];
+        Data->Reported[i] = Count;
+        if (Delta == 0)
+        {
+            continue;
+        }
+
+        Total += Delta;
+        if (Used < sizeof(List))
+        {
+            n = snprintf(&List[Used], sizeof(List) - Used, " %u:%u", (unsigned int)i, (unsigned int)Delta);
+            Used += (n > 0) ? (size_t)n : 0;
+        }
+    }
+
+    if (Total != 0)
+    {
+        CFE_EVS_SendEvent(ROVER_APP_EVLIMIT_SUMMARY_EID, CFE_EVS_EventType_INFORMATION,
+                          "rover app: %u events held back in %us, event:count%s", (unsigned int)Total,
+                          (unsigned int)ROVER_APP_EVLIMIT_SUMMARY_S, List);
+    }
+
+} /* End of RoverAppEvLimitSummary() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppEvLimitSuppressed() -- events held back since init                 */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+uint32 RoverAppEvLimitSuppressed(void)
+{
+    uint32 Total = 0;
+    uint32 i;
+
+    for (i = 0; i < ROVER_APP_EVLIMIT_IDS; i++)
+    {
+        Total += __atomic_load_n(&RoverAppEvLimitData.Suppressed[i], __ATOMIC_RELAXED);
+    }
+
+    return Total;
+
+} /* End of RoverAppEvLimitSuppressed() */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -0,0 +1,82 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_evlimit.h
+**
+** Purpose:
+**   Per event ID rate limit in front of EVS.  Events are sent through
+**   ROVER_APP_EVENT(), which drops an event over its limit before its
+**   arguments are evaluated or its text formatted, and counts it.
+**
+** Notes:
+**   Each event ID is a token bucket of Burst events refilled at Rate
+**   events per second, kept as the time the bucket is full again so one
+**   compare-and-swap takes a token from any task.  Limits come from the
+**   table for every ID (see rover_app_params.h), and
+**   ROVER_APP_SET_EVENT_LIMIT_CC changes them per ID; both run on the
+**   command task and hand the limit over through a seqlock cell.
+**   RoverAppEvLimitSummary() reports what was held back, in an event that
+**   is not limited itself.
+**
+*******************************************************************************/
+#ifndef _rover_app_evlimit_h_
+#define _rover_app_evlimit_h_
+
+#include "cfe.h"
+
+#include "rover_app_history.h"
+
+/*
+** CFE_EVS_SendEvent() for an event ID over its rate limit is skipped
+*/
+#define ROVER_APP_EVENT(EventId, EventType, ...)                    \
+    do                                                              \
+    {                                                               \
+        if (RoverAppEvLimitAllow(EventId))                          \
+        {                                                           \
+            CFE_EVS_SendEvent((EventId), (EventType), __VA_ARGS__); \
+        }                                                           \
+    } while (0)
+
+/*
+** Bucket of one event ID, in units of 2^-16 s
+*/
+typedef struct
+{
+    uint32 Interval; /* Between tokens, 0 for no limit */
+    uint32 Tau;      /* How far ahead of now the full time may be, (Burst - 1) * Interval */
+} RoverAppEvLimit_t;
+
+/*
+** Exported functions
+*/
+bool   RoverAppEvLimitMake(float Rate, uint16 Burst, RoverAppEvLimit_t *Limit);
+void   RoverAppEvLimitInit(const RoverAppEvLimit_t *Limit);
+void   RoverAppEvLimitConfig(const RoverAppEvLimit_t *Limit);
+int32  RoverAppEvLimitSet(uint16 EventId, float Rate, uint16 Burst);
+bool   RoverAppEvLimitAllow(uint16 EventId);
+void   RoverAppEvLimitSummary(RoverAppStamp_t Now);
+uint32 RoverAppEvLimitSuppressed(void);
+
+#endif /* _rover_app_evlimit_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -0,0 +1,268 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_fleet.c
+**
+** Purpose:
+**   Multi-rover mode for the rover app.
+**
+** Notes:
+**   Headings are kept as unit vectors (C, S) = (cos yaw, sin yaw) and
+**   turned each tick by the small angle w dt, then brought back to unit
+**   length with one Newton step, so the per tick pass has no trig calls,
+**   no divisions and no branches.  Vehicles not heard from are zero and
+**   ride along in the pass rather than being skipped.
+**
+*******************************************************************************/
+
+/*
+**   Include Files:
+*/
+#include "rover_app_events.h"
+#include "rover_app_evlimit.h"
+#include "rover_app_fleet.h"
+#include "rover_app_msgids.h"
+#include "rover_app_output.h"
+#include "rover_app_txbuf.h"
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#if ROVER_APP_FLEET_SIZE > 0
+
+#define ROVER_APP_FLEET_ALIGN __attribute__((aligned(64)))
+
+typedef struct
+{
+    /* One entry per vehicle */
+    float TargetV[ROVER_APP_FLEET_SIZE] ROVER_APP_FLEET_ALIGN; /* Commanded twist */
+    float TargetW[ROVER_APP_FLEET_SIZE] ROVER_APP_FLEET_ALIGN;
+    float V[ROVER_APP_FLEET_SIZE] ROVER_APP_FLEET_ALIGN; /* Twist sent, within the acceleration limits */
+    float W[ROVER_APP_FLEET_SIZE] ROVER_APP_FLEET_ALIGN;
+    float X[ROVER_APP_FLEET_SIZE] ROVER_APP_FLEET_ALIGN; /* Pose dead reckoned from the last odometry */
+    float Y[ROVER_APP_FLEET_SIZE] ROVER_APP_FLEET_ALIGN;
+    float C[ROVER_APP_FLEET_SIZE] ROVER_APP_FLEET_ALIGN;
+    float S[ROVER_APP_FLEET_SIZE] ROVER_APP_FLEET_ALIGN;
+    bool  Active[ROVER_APP_FLEET_SIZE];
+
+    uint32          ActiveCount;
+    float           AccelMax; /* FLT_MAX for no limit */
+    float           AngularAccelMax;
+    RoverAppStamp_t LastStamp; /* 0 before the first tick */
+    uint32          TickCount;
+
+    RoverAppFleetTwistTlm_t TwistTlm;
+    RoverAppFleetStateTlm_t StateTlm;
+} RoverAppFleetData_t;
+
+static RoverAppFleetData_t RoverAppFleetData;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppFleetInit() -- no vehicles heard from yet                          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppFleetInit(const RoverAppParams_t *Params)
+{
+    uint32 i;
+
+    memset(&RoverAppFleetData, 0, sizeof(RoverAppFleetData));
+    for (i = 0; i < ROVER_APP_FLEET_SIZE; i++)
+    {
+        RoverAppFleetData.C[i] = 1.0f;
+    }
+    RoverAppFleetConfig(Params);
+
+    CFE_MSG_Init(&RoverAppFleetData.TwistTlm.TlmHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_FLEET_TWIST_TLM_MID),
+                 sizeof(RoverAppFleetData.TwistTlm));
+    CFE_MSG_Init(&RoverAppFleetData.StateTlm.TlmHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_FLEET_STATE_TLM_MID),
+                 sizeof(RoverAppFleetData.StateTlm));
+
+} /* End of RoverAppFleetInit() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppFleetConfig() -- take the limits, control task only               */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppFleetConfig(const RoverAppParams_t *Params)
+{
+    RoverAppFleetData.AccelMax        = Params->FleetAccelMax;
+    RoverAppFleetData.AngularAccelMax = Params->FleetAngularAccelMax;
+
+} /* End of RoverAppFleetConfig() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppFleetHeard() -- count a vehicle in the first time it is heard from */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void RoverAppFleetHeard(uint32 Vehicle)
+{
+    if (!RoverAppFleetData.Active[Vehicle])
+    {
+        RoverAppFleetData.Active[Vehicle] = true;
+        RoverAppFleetData.ActiveCount++;
+
+        ROVER_APP_EVENT(ROVER_APP_FLEET_INF_EID, CFE_EVS_EventType_INFORMATION,
+                        "rover app: fleet vehicle %u joined, %u active", (unsigned int)Vehicle,
+                        (unsigned int)RoverAppFleetData.ActiveCount);
+    }
+
+} /* End of RoverAppFleetHeard() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppFleetSetTwist() -- new commanded twist for one vehicle             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppFleetSetTwist(uint32 Vehicle, const RoverAppTwist_t *Twist)
+{
+    RoverAppFleetHeard(Vehicle);
+
+    RoverAppFleetData.TargetV[Vehicle] = Twist->linear_x;
+    RoverAppFleetData.TargetW[Vehicle] = Twist->angular_z;
+    RoverAppFleetData.StateTlm.Payload.CmdCount[Vehicle]++;
+
+} /* End of RoverAppFleetSetTwist() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppFleetOdom() -- restart one vehicle's dead reckoning from odometry  */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppFleetOdom(uint32 Vehicle, const RoverAppPose_t *Pose)
+{
+    float C;
+    float S;
+    float Norm;
+
+    RoverAppFleetHeard(Vehicle);
+
+    /* Heading of the quaternion, unnormalized */
+    C    = 1.0f - (2.0f * ((Pose->qy * Pose->qy) + (Pose->qz * Pose->qz)));
+    S    = 2.0f * ((Pose->qw * Pose->qz) + (Pose->qx * Pose->qy));
+    Norm = sqrtf((C * C) + (S * S));
+
+    RoverAppFleetData.X[Vehicle] = Pose->x;
+    RoverAppFleetData.Y[Vehicle] = Pose->y;
+    RoverAppFleetData.C[Vehicle] = (Norm > 0.0f) ? C / Norm : 1.0f;
+    RoverAppFleetData.S[Vehicle] = (Norm > 0.0f) ? S / Norm : 0.0f;
+    RoverAppFleetData.StateTlm.Payload.OdomCount[Vehicle]++;
+
+} /* End of RoverAppFleetOdom() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppFleetTick() -- advance every vehicle and send their twists         */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppFleetTick(RoverAppStamp_t Now)
+{
+    RoverAppFleetData_t     *Data = &RoverAppFleetData;
+    RoverAppFleetTwistTlm_t *TwistTlm;
+    float                    dt;
+    float                    dV;
+    float                    dW;
+    float                    Step;
+    float                    C;
+    float                    S;
+    float                    k;
+    uint32                   i;
+
+    dt = (Data->LastStamp != 0 && Now > Data->LastStamp) ? RoverAppStampToSeconds((int64)(Now - Data->LastStamp))
+                                                         : 0.0f;
+    if (dt > (ROVER_APP_SHAPE_MAX_STEP_MS / 1000.0f))
+    {
+        dt = ROVER_APP_SHAPE_MAX_STEP_MS / 1000.0f;
+    }
+    Data->LastStamp = Now;
+
+    if (Data->ActiveCount == 0)
+    {
+        return;
+    }
+
+    dV = (Data->AccelMax < FLT_MAX) ? Data->AccelMax * dt : FLT_MAX;
+    dW = (Data->AngularAccelMax < FLT_MAX) ? Data->AngularAccelMax * dt : FLT_MAX;
+
+    /*
+    ** One pass over all vehicles: the twist ramps toward the command, the
+    ** pose moves with it
+    */
+    for (i = 0; i < ROVER_APP_FLEET_SIZE; i++)
+    {
+        Step       = Data->TargetV[i] - Data->V[i];
+        Step       = (Step > dV) ? dV : Step;
+        Step       = (Step < -dV) ? -dV : Step;
+        Data->V[i] = Data->V[i] + Step;
+
+        Step       = Data->TargetW[i] - Data->W[i];
+        Step       = (Step > dW) ? dW : Step;
+        Step       = (Step < -dW) ? -dW : Step;
+        Data->W[i] = Data->W[i] + Step;
+
+        Data->X[i] = Data->X[i] + (Data->V[i] * Data->C[i] * dt);
+        Data->Y[i] = Data->Y[i] + (Data->V[i] * Data->S[i] * dt);
+
+        C          = Data->C[i] - (Data->S[i] * Data->W[i] * dt);
+        S          = Data->S[i] + (Data->C[i] * Data->W[i] * dt);
+        k          = 1.5f - (0.5f * ((C * C) + (S * S)));
+        Data->C[i] = C * k;
+        Data->S[i] = S * k;
+    }
+
+    /* Sent as often as its output policy asks, a buffer is only taken then */
+    memcpy(Data->TwistTlm.Payload.Linear, Data->V, sizeof(Data->TwistTlm.Payload.Linear));
+    memcpy(Data->TwistTlm.Payload.Angular, Data->W, sizeof(Data->TwistTlm.Payload.Angular));
+    if (RoverAppOutputDue(ROVER_APP_OUTPUT_FLEET_TWIST, &Data->TwistTlm.Payload, sizeof(Data->TwistTlm.Payload)))
+    {
+        TwistTlm = RoverAppTxBufGet(&Data->TwistTlm.TlmHeader, sizeof(Data->TwistTlm));
+        if (TwistTlm != &Data->TwistTlm)
+        {
+            TwistTlm->Payload = Data->TwistTlm.Payload;
+        }
+        RoverAppTxBufSend(TwistTlm, &Data->TwistTlm.TlmHeader);
+    }
+
+    if (++Data->TickCount >= ROVER_APP_FLEET_STATE_PERIOD)
+    {
+        Data->TickCount = 0;
+
+        Data->StateTlm.Payload.ActiveCount = Data->ActiveCount;
+        memcpy(Data->StateTlm.Payload.X, Data->X, sizeof(Data->StateTlm.Payload.X));
+        memcpy(Data->StateTlm.Payload.Y, Data->Y, sizeof(Data->StateTlm.Payload.Y));
+        for (i = 0; i < ROVER_APP_FLEET_SIZE; i++)
+        {
+            Data->StateTlm.Payload.Yaw[i] = atan2f(Data->S[i], Data->C[i]);
+        }
+
+        CFE_SB_TimeStampMsg(&Data->StateTlm.TlmHeader.Msg);
+        CFE_SB_TransmitMsg(&Data->StateTlm.TlmHeader.Msg, true);
+    }
+
+} /* End of RoverAppFleetTick() */
+
+#endif /* ROVER_APP_FLEET_SIZE > 0 */
+
+/************************/
+/*  End of File Comment */
+/************************/
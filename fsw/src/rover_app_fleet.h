@@ -0,0 +1,69 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_fleet.h
+**
+** Purpose:
+**   Multi-rover mode: ROVER_APP_FLEET_SIZE planar vehicles served by this
+**   app besides its own, vehicle i commanded on
+**   ROVER_APP_FLEET_CMD_MID_BASE + i and reporting odometry on
+**   ROVER_APP_FLEET_ODOM_MID_BASE + i.
+**
+** Notes:
+**   Both MID ranges are subscribed on the control pipe, so the fleet state
+**   is owned by the task that runs the HR tick and needs no locks.  The
+**   state is kept as one array per quantity and advanced for all vehicles
+**   in one branch-free pass per tick, which the compiler vectorizes.
+**   Fleet vehicles get the acceleration limits of RoverAppParams_t and
+**   dead reckoning on the shaped twist, but not trajectories, paths or
+**   jerk limiting.
+**
+*******************************************************************************/
+#ifndef _rover_app_fleet_h_
+#define _rover_app_fleet_h_
+
+#include "cfe.h"
+
+#include "rover_app_history.h"
+#include "rover_app_msg.h"
+#include "rover_app_params.h"
+
+#if ROVER_APP_FLEET_SIZE > 0
+
+#if ROVER_APP_FLEET_SIZE > 64
+#error ROVER_APP_FLEET_SIZE larger than the fleet MID ranges in rover_app_msgids.h
+#endif
+
+/*
+** Exported functions
+*/
+void RoverAppFleetInit(const RoverAppParams_t *Params);
+void RoverAppFleetConfig(const RoverAppParams_t *Params);
+void RoverAppFleetSetTwist(uint32 Vehicle, const RoverAppTwist_t *Twist);
+void RoverAppFleetOdom(uint32 Vehicle, const RoverAppPose_t *Pose);
+void RoverAppFleetTick(RoverAppStamp_t Now);
+
+#endif /* ROVER_APP_FLEET_SIZE > 0 */
+
+#endif /* _rover_app_fleet_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
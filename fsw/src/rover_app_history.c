@@ -0,0 +1,388 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_history.c
+**
+** Purpose:
+**   Timestamped odometry history for the rover app.
+**
+** Notes:
+**   Quaternions follow the ROS (x, y, z, w) layout and Hamilton product.
+**
+*******************************************************************************/
+
+/*
+** Include Files:
+*/
+#include "rover_app_history.h"
+
+#include <math.h>
+#include <string.h>
+
+#define ROVER_APP_ODOM_HISTORY_MASK (ROVER_APP_ODOM_HISTORY_SIZE - 1)
+
+/* Extrapolation horizon in stamp units */
+#define ROVER_APP_ODOM_EXTRAPOLATE_LIMIT \
+    ((((RoverAppStamp_t)ROVER_APP_ODOM_EXTRAPOLATE_MS) << 32) / 1000)
+
+/* Backward jump that restarts the history, in stamp units */
+#define ROVER_APP_ODOM_RESEED_LIMIT ((((RoverAppStamp_t)ROVER_APP_ODOM_RESEED_MS) << 32) / 1000)
+
+/* Below this angle slerp falls back to a normalized lerp */
+#define ROVER_APP_SLERP_LINEAR_DOT 0.9995f
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppQuatNormalize() -- scale to unit length, zero stays zero           */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void RoverAppQuatNormalize(RoverAppPose_t *Pose)
+{
+    float Norm = sqrtf((Pose->qx * Pose->qx) + (Pose->qy * Pose->qy) + (Pose->qz * Pose->qz) + (Pose->qw * Pose->qw));
+
+    if (Norm > 1e-6f)
+    {
+        Pose->qx /= Norm;
+        Pose->qy /= Norm;
+        Pose->qz /= Norm;
+        Pose->qw /= Norm;
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppOdomHistoryInit() -- empty the history                             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppOdomHistoryInit(RoverAppOdomHistory_t *Hist)
+{
+    memset(Hist, 0, sizeof(*Hist));
+
+} /* End of RoverAppOdomHistoryInit() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppOdomHistoryInsert() -- append a sample, overwriting the oldest     */
+/*                                                                            */
+/*   A sample at or before the newest one is rejected, unless it is older     */
+/*   by more than ROVER_APP_ODOM_RESEED_MS: the source has jumped back, and   */
+/*   the history restarts at that sample.  The counters are read by HK.       */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppOdomHistoryInsert(RoverAppOdomHistory_t *Hist, RoverAppStamp_t Stamp, const RoverAppOdometry_t *Odom)
+{
+    RoverAppStamp_t Newest;
+    int32           Result = ROVER_APP_HISTORY_APPENDED;
+
+    if (Hist->Count > 0)
+    {
+        Newest = Hist->Stamp[(Hist->Head - 1) & ROVER_APP_ODOM_HISTORY_MASK];
+
+        if (Stamp + ROVER_APP_ODOM_RESEED_LIMIT < Newest)
+        {
+            Hist->Head  = 0;
+            Hist->Count = 0;
+            __atomic_store_n(&Hist->ReseedCount, Hist->ReseedCount + 1, __ATOMIC_RELAXED);
+            Result = ROVER_APP_HISTORY_RESEEDED;
+        }
+        else if (Stamp <= Newest)
+        {
+            __atomic_store_n(&Hist->RejectedCount, Hist->RejectedCount + 1, __ATOMIC_RELAXED);
+            return ROVER_APP_HISTORY_REJECTED;
+        }
+    }
+
+    Hist->Stamp[Hist->Head] = Stamp;
+    Hist->Odom[Hist->Head]  = *Odom;
+    Hist->Head              = (Hist->Head + 1) & ROVER_APP_ODOM_HISTORY_MASK;
+
+    if (Hist->Count < ROVER_APP_ODOM_HISTORY_SIZE)
+    {
+        Hist->Count++;
+    }
+
+    return Result;
+
+} /* End of RoverAppOdomHistoryInsert() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppOdomHistoryEval() -- rover state at Stamp                          */
+/*                                                                            */
+/*   Interpolates between the samples around Stamp, extrapolates the newest  */
+/*   sample at constant velocity for up to ROVER_APP_ODOM_EXTRAPOLATE_MS,    */
+/*   and holds the nearest sample beyond that or before the oldest one.      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppOdomHistoryEval(const RoverAppOdomHistory_t *Hist, RoverAppStamp_t Stamp, RoverAppOdometry_t *Odom)
+{
+    const RoverAppOdometry_t *A;
+    const RoverAppOdometry_t *B;
+    RoverAppStamp_t           Age;
+    uint32                    Oldest;
+    uint32                    Newest;
+    uint32                    Lo;
+    uint32                    Hi;
+    uint32                    Mid;
+    float                     t;
+
+    if (Hist->Count == 0)
+    {
+        return ROVER_APP_HISTORY_EMPTY;
+    }
+
+    Oldest = (Hist->Head - Hist->Count) & ROVER_APP_ODOM_HISTORY_MASK;
+    Newest = (Hist->Head - 1) & ROVER_APP_ODOM_HISTORY_MASK;
+
+    if (Stamp >= Hist->Stamp[Newest])
+    {
+        Age   = Stamp - Hist->Stamp[Newest];
+        *Odom = Hist->Odom[Newest];
+
+        if (Age > ROVER_APP_ODOM_EXTRAPOLATE_LIMIT)
+        {
+            return ROVER_APP_HISTORY_HELD;
+        }
+
+        RoverAppPoseIntegrate(&Odom->pose, &Odom->twist, RoverAppStampToSeconds((int64)Age));
+        return ROVER_APP_HISTORY_EXTRAPOLATED;
+    }
+
+    if (Stamp < Hist->Stamp[Oldest])
+    {
+        *Odom = Hist->Odom[Oldest];
+        return ROVER_APP_HISTORY_HELD;
+    }
+
+    /*
+    ** Binary search on logical indexes: sample Lo is at or before Stamp,
+    ** sample Hi is after it
+    */
+    Lo = 0;
+    Hi = Hist->Count - 1;
+    while (Hi - Lo > 1)
+    {
+        Mid = Lo + ((Hi - Lo) / 2);
+        if (Hist->Stamp[(Oldest + Mid) & ROVER_APP_ODOM_HISTORY_MASK] <= Stamp)
+        {
+            Lo = Mid;
+        }
+        else
+        {
+            Hi = Mid;
+        }
+    }
+
+    Lo = (Oldest + Lo) & ROVER_APP_ODOM_HISTORY_MASK;
+    Hi = (Oldest + Hi) & ROVER_APP_ODOM_HISTORY_MASK;
+    A  = &Hist->Odom[Lo];
+    B  = &Hist->Odom[Hi];
+    t  = RoverAppStampToSeconds((int64)(Stamp - Hist->Stamp[Lo])) /
+        RoverAppStampToSeconds((int64)(Hist->Stamp[Hi] - Hist->Stamp[Lo]));
+
+    RoverAppPoseInterpolate(&A->pose, &B->pose, t, &Odom->pose);
+
+    Odom->twist.linear_x  = A->twist.linear_x + ((B->twist.linear_x - A->twist.linear_x) * t);
+    Odom->twist.linear_y  = A->twist.linear_y + ((B->twist.linear_y - A->twist.linear_y) * t);
+    Odom->twist.linear_z  = A->twist.linear_z + ((B->twist.linear_z - A->twist.linear_z) * t);
+    Odom->twist.angular_x = A->twist.angular_x + ((B->twist.angular_x - A->twist.angular_x) * t);
+    Odom->twist.angular_y = A->twist.angular_y + ((B->twist.angular_y - A->twist.angular_y) * t);
+    Odom->twist.angular_z = A->twist.angular_z + ((B->twist.angular_z - A->twist.angular_z) * t);
+
+    return ROVER_APP_HISTORY_INTERPOLATED;
+
+} /* End of RoverAppOdomHistoryEval() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppDeadReckonStep() -- advance the dead-reckoned state to Now         */
+/*                                                                            */
+/*   Re-anchors on the history after fresh odometry (or before the first    */
+/*   step), otherwise integrates Twist, or the last measured twist when     */
+/*   Twist is NULL, over the time since the previous step.  Returns false   */
+/*   while there is nothing to anchor on; Odom is untouched then.           */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+bool RoverAppDeadReckonStep(RoverAppDeadReckon_t *Dr, const RoverAppOdomHistory_t *Hist, const RoverAppTwist_t *Twist,
+                            RoverAppStamp_t Now, RoverAppOdometry_t *Odom)
+{
+    if (!Dr->Anchored || Dr->Reanchor)
+    {
+        if (RoverAppOdomHistoryEval(Hist, Now, &Dr->State) == ROVER_APP_HISTORY_EMPTY)
+        {
+            return false;
+        }
+
+        Dr->Anchored = true;
+        Dr->Reanchor = false;
+    }
+    else if (Now > Dr->Stamp)
+    {
+        RoverAppPoseIntegrate(&Dr->State.pose, (Twist != NULL) ? Twist : &Dr->State.twist,
+                              RoverAppStampToSeconds((int64)(Now - Dr->Stamp)));
+    }
+
+    Dr->Stamp = Now;
+    *Odom     = Dr->State;
+
+    return true;
+
+} /* End of RoverAppDeadReckonStep() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppPoseInterpolate() -- lerp position, slerp orientation, t in [0,1]  */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppPoseInterpolate(const RoverAppPose_t *A, const RoverAppPose_t *B, float t, RoverAppPose_t *Out)
+{
+    float bx = B->qx;
+    float by = B->qy;
+    float bz = B->qz;
+    float bw = B->qw;
+    float Dot;
+    float Theta;
+    float SinTheta;
+    float wa;
+    float wb;
+
+    Out->x = A->x + ((B->x - A->x) * t);
+    Out->y = A->y + ((B->y - A->y) * t);
+    Out->z = A->z + ((B->z - A->z) * t);
+
+    /* Take the short way around */
+    Dot = (A->qx * bx) + (A->qy * by) + (A->qz * bz) + (A->qw * bw);
+    if (Dot < 0.0f)
+    {
+        Dot = -Dot;
+        bx  = -bx;
+        by  = -by;
+        bz  = -bz;
+        bw  = -bw;
+    }
+
+    if (Dot > ROVER_APP_SLERP_LINEAR_DOT)
+    {
+        wa = 1.0f - t;
+        wb = t;
+    }
+    else
+    {
+        Theta    = acosf(Dot);
+        SinTheta = sinf(Theta);
+        wa       = sinf((1.0f - t) * Theta) / SinTheta;
+        wb       = sinf(t * Theta) / SinTheta;
+    }
+
+    Out->qx = (wa * A->qx) + (wb * bx);
+    Out->qy = (wa * A->qy) + (wb * by);
+    Out->qz = (wa * A->qz) + (wb * bz);
+    Out->qw = (wa * A->qw) + (wb * bw);
+
+    RoverAppQuatNormalize(Out);
+
+} /* End of RoverAppPoseInterpolate() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppPoseIntegrate() -- advance a pose by a body-frame twist over dt    */
+/*                                                                            */
+/*   The orientation is rotated by the exact exponential of the body rates;  */
+/*   the position moves along the linear velocity rotated by the midpoint    */
+/*   orientation, which follows constant-curvature arcs closely.             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppPoseIntegrate(RoverAppPose_t *Pose, const RoverAppTwist_t *Twist, float dt)
+{
+    float Rate = sqrtf((Twist->angular_x * Twist->angular_x) + (Twist->angular_y * Twist->angular_y) +
+                       (Twist->angular_z * Twist->angular_z));
+    float Half;
+    float Scale;
+    float dx;
+    float dy;
+    float dz;
+    float dw;
+    float qx;
+    float qy;
+    float qz;
+    float qw;
+    float cx;
+    float cy;
+    float cz;
+    float ccx;
+    float ccy;
+    float ccz;
+
+    /*
+    ** Midpoint orientation, q * exp(w dt / 4)
+    */
+    Half  = 0.25f * Rate * dt;
+    Scale = (Rate > 1e-6f) ? (sinf(Half) / Rate) : (0.25f * dt);
+    dx    = Twist->angular_x * Scale;
+    dy    = Twist->angular_y * Scale;
+    dz    = Twist->angular_z * Scale;
+    dw    = cosf(Half);
+
+    qw = (Pose->qw * dw) - (Pose->qx * dx) - (Pose->qy * dy) - (Pose->qz * dz);
+    qx = (Pose->qw * dx) + (Pose->qx * dw) + (Pose->qy * dz) - (Pose->qz * dy);
+    qy = (Pose->qw * dy) - (Pose->qx * dz) + (Pose->qy * dw) + (Pose->qz * dx);
+    qz = (Pose->qw * dz) + (Pose->qx * dy) - (Pose->qy * dx) + (Pose->qz * dw);
+
+    /*
+    ** v' = v + 2 w (u x v) + 2 u x (u x v), u = (qx, qy, qz)
+    */
+    cx  = (qy * Twist->linear_z) - (qz * Twist->linear_y);
+    cy  = (qz * Twist->linear_x) - (qx * Twist->linear_z);
+    cz  = (qx * Twist->linear_y) - (qy * Twist->linear_x);
+    ccx = (qy * cz) - (qz * cy);
+    ccy = (qz * cx) - (qx * cz);
+    ccz = (qx * cy) - (qy * cx);
+
+    Pose->x += (Twist->linear_x + (2.0f * ((qw * cx) + ccx))) * dt;
+    Pose->y += (Twist->linear_y + (2.0f * ((qw * cy) + ccy))) * dt;
+    Pose->z += (Twist->linear_z + (2.0f * ((qw * cz) + ccz))) * dt;
+
+    /*
+    ** Full step, q * exp(w dt / 2)
+    */
+    Half  = 0.5f * Rate * dt;
+    Scale = (Rate > 1e-6f) ? (sinf(Half) / Rate) : (0.5f * dt);
+    dx    = Twist->angular_x * Scale;
+    dy    = Twist->angular_y * Scale;
+    dz    = Twist->angular_z * Scale;
+    dw    = cosf(Half);
+
+    qw = (Pose->qw * dw) - (Pose->qx * dx) - (Pose->qy * dy) - (Pose->qz * dz);
+    qx = (Pose->qw * dx) + (Pose->qx * dw) + (Pose->qy * dz) - (Pose->qz * dy);
+    qy = (Pose->qw * dy) - (Pose->qx * dz) + (Pose->qy * dw) + (Pose->qz * dx);
+    qz = (Pose->qw * dz) + (Pose->qx * dy) - (Pose->qy * dx) + (Pose->qz * dw);
+
+    Pose->qx = qx;
+    Pose->qy = qy;
+    Pose->qz = qz;
+    Pose->qw = qw;
+
+    RoverAppQuatNormalize(Pose);
+
+} /* End of RoverAppPoseIntegrate() */
+
+/************************/
+/*  End of File Comment */
+/************************/
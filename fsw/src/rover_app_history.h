@@ -0,0 +1,121 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_history.h
+**
+** Purpose:
+**   Timestamped odometry history and evaluation of the rover state at an
+**   arbitrary time (interpolation between samples, constant velocity
+**   extrapolation past the newest one), and the dead-reckoning stage that
+**   carries the state forward tick by tick between odometry updates.
+**
+** Notes:
+**   Stamps and samples are kept in separate arrays so the binary search
+**   only walks the stamps.  Samples must arrive in time order; older ones
+**   are rejected, unless they are older by more than
+**   ROVER_APP_ODOM_RESEED_MS, which restarts the history at that sample.
+**   Twists are in the body frame, as in nav_msgs/Odometry.
+**
+*******************************************************************************/
+#ifndef _rover_app_history_h_
+#define _rover_app_history_h_
+
+#include "cfe.h"
+
+#include "rover_app_msg.h"
+#include "rover_app_platform_cfg.h"
+
+#if (ROVER_APP_ODOM_HISTORY_SIZE & (ROVER_APP_ODOM_HISTORY_SIZE - 1)) != 0
+#error ROVER_APP_ODOM_HISTORY_SIZE must be a power of two
+#endif
+
+/*
+** RoverAppOdomHistoryEval() results
+*/
+#define ROVER_APP_HISTORY_EMPTY        0 /* No samples, output untouched */
+#define ROVER_APP_HISTORY_INTERPOLATED 1
+#define ROVER_APP_HISTORY_EXTRAPOLATED 2
+#define ROVER_APP_HISTORY_HELD         3 /* Outside the usable range, nearest sample held */
+
+/*
+** RoverAppOdomHistoryInsert() results
+*/
+#define ROVER_APP_HISTORY_REJECTED 0 /* Not newer than the newest sample */
+#define ROVER_APP_HISTORY_APPENDED 1
+#define ROVER_APP_HISTORY_RESEEDED 2 /* Jumped back, history restarted at this sample */
+
+/*
+** Dead-reckoning modes, see ROVER_APP_DEAD_RECKON_MODE
+*/
+#define ROVER_APP_DEAD_RECKON_OFF       0 /* Evaluate the history every tick */
+#define ROVER_APP_DEAD_RECKON_MEASURED  1 /* Integrate the last measured twist */
+#define ROVER_APP_DEAD_RECKON_COMMANDED 2 /* Integrate the commanded twist */
+
+/* Time stamp: CFE_TIME_SysTime_t as one number, in 2^-32 s */
+typedef uint64 RoverAppStamp_t;
+
+typedef struct
+{
+    uint32             Head;  /* Next slot written */
+    uint32             Count;
+    uint32             RejectedCount; /* Samples older than the newest one */
+    uint32             ReseedCount;   /* Restarts on a backward jump */
+    RoverAppStamp_t    Stamp[ROVER_APP_ODOM_HISTORY_SIZE];
+    RoverAppOdometry_t Odom[ROVER_APP_ODOM_HISTORY_SIZE];
+} RoverAppOdomHistory_t;
+
+typedef struct
+{
+    bool               Anchored;
+    bool               Reanchor; /* Set by the odometry handler after an insert */
+    RoverAppStamp_t    Stamp;    /* Time State refers to */
+    RoverAppOdometry_t State;
+} RoverAppDeadReckon_t;
+
+static inline RoverAppStamp_t RoverAppTimeToStamp(CFE_TIME_SysTime_t Time)
+{
+    return ((RoverAppStamp_t)Time.Seconds << 32) | Time.Subseconds;
+}
+
+static inline float RoverAppStampToSeconds(int64 Delta)
+{
+    return (float)((double)Delta * (1.0 / 4294967296.0));
+}
+
+static inline uint64 RoverAppStampToNs(RoverAppStamp_t Delta)
+{
+    return ((Delta >> 32) * 1000000000ULL) + (((Delta & 0xFFFFFFFFULL) * 1000000000ULL) >> 32);
+}
+
+void  RoverAppOdomHistoryInit(RoverAppOdomHistory_t *Hist);
+int32 RoverAppOdomHistoryInsert(RoverAppOdomHistory_t *Hist, RoverAppStamp_t Stamp, const RoverAppOdometry_t *Odom);
+int32 RoverAppOdomHistoryEval(const RoverAppOdomHistory_t *Hist, RoverAppStamp_t Stamp, RoverAppOdometry_t *Odom);
+
+bool RoverAppDeadReckonStep(RoverAppDeadReckon_t *Dr, const RoverAppOdomHistory_t *Hist, const RoverAppTwist_t *Twist,
+                            RoverAppStamp_t Now, RoverAppOdometry_t *Odom);
+
+void RoverAppPoseInterpolate(const RoverAppPose_t *A, const RoverAppPose_t *B, float t, RoverAppPose_t *Out);
+void RoverAppPoseIntegrate(RoverAppPose_t *Pose, const RoverAppTwist_t *Twist, float dt);
+
+#endif /* _rover_app_history_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -30,11 +30,39 @@
 #ifndef _rover_app_msg_h_
 #define _rover_app_msg_h_
 
+#include "rover_app_platform_cfg.h"
+
 /**
  * RoverApp command codes
  */
 #define ROVER_APP_NOOP_CC        0
 #define ROVER_APP_SET_TWIST_CC   1
+#define ROVER_APP_TRACE_DUMP_CC  2
+#define ROVER_APP_RESET_DIAG_CC  3
+#define ROVER_APP_SEND_STATS_CC  4
+#define ROVER_APP_TRAJ_LOAD_CC   5
+#define ROVER_APP_TRAJ_START_CC  6
+#define ROVER_APP_TRAJ_STOP_CC   7
+#define ROVER_APP_PATH_LOAD_CC   8
+#define ROVER_APP_PATH_START_CC  9
+#define ROVER_APP_PATH_STOP_CC   10
+#define ROVER_APP_SET_OUTPUT_CC  11
+#define ROVER_APP_SET_EVENT_LIMIT_CC 12
+#define ROVER_APP_RECORD_START_CC    13
+#define ROVER_APP_RECORD_STOP_CC     14
+#define ROVER_APP_BLACKBOX_DUMP_CC   15
+
+/**
+ * Fleet vehicle command codes, on ROVER_APP_FLEET_CMD_MID_BASE + vehicle
+ */
+#define ROVER_APP_FLEET_SET_TWIST_CC 0
+
+/**
+ * Command scheduler command codes, on ROVER_APP_SCHED_CMD_MID
+ */
+#define ROVER_APP_SCHED_INSERT_CC 0
+#define ROVER_APP_SCHED_LIST_CC   1
+#define ROVER_APP_SCHED_FLUSH_CC  2
 
 /*************************************************************************/
 
@@ -82,6 +110,144 @@ typedef struct
    RoverAppTwist_t twist;
 } RoverAppTwistCmd_t;
 
+typedef struct
+{
+   CFE_MSG_CommandHeader_t CmdHeader;
+   char Filename[CFE_MISSION_MAX_PATH_LEN]; /**< Empty selects the default trace file **/
+} RoverAppTraceDumpCmd_t;
+
+/*
+** Trajectory upload: knots go into a staging area in order, a few per
+** command, and ROVER_APP_TRAJ_START_CC turns them into a trajectory
+*/
+#define ROVER_APP_TRAJ_KNOTS_PER_CMD 16
+
+typedef struct
+{
+   uint32 TimeMs; /**< Since the start of the trajectory, strictly increasing **/
+   RoverAppTwist_t twist;
+} RoverAppTrajKnot_t;
+
+typedef struct
+{
+   CFE_MSG_CommandHeader_t CmdHeader;
+   uint16 FirstKnot;  /**< 0 begins a new upload, otherwise the number of knots staged so far **/
+   uint16 KnotCount;  /**< Knots used in Knot[] **/
+   RoverAppTrajKnot_t Knot[ROVER_APP_TRAJ_KNOTS_PER_CMD];
+} RoverAppTrajLoadCmd_t;
+
+typedef struct
+{
+   CFE_MSG_CommandHeader_t CmdHeader;
+   uint32 StartSeconds;    /**< CFE time of the first knot, 0/0 for the next HR tick **/
+   uint32 StartSubseconds;
+} RoverAppTrajStartCmd_t;
+
+/*
+** Path upload: waypoints go into a staging area in order, a few per
+** command, and ROVER_APP_PATH_START_CC starts following them
+*/
+#define ROVER_APP_PATH_POINTS_PER_CMD 32
+
+typedef struct
+{
+   float x; /**< m, in the odometry frame **/
+   float y;
+} RoverAppPathPoint_t;
+
+typedef struct
+{
+   CFE_MSG_CommandHeader_t CmdHeader;
+   uint32 FirstPoint;  /**< 0 begins a new upload, otherwise the number of points staged so far **/
+   uint16 PointCount;  /**< Points used in Point[] **/
+   uint16 Spare;
+   RoverAppPathPoint_t Point[ROVER_APP_PATH_POINTS_PER_CMD];
+} RoverAppPathLoadCmd_t;
+
+typedef struct
+{
+   CFE_MSG_CommandHeader_t CmdHeader;
+   float Speed;     /**< m/s **/
+   float Lookahead; /**< m, 0 selects ROVER_APP_PATH_LOOKAHEAD **/
+} RoverAppPathStartCmd_t;
+
+/*
+** Time-tagged command: Cmd holds a complete command packet, whose own
+** header gives its length, to be sent on the software bus at the first
+** HR tick at or after the execution time
+*/
+#define ROVER_APP_SCHED_MAX_CMD_SIZE 64
+
+typedef struct
+{
+   CFE_MSG_CommandHeader_t CmdHeader;
+   uint32 ExecSeconds;
+   uint32 ExecSubseconds;
+   uint8  Cmd[ROVER_APP_SCHED_MAX_CMD_SIZE];
+} RoverAppSchedInsertCmd_t;
+
+/*
+** Telemetry output policy of one HR rate stream.  Every Period ticks the
+** stream is due; in ON_CHANGE mode it is only sent if some value moved
+** more than Deadband since the last packet.  With Heartbeat set, a packet
+** goes out at least every Heartbeat ticks whatever the mode.
+*/
+#define ROVER_APP_OUTPUT_TWIST       0 /**< ROVER_APP_TLM_TWIST_MID **/
+#define ROVER_APP_OUTPUT_FLEET_TWIST 1 /**< ROVER_APP_FLEET_TWIST_TLM_MID **/
+#define ROVER_APP_OUTPUT_STREAMS     2
+
+#define ROVER_APP_OUTPUT_PERIODIC  0
+#define ROVER_APP_OUTPUT_ON_CHANGE 1
+
+typedef struct
+{
+   uint8  Mode;      /**< ROVER_APP_OUTPUT_PERIODIC or ROVER_APP_OUTPUT_ON_CHANGE **/
+   uint8  Spare;
+   uint16 Period;    /**< HR ticks, at least 1 **/
+   uint16 Heartbeat; /**< HR ticks, 0 for no minimum rate **/
+   uint16 Spare2;
+   float  Deadband;  /**< Largest change of any value not sent, ON_CHANGE only **/
+} RoverAppOutputPolicy_t;
+
+typedef struct
+{
+   CFE_MSG_CommandHeader_t CmdHeader;
+   uint32 Stream; /**< ROVER_APP_OUTPUT_<stream> **/
+   RoverAppOutputPolicy_t Policy;
+} RoverAppSetOutputCmd_t;
+
+/*
+** Event rate limit: an event ID is sent at most Rate times a second on
+** average, with up to Burst back to back; the rest are counted and
+** reported in a summary event (see rover_app_evlimit.h)
+*/
+typedef struct
+{
+   CFE_MSG_CommandHeader_t CmdHeader;
+   uint16 EventId; /**< ROVER_APP_<name>_EID, 0 for all of them **/
+   uint16 Burst;   /**< At least 1 **/
+   float  Rate;    /**< Events per second, 0 for no limit **/
+} RoverAppSetEventLimitCmd_t;
+
+/*
+** Input recording (see rover_app_record.h); starting while recording
+** switches files
+*/
+typedef struct
+{
+   CFE_MSG_CommandHeader_t CmdHeader;
+   char Filename[CFE_MISSION_MAX_PATH_LEN]; /**< Empty selects the default recording file **/
+} RoverAppRecordStartCmd_t;
+
+/*
+** Flight recorder dump (see rover_app_blackbox.h)
+*/
+typedef struct
+{
+   CFE_MSG_CommandHeader_t CmdHeader;
+   char Filename[CFE_MISSION_MAX_PATH_LEN]; /**< Empty selects the default black box file **/
+} RoverAppBlackBoxDumpCmd_t;
+
 /*
 ** The following commands all share the "NoArgs" format
 **
@@ -90,6 +256,13 @@ typedef struct
 ** of the handler function
 */
 typedef RoverAppNoArgsCmd_t RoverAppNoopCmd_t;
+typedef RoverAppNoArgsCmd_t RoverAppResetDiagCmd_t;
+typedef RoverAppNoArgsCmd_t RoverAppSendStatsCmd_t;
+typedef RoverAppNoArgsCmd_t RoverAppTrajStopCmd_t;
+typedef RoverAppNoArgsCmd_t RoverAppPathStopCmd_t;
+typedef RoverAppNoArgsCmd_t RoverAppSchedListCmd_t;
+typedef RoverAppNoArgsCmd_t RoverAppSchedFlushCmd_t;
+typedef RoverAppNoArgsCmd_t RoverAppRecordStopCmd_t;
 //typedef RoverAppTwistCmd_t  RoverAppTwistStateCmd_t;
 
 /*************************************************************************/
@@ -99,6 +272,23 @@ typedef struct
     uint8 CommandErrorCounter;
     uint8 CommandCounter;
     RoverAppOdometry_t state;
+    uint32 CoalescedCount; /**< Odometry/twist messages superseded within a pipe batch **/
+    uint32 DroppedCount;   /**< Odometry messages lost upstream, from sequence count gaps **/
+    uint32 OutputSentCount[ROVER_APP_OUTPUT_STREAMS];       /**< HR rate packets sent, per stream **/
+    uint32 OutputSuppressedCount[ROVER_APP_OUTPUT_STREAMS]; /**< Held back by the output policy **/
+    uint32 TxZeroCopyCount; /**< HR rate packets sent from SB buffers **/
+    uint32 TxFallbackCount; /**< Copied by SB, no buffer to build them in **/
+    uint32 TxErrorCount;    /**< Lost, SB refused the buffer **/
+    uint32 EventSuppressedCount; /**< Events held back by their rate limit **/
+    uint32 RecordCount;          /**< Messages recorded **/
+    uint32 RecordDropCount;      /**< Not recorded, the record ring was full **/
+    uint32 BlackBoxDumpCount;    /**< Flight recorder dumps written **/
+    uint32 TableUpdateCount;     /**< Table updates handed to the control loop **/
+    uint32 TableRejectCount;     /**< Table images that failed validation **/
+    uint32 CdsSaveCount;         /**< Writes of the warm restart state to the CDS **/
+    uint32 OdomRejectedCount;    /**< Odometry samples not newer than the newest one **/
+    uint32 OdomReseedCount;      /**< Odometry history restarts on a backward time jump **/
+    uint32 StaleReadCount;       /**< Shared state reads that gave up, previous copy kept **/
 } RoverAppHkTlmPayload_t;
 
 typedef struct
@@ -107,6 +297,159 @@ typedef struct
     RoverAppHkTlmPayload_t Payload;   /**< \brief Telemetry payload */
 } RoverAppHkTlm_t;
 
+/*
+** Compact HK state for constrained links, sent after each HK packet: the
+** odometry quantized to int16 counts of the per field scales in
+** RoverAppTable_t, and the orientation as its three smallest quaternion
+** components (see rover_app_compact.h)
+*/
+#define ROVER_APP_COMPACT_FIELDS     9      /**< x y z, linear x y z, angular x y z **/
+#define ROVER_APP_COMPACT_QUAT_SHIFT 14     /**< Flags bits 14-15: quaternion component left out **/
+#define ROVER_APP_COMPACT_SAT_MASK   0x01FF /**< Flags bit n: field n was clamped to the int16 range **/
+
+typedef struct
+{
+    int16  Position[3]; /**< pose x, y, z **/
+    int16  Quat[3];     /**< The other three components, 32767 * sqrt(2) counts per unit **/
+    int16  Linear[3];
+    int16  Angular[3];
+    uint16 Flags;
+} RoverAppCompactState_t;
+
+typedef struct
+{
+    uint8                  CommandErrorCounter;
+    uint8                  CommandCounter;
+    uint16                 TableGeneration; /**< Low bits of the HK TableUpdateCount the scales came with **/
+    RoverAppCompactState_t State;
+} RoverAppCompactTlmPayload_t;
+
+typedef struct
+{
+    CFE_MSG_TelemetryHeader_t   TlmHeader; /**< \brief Telemetry header */
+    RoverAppCompactTlmPayload_t Payload;   /**< \brief Telemetry payload */
+} RoverAppCompactTlm_t;
+
+/*
+** State of consecutive HR ticks, sent once the table's BundleSamples are
+** in or its BundleTimeoutMs after the first; the packet is only as long
+** as Count samples (see rover_app_bundle.h)
+*/
+typedef struct
+{
+    uint32             OffsetUs; /**< Tick time since the first sample **/
+    RoverAppOdometry_t State;
+} RoverAppStateSample_t;
+
+typedef struct
+{
+    uint32                Seconds;    /**< Tick time of the first sample **/
+    uint32                Subseconds;
+    uint16                Count;
+    uint16                Spare;
+    RoverAppStateSample_t Sample[ROVER_APP_BUNDLE_MAX_SAMPLES];
+} RoverAppStateBundleTlmPayload_t;
+
+typedef struct
+{
+    CFE_MSG_TelemetryHeader_t       TlmHeader; /**< \brief Telemetry header */
+    RoverAppStateBundleTlmPayload_t Payload;   /**< \brief Telemetry payload */
+} RoverAppStateBundleTlm_t;
+
+
+/*
+** Control loop timing, sent with every HK packet
+*/
+typedef struct
+{
+    uint32 Count;
+    uint32 MinNs;
+    uint32 MaxNs;
+    uint32 MeanNs;
+    uint32 P50Ns;  /**< Percentiles are bucket upper bounds, within 12.5% **/
+    uint32 P99Ns;
+    uint32 P999Ns;
+} RoverAppDiagStats_t;
+
+typedef struct
+{
+    RoverAppDiagStats_t TickExec;   /**< HighRateControLoop execution time **/
+    RoverAppDiagStats_t TickPeriod; /**< Time between HR wakeups **/
+    RoverAppDiagStats_t OdomExec;   /**< Odometry message processing time **/
+    RoverAppDiagStats_t SchedLate;  /**< Time-tagged command release after its execution time **/
+} RoverAppDiagTlmPayload_t;
+
+typedef struct
+{
+    CFE_MSG_TelemetryHeader_t TlmHeader; /**< \brief Telemetry header */
+    RoverAppDiagTlmPayload_t  Payload;   /**< \brief Telemetry payload */
+} RoverAppDiagTlm_t;
+
+
+/*
+** Per message ID / command code traffic, sent on ROVER_APP_SEND_STATS_CC
+*/
+#define ROVER_APP_STATS_MAX_ENTRIES 32
+#define ROVER_APP_STATS_OTHER_MID   0xFFFF /**< Entry for codes without one of their own **/
+
+typedef struct
+{
+    uint16 MsgId;
+    uint8  FcnCode;
+    uint8  Spare;
+    uint32 MsgCount;    /**< Received, including messages later coalesced **/
+    uint32 ByteCount;
+    uint32 LenErrCount;
+    uint32 TotalUs;     /**< Cumulative processing time **/
+    uint32 MaxNs;       /**< Longest single processing time **/
+} RoverAppMsgStats_t;
+
+typedef struct
+{
+    uint32             EntryCount;
+    RoverAppMsgStats_t Entry[ROVER_APP_STATS_MAX_ENTRIES];
+} RoverAppStatsTlmPayload_t;
+
+typedef struct
+{
+    CFE_MSG_TelemetryHeader_t TlmHeader; /**< \brief Telemetry header */
+    RoverAppStatsTlmPayload_t Payload;   /**< \brief Telemetry payload */
+} RoverAppStatsTlm_t;
+
+
+/*
+** Command scheduler contents, sent on ROVER_APP_SCHED_LIST_CC
+*/
+#define ROVER_APP_SCHED_CAPACITY 32
+
+typedef struct
+{
+    uint32 ExecSeconds;
+    uint32 ExecSubseconds;
+    uint16 MsgId;
+    uint8  FcnCode;
+    uint8  Size;
+} RoverAppSchedEntry_t;
+
+typedef struct
+{
+    uint32               InsertCount;
+    uint32               RejectCount;    /**< Full, or a malformed command **/
+    uint32               ReleaseCount;
+    uint32               SendErrorCount; /**< Due commands the software bus refused, dropped **/
+    uint32               FlushCount;     /**< Commands removed by ROVER_APP_SCHED_FLUSH_CC **/
+    uint32               LateMaxNs;      /**< Worst release after execution time **/
+    uint32               LateMeanNs;
+    uint32               EntryCount;
+    RoverAppSchedEntry_t Entry[ROVER_APP_SCHED_CAPACITY]; /**< Pending, in execution order **/
+} RoverAppSchedTlmPayload_t;
+
+typedef struct
+{
+    CFE_MSG_TelemetryHeader_t TlmHeader; /**< \brief Telemetry header */
+    RoverAppSchedTlmPayload_t Payload;   /**< \brief Telemetry payload */
+} RoverAppSchedTlm_t;
+
 
 // These 2 messages are for communication with the robot on FSW side
 typedef struct
@@ -123,6 +466,42 @@ typedef struct
 
 } RoverAppCmdRobotState_t;
 
+#if ROVER_APP_FLEET_SIZE > 0
+/*
+** Multi-rover mode: the twist of every fleet vehicle, sent every HR tick
+** by default (ROVER_APP_OUTPUT_FLEET_TWIST), and their state, every
+** ROVER_APP_FLEET_STATE_PERIOD ticks.  Arrays are indexed by vehicle;
+** vehicles not heard from yet are all zero.
+*/
+typedef struct
+{
+    float Linear[ROVER_APP_FLEET_SIZE];  /**< linear_x, m/s **/
+    float Angular[ROVER_APP_FLEET_SIZE]; /**< angular_z, rad/s **/
+} RoverAppFleetTwistTlmPayload_t;
+
+typedef struct
+{
+    CFE_MSG_TelemetryHeader_t      TlmHeader; /**< \brief Telemetry header */
+    RoverAppFleetTwistTlmPayload_t Payload;   /**< \brief Telemetry payload */
+} RoverAppFleetTwistTlm_t;
+
+typedef struct
+{
+    uint32 ActiveCount; /**< Vehicles heard from **/
+    float  X[ROVER_APP_FLEET_SIZE];   /**< Dead reckoned from the last odometry **/
+    float  Y[ROVER_APP_FLEET_SIZE];
+    float  Yaw[ROVER_APP_FLEET_SIZE];
+    uint32 OdomCount[ROVER_APP_FLEET_SIZE];
+    uint32 CmdCount[ROVER_APP_FLEET_SIZE];
+} RoverAppFleetStateTlmPayload_t;
+
+typedef struct
+{
+    CFE_MSG_TelemetryHeader_t      TlmHeader; /**< \brief Telemetry header */
+    RoverAppFleetStateTlmPayload_t Payload;   /**< \brief Telemetry payload */
+} RoverAppFleetStateTlm_t;
+#endif
+
 
 #endif /* _rover_app_msg_h_ */
 
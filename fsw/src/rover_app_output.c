@@ -0,0 +1,215 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_output.c
+**
+** Purpose:
+**   Telemetry output policies for the rover app.
+**
+** Notes:
+**   RoverAppOutputSet() is the only writer of the policy cells and runs on
+**   the command task; everything else runs on the control task.  The
+**   counters are read for HK with relaxed loads.
+**
+*******************************************************************************/
+
+/*
+** Include Files:
+*/
+#include "rover_app_events.h"
+#include "rover_app_evlimit.h"
+#include "rover_app_output.h"
+#include "rover_app_seqlock.h"
+
+#include <math.h>
+#include <string.h>
+
+typedef struct
+{
+    uint32 Seq; /* Odd while a write is in progress */
+    union
+    {
+        RoverAppOutputPolicy_t Value;
+        uint32                 Words[ROVER_APP_SEQLOCK_WORDS(RoverAppOutputPolicy_t)];
+    } Data;
+} RoverAppOutputCell_t;
+
+typedef struct
+{
+    RoverAppOutputPolicy_t Policy;     /* In use, copied from Cell */
+    uint32                 PolicySeq;  /* Cell.Seq Policy was copied at */
+    uint32                 SinceDue;   /* Ticks since the stream was last due */
+    uint32                 SinceSent;  /* Ticks since the last packet */
+    bool                   Force;      /* Send on the next tick */
+    float                  Last[ROVER_APP_OUTPUT_MAX_VALUES]; /* Values of the last packet */
+
+    uint32 SentCount;
+    uint32 SuppressedCount;
+} RoverAppOutputStream_t;
+
+typedef struct
+{
+    RoverAppOutputCell_t   Cell[ROVER_APP_OUTPUT_STREAMS];
+    RoverAppOutputStream_t Stream[ROVER_APP_OUTPUT_STREAMS];
+} RoverAppOutputData_t;
+
+static RoverAppOutputData_t RoverAppOutputData;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppOutputInit() -- every stream on the default policy                 */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppOutputInit(void)
+{
+    RoverAppOutputStream_t *Stream;
+    uint32                  i;
+
+    memset(&RoverAppOutputData, 0, sizeof(RoverAppOutputData));
+
+    for (i = 0; i < ROVER_APP_OUTPUT_STREAMS; i++)
+    {
+        Stream                = &RoverAppOutputData.Stream[i];
+        Stream->Policy.Mode   = ROVER_APP_OUTPUT_PERIODIC;
+        Stream->Policy.Period = ROVER_APP_OUTPUT_PERIOD;
+        Stream->Force         = true;
+
+        RoverAppOutputData.Cell[i].Data.Value = Stream->Policy;
+    }
+
+} /* End of RoverAppOutputInit() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppOutputSet() -- check a policy and hand it to the control task      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppOutputSet(uint32 Stream, const RoverAppOutputPolicy_t *Policy)
+{
+    RoverAppOutputCell_t *Cell;
+
+    if (Stream >= ROVER_APP_OUTPUT_STREAMS ||
+        (Policy->Mode != ROVER_APP_OUTPUT_PERIODIC && Policy->Mode != ROVER_APP_OUTPUT_ON_CHANGE) ||
+        Policy->Period == 0 || !isfinite(Policy->Deadband) || Policy->Deadband < 0.0f)
+    {
+        ROVER_APP_EVENT(ROVER_APP_OUTPUT_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: bad output policy for stream %u: mode %u, period %u, deadband %.3f",
+                        (unsigned int)Stream, (unsigned int)Policy->Mode, (unsigned int)Policy->Period,
+                        (double)Policy->Deadband);
+        return CFE_STATUS_VALIDATION_FAILURE;
+    }
+
+    Cell = &RoverAppOutputData.Cell[Stream];
+    RoverAppSeqLockWrite(&Cell->Seq, Cell->Data.Words, Policy, ROVER_APP_SEQLOCK_WORDS(RoverAppOutputPolicy_t));
+
+    ROVER_APP_EVENT(ROVER_APP_OUTPUT_INF_EID, CFE_EVS_EventType_INFORMATION,
+                    "rover app: stream %u output %s every %u ticks, deadband %.3f, heartbeat %u ticks",
+                    (unsigned int)Stream, (Policy->Mode == ROVER_APP_OUTPUT_ON_CHANGE) ? "on change" : "periodic",
+                    (unsigned int)Policy->Period, (double)Policy->Deadband, (unsigned int)Policy->Heartbeat);
+
+    return CFE_SUCCESS;
+
+} /* End of RoverAppOutputSet() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppOutputDue() -- called once per HR tick, true if the packet holding */
+/*   Values (Size bytes of floats) is to be sent this tick                    */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+bool RoverAppOutputDue(uint32 Stream, const void *Values, size_t Size)
+{
+    RoverAppOutputStream_t     *Out  = &RoverAppOutputData.Stream[Stream];
+    const RoverAppOutputCell_t *Cell = &RoverAppOutputData.Cell[Stream];
+    uint32                      Count;
+    uint32                      Seq;
+    float                       Value;
+    float                       Change;
+    bool                        Send;
+    uint32                      i;
+
+    Count = (uint32)(Size / sizeof(float));
+    if (Count > ROVER_APP_OUTPUT_MAX_VALUES)
+    {
+        Count = ROVER_APP_OUTPUT_MAX_VALUES;
+    }
+
+    /* A new policy starts with a packet */
+    Seq = __atomic_load_n(&Cell->Seq, __ATOMIC_ACQUIRE);
+    if (Seq != Out->PolicySeq &&
+        RoverAppSeqLockRead(&Cell->Seq, Cell->Data.Words, &Out->Policy, ROVER_APP_SEQLOCK_WORDS(RoverAppOutputPolicy_t)))
+    {
+        Out->PolicySeq = Seq;
+        Out->Force     = true;
+    }
+
+    Out->SinceDue++;
+    Out->SinceSent++;
+
+    Send = Out->Force || (Out->Policy.Heartbeat != 0 && Out->SinceSent >= Out->Policy.Heartbeat);
+    if (!Send && Out->SinceDue >= Out->Policy.Period)
+    {
+        Out->SinceDue = 0;
+        Send          = (Out->Policy.Mode == ROVER_APP_OUTPUT_PERIODIC);
+
+        for (i = 0; i < Count && !Send; i++)
+        {
+            memcpy(&Value, (const uint8 *)Values + (i * sizeof(float)), sizeof(Value));
+            Change = fabsf(Value - Out->Last[i]);
+            Send   = !(Change <= Out->Policy.Deadband); /* NaN counts as a change */
+        }
+    }
+
+    if (!Send)
+    {
+        __atomic_store_n(&Out->SuppressedCount, Out->SuppressedCount + 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    memcpy(Out->Last, Values, Count * sizeof(float));
+    Out->Force     = false;
+    Out->SinceDue  = 0;
+    Out->SinceSent = 0;
+    __atomic_store_n(&Out->SentCount, Out->SentCount + 1, __ATOMIC_RELAXED);
+
+    return true;
+
+} /* End of RoverAppOutputDue() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppOutputCounts() -- packets sent and held back, per stream           */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppOutputCounts(uint32 *SentCount, uint32 *SuppressedCount)
+{
+    uint32 i;
+
+    for (i = 0; i < ROVER_APP_OUTPUT_STREAMS; i++)
+    {
+        SentCount[i]       = __atomic_load_n(&RoverAppOutputData.Stream[i].SentCount, __ATOMIC_RELAXED);
+        SuppressedCount[i] = __atomic_load_n(&RoverAppOutputData.Stream[i].SuppressedCount, __ATOMIC_RELAXED);
+    }
+
+} /* End of RoverAppOutputCounts() */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -0,0 +1,62 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_output.h
+**
+** Purpose:
+**   Output policies of the telemetry streams sent every HR tick: decimated,
+**   sent on change beyond a deadband, and with a heartbeat (see
+**   RoverAppOutputPolicy_t).
+**
+** Notes:
+**   Policies are set by ROVER_APP_SET_OUTPUT_CC on the command task and
+**   handed to the control task through a seqlock cell per stream; the
+**   control task picks up a new policy on the next tick and sends that
+**   tick's packet whatever the policy says.
+**
+*******************************************************************************/
+#ifndef _rover_app_output_h_
+#define _rover_app_output_h_
+
+#include "cfe.h"
+
+#include "rover_app_msg.h"
+#include "rover_app_platform_cfg.h"
+
+/* Most float values a stream's deadband compares */
+#if (2 * ROVER_APP_FLEET_SIZE) > 6
+#define ROVER_APP_OUTPUT_MAX_VALUES (2 * ROVER_APP_FLEET_SIZE)
+#else
+#define ROVER_APP_OUTPUT_MAX_VALUES 6
+#endif
+
+/*
+** Exported functions
+*/
+void  RoverAppOutputInit(void);
+int32 RoverAppOutputSet(uint32 Stream, const RoverAppOutputPolicy_t *Policy);
+bool  RoverAppOutputDue(uint32 Stream, const void *Values, size_t Size);
+void  RoverAppOutputCounts(uint32 *SentCount, uint32 *SuppressedCount);
+
+#endif /* _rover_app_output_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
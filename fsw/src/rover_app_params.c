@@ -0,0 +1,304 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_params.c
+**
+** Purpose:
+**   Table management for the rover app.
+**
+** Notes:
+**   The command task builds each update into the slot the control loop
+**   is not reading: the pending one if the control loop has not taken
+**   it, otherwise the other one of the last two handed over.  The
+**   control loop applies one update at a time, so it is done with a slot
+**   before the command task can come back to it.
+**
+*******************************************************************************/
+
+/*
+** Include Files:
+*/
+#include "rover_app_events.h"
+#include "rover_app.h"
+#include "rover_app_params.h"
+#include "rover_app_shape.h"
+#include "rover_app_bundle.h"
+#include "rover_app_fleet.h"
+#include "rover_app_compact.h"
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#define ROVER_APP_PARAMS_SLOTS 2
+
+typedef struct
+{
+    CFE_TBL_Handle_t TblHandle;
+
+    RoverAppParams_t  Slot[ROVER_APP_PARAMS_SLOTS];
+    RoverAppParams_t *Pending; /* Not taken by the control loop yet, NULL if none */
+    uint32            Last;    /* Slot handed over last, command task only */
+
+    uint32 UpdateCount;
+    uint32 RejectCount;
+} RoverAppParamsData_t;
+
+static RoverAppParamsData_t RoverAppParamsData;
+
+static const RoverAppTable_t RoverAppParamsDefaults = ROVER_APP_TABLE_DEFAULTS;
+
+extern RoverAppData_t RoverAppData;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppParamsInit() -- register and load the table, and derive the        */
+/*                         parameters the app starts with                     */
+/*                                                                            */
+/*   Without a table file the defaults are loaded in its place.               */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppParamsInit(RoverAppParams_t *Params)
+{
+    RoverAppTable_t *Table;
+    int32            status;
+
+    memset(&RoverAppParamsData, 0, sizeof(RoverAppParamsData));
+
+    status = CFE_TBL_Register(&RoverAppParamsData.TblHandle, ROVER_APP_TABLE_NAME, sizeof(RoverAppTable_t),
+                              CFE_TBL_OPT_DEFAULT, RoverAppParamsValidate);
+    if (status != CFE_SUCCESS)
+    {
+        CFE_ES_WriteToSysLog("Rover App: Error registering table, RC = 0x%08lX\n", (unsigned long)status);
+        return status;
+    }
+
+    status = CFE_TBL_Load(RoverAppParamsData.TblHandle, CFE_TBL_SRC_FILE, ROVER_APP_TABLE_FILE);
+    if (status != CFE_SUCCESS)
+    {
+        ROVER_APP_EVENT(ROVER_APP_TABLE_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: error loading table from %s, RC = 0x%08lX, using the defaults",
+                        ROVER_APP_TABLE_FILE, (unsigned long)status);
+
+        status = CFE_TBL_Load(RoverAppParamsData.TblHandle, CFE_TBL_SRC_ADDRESS, &RoverAppParamsDefaults);
+        if (status != CFE_SUCCESS)
+        {
+            CFE_ES_WriteToSysLog("Rover App: Error loading default table, RC = 0x%08lX\n", (unsigned long)status);
+            return status;
+        }
+    }
+
+    status = CFE_TBL_GetAddress((void **)&Table, RoverAppParamsData.TblHandle);
+    if (status != CFE_SUCCESS && status != CFE_TBL_INFO_UPDATED)
+    {
+        CFE_ES_WriteToSysLog("Rover App: Error getting table address, RC = 0x%08lX\n", (unsigned long)status);
+        return status;
+    }
+    status = RoverAppParamsMake(Table, Params);
+    CFE_TBL_ReleaseAddress(RoverAppParamsData.TblHandle);
+
+    return status;
+
+} /* End of RoverAppParamsInit() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppParamsMake() -- derive the parameters of a table                   */
+/*                                                                            */
+/*   Fails, with an event naming the first bad field, if a parameter          */
+/*   cannot be made from the table; Params is not usable then.                */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppParamsMake(const RoverAppTable_t *Table, RoverAppParams_t *Params)
+{
+    const float Limit[4] = {Table->LinearAccelMax, Table->LinearJerkMax, Table->AngularAccelMax,
+                            Table->AngularJerkMax};
+    const char *Bad      = NULL;
+    uint32      j;
+
+    for (j = 0; j < 4; j++)
+    {
+        if (Bad == NULL && !(isfinite(Limit[j]) && Limit[j] >= 0.0f))
+        {
+            Bad = "shaping limit";
+        }
+    }
+
+    RoverAppCompactScales(Table, Params->CompactScale);
+    for (j = 0; j < ROVER_APP_COMPACT_FIELDS; j++)
+    {
+        if (Bad == NULL && !(isfinite(Params->CompactScale[j]) && Params->CompactScale[j] > 0.0f))
+        {
+            Bad = "compact scale";
+        }
+    }
+
+    if (Bad == NULL && (Table->BundleSamples < 1 || Table->BundleSamples > ROVER_APP_BUNDLE_MAX_SAMPLES))
+    {
+        Bad = "bundle size";
+    }
+
+    if (Bad == NULL && !RoverAppEvLimitMake(Table->EventRate, Table->EventBurst, &Params->EventLimit))
+    {
+        Bad = "event limit";
+    }
+
+    if (Bad != NULL)
+    {
+        ROVER_APP_EVENT(ROVER_APP_TABLE_ERR_EID, CFE_EVS_EventType_ERROR, "rover app: table rejected, bad %s",
+                        Bad);
+        return CFE_STATUS_VALIDATION_FAILURE;
+    }
+
+    for (j = 0; j < ROVER_APP_PARAMS_AXES; j++)
+    {
+        Params->ShapeAccelMax[j] = (j < 3) ? Table->LinearAccelMax : Table->AngularAccelMax;
+        Params->ShapeJerkMax[j]  = (j < 3) ? Table->LinearJerkMax : Table->AngularJerkMax;
+    }
+
+    Params->FleetAccelMax        = (Table->LinearAccelMax > 0.0f) ? Table->LinearAccelMax : FLT_MAX;
+    Params->FleetAngularAccelMax = (Table->AngularAccelMax > 0.0f) ? Table->AngularAccelMax : FLT_MAX;
+
+    Params->BundleSamples = Table->BundleSamples;
+    Params->BundleTimeout = ((RoverAppStamp_t)Table->BundleTimeoutMs << 32) / 1000;
+
+    return CFE_SUCCESS;
+
+} /* End of RoverAppParamsMake() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppParamsValidate() -- Table Services validation function             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppParamsValidate(void *TblData)
+{
+    RoverAppParams_t Params;
+    int32            status;
+
+    status = RoverAppParamsMake((const RoverAppTable_t *)TblData, &Params);
+    if (status != CFE_SUCCESS)
+    {
+        RoverAppParamsData.RejectCount++;
+    }
+
+    return status;
+
+} /* End of RoverAppParamsValidate() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppParamsManage() -- let Table Services validate and update the       */
+/*                           table, and hand an update over; command task     */
+/*                           only                                             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppParamsManage(void)
+{
+    RoverAppParamsData_t *Data = &RoverAppParamsData;
+    RoverAppParams_t      Params;
+    RoverAppParams_t     *Slot;
+    RoverAppTable_t      *Table;
+    int32                 status;
+
+    CFE_TBL_Manage(Data->TblHandle);
+
+    status = CFE_TBL_GetAddress((void **)&Table, Data->TblHandle);
+    if (status == CFE_SUCCESS)
+    {
+        CFE_TBL_ReleaseAddress(Data->TblHandle);
+    }
+    if (status != CFE_TBL_INFO_UPDATED)
+    {
+        return;
+    }
+
+    status = RoverAppParamsMake(Table, &Params);
+    CFE_TBL_ReleaseAddress(Data->TblHandle);
+    if (status != CFE_SUCCESS)
+    {
+        return;
+    }
+
+    /* The command task's own users */
+    RoverAppEvLimitConfig(&Params.EventLimit);
+    memcpy(RoverAppData.CompactScale, Params.CompactScale, sizeof(RoverAppData.CompactScale));
+
+    /* The control loop's, in a slot it is not reading */
+    Slot = __atomic_exchange_n(&Data->Pending, NULL, __ATOMIC_ACQUIRE);
+    if (Slot == NULL)
+    {
+        Data->Last = (Data->Last + 1) % ROVER_APP_PARAMS_SLOTS;
+        Slot       = &Data->Slot[Data->Last];
+    }
+    *Slot = Params;
+    __atomic_store_n(&Data->Pending, Slot, __ATOMIC_RELEASE);
+
+    Data->UpdateCount++;
+    ROVER_APP_EVENT(ROVER_APP_TABLE_INF_EID, CFE_EVS_EventType_INFORMATION, "rover app: table updated");
+
+} /* End of RoverAppParamsManage() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppParamsSwap() -- apply an update handed over, control task only,    */
+/*                         between ticks                                      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppParamsSwap(void)
+{
+    RoverAppParams_t *Params;
+
+    if (__atomic_load_n(&RoverAppParamsData.Pending, __ATOMIC_RELAXED) == NULL)
+    {
+        return;
+    }
+
+    Params = __atomic_exchange_n(&RoverAppParamsData.Pending, NULL, __ATOMIC_ACQUIRE);
+    if (Params == NULL)
+    {
+        return;
+    }
+
+    RoverAppShapeConfig(Params);
+#if ROVER_APP_BUNDLE_ENABLE
+    RoverAppBundleConfig(Params);
+#endif
+#if ROVER_APP_FLEET_SIZE > 0
+    RoverAppFleetConfig(Params);
+#endif
+
+} /* End of RoverAppParamsSwap() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppParamsCounts() -- table updates handed over and rejected           */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppParamsCounts(uint32 *UpdateCount, uint32 *RejectCount)
+{
+    *UpdateCount = RoverAppParamsData.UpdateCount;
+    *RejectCount = RoverAppParamsData.RejectCount;
+
+} /* End of RoverAppParamsCounts() */
+
+/************************/
+/*  End of File Comment */
+/************************/
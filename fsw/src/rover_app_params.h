@@ -0,0 +1,87 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_params.h
+**
+** Purpose:
+**   RoverAppTable_t under cFE Table Services, and the parameters the app
+**   derives from it.  A table is checked and turned into a
+**   RoverAppParams_t once, when it is loaded, so the control loop only
+**   ever copies ready values.
+**
+** Notes:
+**   The command task manages the table on each HK request.  Validation
+**   is the derivation itself: a table is accepted if every parameter can
+**   be made from it.  An update is applied to the command task's own
+**   users (event limits, compact HK scales) at once, and handed to the
+**   control task in one of two slots with one atomic store.  The control
+**   loop takes it at the start of its next tick with one atomic exchange.
+**   An update that comes before the control loop took the previous one
+**   replaces it.
+**
+*******************************************************************************/
+#ifndef _rover_app_params_h_
+#define _rover_app_params_h_
+
+#include "cfe.h"
+
+#include "rover_app_evlimit.h"
+#include "rover_app_history.h"
+#include "rover_app_msg.h"
+#include "rover_app_table.h"
+
+#define ROVER_APP_PARAMS_AXES 6 /* Twist axes, linear x y z then angular x y z */
+
+typedef struct
+{
+    /* Twist shaping, 0 for no limit (see rover_app_shape.h) */
+    float ShapeAccelMax[ROVER_APP_PARAMS_AXES];
+    float ShapeJerkMax[ROVER_APP_PARAMS_AXES];
+
+    /* Fleet vehicles, FLT_MAX for no limit (see rover_app_fleet.h) */
+    float FleetAccelMax;
+    float FleetAngularAccelMax;
+
+    /* HR state bundles (see rover_app_bundle.h) */
+    uint32          BundleSamples; /* 1 to ROVER_APP_BUNDLE_MAX_SAMPLES */
+    RoverAppStamp_t BundleTimeout; /* 0 for full bundles only */
+
+    /* Compact HK quantization steps, in field order (see rover_app_compact.h) */
+    float CompactScale[ROVER_APP_COMPACT_FIELDS];
+
+    /* Every event ID (see rover_app_evlimit.h) */
+    RoverAppEvLimit_t EventLimit;
+} RoverAppParams_t;
+
+/*
+** Exported functions
+*/
+int32 RoverAppParamsInit(RoverAppParams_t *Params);
+int32 RoverAppParamsMake(const RoverAppTable_t *Table, RoverAppParams_t *Params);
+int32 RoverAppParamsValidate(void *TblData);
+void  RoverAppParamsManage(void);
+void  RoverAppParamsSwap(void);
+void  RoverAppParamsCounts(uint32 *UpdateCount, uint32 *RejectCount);
+
+#endif /* _rover_app_params_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
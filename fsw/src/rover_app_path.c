@@ -0,0 +1,646 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_path.c
+**
+** Purpose:
+**   Pure pursuit path following for the rover app.
+**
+** Notes:
+**   Each tick finds the point of the path nearest the rover, takes the
+**   point Lookahead further along it, and steers on the arc through that
+**   point.  The nearest segment comes from the grid: cells are searched
+**   in rings around the rover's cell until no unsearched cell can hold
+**   anything closer, a handful of cells whatever the length of the path.
+**   Only segments up to one lookahead past the current progress count,
+**   so the rover never jumps ahead where the path crosses itself.  The
+**   lookahead point is a binary search on the distances along the path.
+**
+*******************************************************************************/
+
+/*
+**   Include Files:
+*/
+#include "rover_app_events.h"
+#include "rover_app_evlimit.h"
+#include "rover_app_path.h"
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+typedef struct
+{
+    RoverAppPath_t Slot[ROVER_APP_PATH_SLOTS];
+
+    /* Command task */
+    uint8  Staging;     /* Slot the upload goes into */
+    uint32 StagedCount; /* Points in Slot[Staging] */
+    uint8  Active;      /* Slot the control loop runs, ROVER_APP_PATH_NONE when idle */
+    uint8  Started;     /* Slot of the last start, uploads go into the other */
+
+    /* Control task */
+    uint8  Acked;    /* Last Active the control loop picked up */
+    bool   Acquired; /* Progress is valid */
+    bool   Done;     /* End of the path reached, stopped there */
+    uint32 Progress; /* Segment the rover was nearest on the previous tick */
+} RoverAppPathData_t;
+
+static RoverAppPathData_t RoverAppPathData;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppPathInit() -- no path                                              */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppPathInit(void)
+{
+    RoverAppPathData.Staging     = 0;
+    RoverAppPathData.StagedCount = 0;
+    RoverAppPathData.Active      = ROVER_APP_PATH_NONE;
+    RoverAppPathData.Started     = ROVER_APP_PATH_NONE;
+    RoverAppPathData.Acked       = ROVER_APP_PATH_NONE;
+    RoverAppPathData.Acquired    = false;
+    RoverAppPathData.Done        = false;
+    RoverAppPathData.Progress    = 0;
+
+} /* End of RoverAppPathInit() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppPathCell() -- grid cell index along one axis, clamped to the grid  */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static inline uint32 RoverAppPathCell(float Offset, float CellSize, uint32 Cells)
+{
+    float c = floorf(Offset / CellSize);
+
+    if (c < 0.0f)
+    {
+        return 0;
+    }
+    if (c >= (float)Cells)
+    {
+        return Cells - 1;
+    }
+    return (uint32)c;
+
+} /* End of RoverAppPathCell() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppPathGrid() -- index the segments of Path with cells of CellSize    */
+/*                                                                            */
+/*   Returns false if the segments need more than ROVER_APP_PATH_GRID_ENTRIES */
+/*   references at this cell size.                                          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static bool RoverAppPathGrid(RoverAppPath_t *Path, float CellSize)
+{
+    uint32 Segments = Path->PointCount - 1;
+    uint32 Total    = 0;
+    uint32 k;
+    uint32 x0;
+    uint32 x1;
+    uint32 y0;
+    uint32 y1;
+    uint32 x;
+    uint32 y;
+    uint32 c;
+    uint32 Count;
+    uint32 Pass;
+
+    Path->CellSize = CellSize;
+    memset(Path->CellStart, 0, (Path->GridW * Path->GridH + 1) * sizeof(Path->CellStart[0]));
+
+    /*
+    ** Counting sort: count the segments in each cell, turn the counts into
+    ** start offsets, then fill.  A segment goes into every cell its
+    ** bounding box touches.
+    */
+    for (Pass = 0; Pass < 2; Pass++)
+    {
+        for (k = 0; k < Segments; k++)
+        {
+            x0 = RoverAppPathCell(fminf(Path->X[k], Path->X[k + 1]) - Path->OriginX, CellSize, Path->GridW);
+            x1 = RoverAppPathCell(fmaxf(Path->X[k], Path->X[k + 1]) - Path->OriginX, CellSize, Path->GridW);
+            y0 = RoverAppPathCell(fminf(Path->Y[k], Path->Y[k + 1]) - Path->OriginY, CellSize, Path->GridH);
+            y1 = RoverAppPathCell(fmaxf(Path->Y[k], Path->Y[k + 1]) - Path->OriginY, CellSize, Path->GridH);
+
+            if (Pass == 0)
+            {
+                Total += (x1 - x0 + 1) * (y1 - y0 + 1);
+                if (Total > ROVER_APP_PATH_GRID_ENTRIES)
+                {
+                    return false;
+                }
+            }
+
+            for (y = y0; y <= y1; y++)
+            {
+                for (x = x0; x <= x1; x++)
+                {
+                    c = (y * Path->GridW) + x;
+                    if (Pass == 0)
+                    {
+                        Path->CellStart[c + 1]++;
+                    }
+                    else
+                    {
+                        Path->CellSeg[Path->CellStart[c + 1]++] = k;
+                    }
+                }
+            }
+        }
+
+        if (Pass == 0)
+        {
+            /* CellStart[c + 1] becomes the start of c, advanced by the fill */
+            Total = 0;
+            for (c = 0; c < Path->GridW * Path->GridH; c++)
+            {
+                Count                 = Path->CellStart[c + 1];
+                Path->CellStart[c + 1] = Total;
+                Total += Count;
+            }
+        }
+    }
+
+    return true;
+
+} /* End of RoverAppPathGrid() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppPathBuild() -- distances along the path and the segment grid       */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void RoverAppPathBuild(RoverAppPath_t *Path)
+{
+    uint32 n = Path->PointCount;
+    float  MinX;
+    float  MaxX;
+    float  MinY;
+    float  MaxY;
+    float  Width;
+    float  Height;
+    float  CellSize;
+    uint32 k;
+
+    MinX = MaxX = Path->X[0];
+    MinY = MaxY = Path->Y[0];
+    Path->S[0]  = 0.0f;
+
+    for (k = 1; k < n; k++)
+    {
+        Path->S[k] = Path->S[k - 1] + hypotf(Path->X[k] - Path->X[k - 1], Path->Y[k] - Path->Y[k - 1]);
+        MinX       = fminf(MinX, Path->X[k]);
+        MaxX       = fmaxf(MaxX, Path->X[k]);
+        MinY       = fminf(MinY, Path->Y[k]);
+        MaxY       = fmaxf(MaxY, Path->Y[k]);
+    }
+
+    Width  = MaxX - MinX;
+    Height = MaxY - MinY;
+
+    /*
+    ** About one segment per cell: cells as long as the mean segment, or
+    ** bigger where the path is spread out thin
+    */
+    CellSize = fmaxf(Path->S[n - 1] / (float)(n - 1), sqrtf((Width * Height) / (float)(n - 1)));
+    CellSize = fmaxf(CellSize, 1e-3f);
+
+    Path->OriginX = MinX;
+    Path->OriginY = MinY;
+
+    for (;;)
+    {
+        Path->GridW = (uint32)(Width / CellSize) + 1;
+        Path->GridH = (uint32)(Height / CellSize) + 1;
+
+        if ((uint64)Path->GridW * Path->GridH <= ROVER_APP_PATH_GRID_CELLS && RoverAppPathGrid(Path, CellSize))
+        {
+            break;
+        }
+        CellSize *= 1.5f;
+    }
+
+} /* End of RoverAppPathBuild() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppPathLoad() -- stage waypoints, command task only                   */
+/*                                                                            */
+/*   The whole command is rejected if any of its points is bad; what was     */
+/*   staged before it is kept, so it can be sent again.                      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppPathLoad(const RoverAppPathLoadCmd_t *Cmd)
+{
+    RoverAppPath_t *Path;
+    uint32          Staged;
+    uint8           Active;
+    uint32          i;
+
+    Staged = (Cmd->FirstPoint == 0) ? 0 : RoverAppPathData.StagedCount;
+
+    if (Cmd->FirstPoint != Staged)
+    {
+        ROVER_APP_EVENT(ROVER_APP_PATH_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: path point %u out of order, %u staged", (unsigned int)Cmd->FirstPoint,
+                        (unsigned int)Staged);
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    if (Cmd->PointCount > ROVER_APP_PATH_POINTS_PER_CMD || Staged + Cmd->PointCount > ROVER_APP_PATH_MAX_POINTS)
+    {
+        ROVER_APP_EVENT(ROVER_APP_PATH_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: path too long, %u + %u points, max %u", (unsigned int)Staged,
+                        (unsigned int)Cmd->PointCount, (unsigned int)ROVER_APP_PATH_MAX_POINTS);
+        return CFE_STATUS_RANGE_ERROR;
+    }
+
+    for (i = 0; i < Cmd->PointCount; i++)
+    {
+        if (!isfinite(Cmd->Point[i].x) || !isfinite(Cmd->Point[i].y))
+        {
+            ROVER_APP_EVENT(ROVER_APP_PATH_ERR_EID, CFE_EVS_EventType_ERROR,
+                            "rover app: path point %u is not finite", (unsigned int)(Staged + i));
+            return CFE_STATUS_VALIDATION_FAILURE;
+        }
+    }
+
+    if (Staged == 0)
+    {
+        /*
+        ** A new upload goes into the slot the control loop is not using,
+        ** which once it has acknowledged the current one it never touches.
+        ** That is the other one from the last start, not from Active: after
+        ** a stop both read NONE while the loop may still be on that slot.
+        */
+        Active = RoverAppPathData.Active;
+        if (__atomic_load_n(&RoverAppPathData.Acked, __ATOMIC_ACQUIRE) != Active)
+        {
+            ROVER_APP_EVENT(ROVER_APP_PATH_ERR_EID, CFE_EVS_EventType_ERROR,
+                            "rover app: previous path change not yet applied by the control loop");
+            return CFE_STATUS_INCORRECT_STATE;
+        }
+        RoverAppPathData.Staging = (RoverAppPathData.Started == 0) ? 1 : 0;
+    }
+
+    Path = &RoverAppPathData.Slot[RoverAppPathData.Staging];
+    for (i = 0; i < Cmd->PointCount; i++)
+    {
+        Path->X[Staged + i] = Cmd->Point[i].x;
+        Path->Y[Staged + i] = Cmd->Point[i].y;
+    }
+    RoverAppPathData.StagedCount = Staged + Cmd->PointCount;
+
+    return CFE_SUCCESS;
+
+} /* End of RoverAppPathLoad() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppPathStart() -- follow the staged waypoints                         */
+/*                                                                            */
+/*   The staged points are used up: following the path again takes a new    */
+/*   upload.                                                                 */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppPathStart(float Speed, float Lookahead)
+{
+    RoverAppPath_t *Path;
+
+    if (RoverAppPathData.StagedCount < 2)
+    {
+        ROVER_APP_EVENT(ROVER_APP_PATH_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: path needs at least 2 points, %u staged",
+                        (unsigned int)RoverAppPathData.StagedCount);
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    if (Lookahead == 0.0f)
+    {
+        Lookahead = ROVER_APP_PATH_LOOKAHEAD;
+    }
+    if (!isfinite(Speed) || !isfinite(Lookahead) || Speed <= 0.0f || Lookahead <= 0.0f)
+    {
+        ROVER_APP_EVENT(ROVER_APP_PATH_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: path speed %.3f and lookahead %.3f must be positive", (double)Speed,
+                        (double)Lookahead);
+        return CFE_STATUS_VALIDATION_FAILURE;
+    }
+
+    /* The upload began from an acknowledged Active, and only this task changes Active */
+    Path             = &RoverAppPathData.Slot[RoverAppPathData.Staging];
+    Path->PointCount = RoverAppPathData.StagedCount;
+    Path->Speed      = Speed;
+    Path->Lookahead  = Lookahead;
+
+    RoverAppPathBuild(Path);
+    RoverAppPathData.StagedCount = 0;
+
+    RoverAppPathData.Started = RoverAppPathData.Staging;
+    __atomic_store_n(&RoverAppPathData.Active, RoverAppPathData.Staging, __ATOMIC_RELEASE);
+
+    ROVER_APP_EVENT(ROVER_APP_PATH_INF_EID, CFE_EVS_EventType_INFORMATION,
+                    "rover app: path of %u points, %.1f m, started, %ux%u grid of %.2f m cells",
+                    (unsigned int)Path->PointCount, (double)Path->S[Path->PointCount - 1],
+                    (unsigned int)Path->GridW, (unsigned int)Path->GridH, (double)Path->CellSize);
+
+    return CFE_SUCCESS;
+
+} /* End of RoverAppPathStart() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppPathStop() -- hand the twist back to SET_TWIST                     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppPathStop(void)
+{
+    __atomic_store_n(&RoverAppPathData.Active, ROVER_APP_PATH_NONE, __ATOMIC_RELEASE);
+
+} /* End of RoverAppPathStop() */
+
+/*
+** Distance from (Px, Py) to segment k, kept in *Best if it is the nearest
+** so far.  Ties go to the earlier segment, the one the rover reaches first.
+*/
+static inline void RoverAppPathTry(const RoverAppPath_t *Path, uint32 k, float Px, float Py, float *Best,
+                                   uint32 *BestK, float *BestT)
+{
+    float Ex   = Path->X[k + 1] - Path->X[k];
+    float Ey   = Path->Y[k + 1] - Path->Y[k];
+    float Dx   = Px - Path->X[k];
+    float Dy   = Py - Path->Y[k];
+    float Len2 = (Ex * Ex) + (Ey * Ey);
+    float u    = (Len2 > 0.0f) ? fmaxf(0.0f, fminf(1.0f, ((Dx * Ex) + (Dy * Ey)) / Len2)) : 0.0f;
+    float d2;
+
+    Dx -= u * Ex;
+    Dy -= u * Ey;
+    d2 = (Dx * Dx) + (Dy * Dy);
+
+    if (d2 < *Best || (d2 == *Best && k < *BestK))
+    {
+        *Best  = d2;
+        *BestK = k;
+        *BestT = u;
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppPathNearest() -- nearest segment to (Px, Py) in the grid           */
+/*                                                                            */
+/*   Only segments First and on that start at most MaxS along the path are   */
+/*   considered.  Returns the segment, with the position along it in *t.     */
+/*   Far from all of them the rings grow with the distance, so once the     */
+/*   search has cost more than checking each of them, it does that instead. */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static uint32 RoverAppPathNearest(const RoverAppPath_t *Path, float Px, float Py, uint32 First, float MaxS, float *t)
+{
+    uint32 Cx;
+    uint32 Cy;
+    uint32 Rings;
+    uint32 r;
+    int32  x;
+    int32  y;
+    int32  Step;
+    uint32 c;
+    uint32 i;
+    uint32 k;
+    uint32 Lo;
+    uint32 Hi;
+    uint32 Mid;
+    uint32 Window;
+    uint32 Work   = 0;
+    float  Best   = FLT_MAX;
+    uint32 BestK  = First;
+    float  BestT  = 0.0f;
+    float  Reach;
+
+    /* Segments to consider: First to Lo, the last one starting at most MaxS along */
+    Lo = First;
+    Hi = Path->PointCount - 1;
+    while (Hi - Lo > 1)
+    {
+        Mid = Lo + ((Hi - Lo) / 2);
+        if (Path->S[Mid] <= MaxS)
+        {
+            Lo = Mid;
+        }
+        else
+        {
+            Hi = Mid;
+        }
+    }
+    Window = Lo - First + 1;
+
+    Cx = RoverAppPathCell(Px - Path->OriginX, Path->CellSize, Path->GridW);
+    Cy = RoverAppPathCell(Py - Path->OriginY, Path->CellSize, Path->GridH);
+
+    Rings = Path->GridW > Path->GridH ? Path->GridW : Path->GridH;
+
+    for (r = 0; r < Rings; r++)
+    {
+        /* Cells at Chebyshev distance r from (Cx, Cy): whole top and bottom rows, then the sides */
+        for (y = (int32)Cy - (int32)r; y <= (int32)Cy + (int32)r; y++)
+        {
+            Work++;
+            if (y < 0 || y >= (int32)Path->GridH)
+            {
+                continue;
+            }
+
+            Step = (y == (int32)Cy - (int32)r || y == (int32)Cy + (int32)r) ? 1 : (int32)(2 * r);
+            for (x = (int32)Cx - (int32)r; x <= (int32)Cx + (int32)r; x += Step)
+            {
+                if (x < 0 || x >= (int32)Path->GridW)
+                {
+                    continue;
+                }
+
+                c = ((uint32)y * Path->GridW) + (uint32)x;
+                Work += 1 + (Path->CellStart[c + 1] - Path->CellStart[c]);
+                for (i = Path->CellStart[c]; i < Path->CellStart[c + 1]; i++)
+                {
+                    k = Path->CellSeg[i];
+                    if (k >= First && Path->S[k] <= MaxS)
+                    {
+                        RoverAppPathTry(Path, k, Px, Py, &Best, &BestK, &BestT);
+                    }
+                }
+            }
+        }
+
+        /* Every cell further out is at least r cells away */
+        Reach = (float)r * Path->CellSize;
+        if (Best <= Reach * Reach)
+        {
+            break;
+        }
+
+        if (Work > Window)
+        {
+            for (k = First; k <= Lo; k++)
+            {
+                RoverAppPathTry(Path, k, Px, Py, &Best, &BestK, &BestT);
+            }
+            break;
+        }
+    }
+
+    *t = BestT;
+    return BestK;
+
+} /* End of RoverAppPathNearest() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppPathFollow() -- pure pursuit twist from Pose, control task only    */
+/*                                                                            */
+/*   Returns false with Twist untouched when no path is running.  At the     */
+/*   end of the path the twist is zero until the path is stopped.            */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+bool RoverAppPathFollow(const RoverAppPose_t *Pose, RoverAppTwist_t *Twist)
+{
+    RoverAppPathData_t   *Data = &RoverAppPathData;
+    const RoverAppPath_t *Path;
+    uint8                 Active;
+    uint32                Last;
+    uint32                k;
+    uint32                Lo;
+    uint32                Hi;
+    uint32                Mid;
+    float                 t;
+    float                 Along;
+    float                 Target;
+    float                 Gx;
+    float                 Gy;
+    float                 Yaw;
+    float                 Dx;
+    float                 Dy;
+    float                 Lx;
+    float                 Ly;
+    float                 d2;
+    float                 Remaining;
+    float                 ToEnd;
+    float                 Speed;
+
+    Active = __atomic_load_n(&Data->Active, __ATOMIC_ACQUIRE);
+    if (Active != Data->Acked)
+    {
+        __atomic_store_n(&Data->Acked, Active, __ATOMIC_RELEASE);
+        Data->Acquired = false;
+        Data->Done     = false;
+        Data->Progress = 0;
+    }
+
+    if (Active == ROVER_APP_PATH_NONE)
+    {
+        return false;
+    }
+
+    memset(Twist, 0, sizeof(*Twist));
+    if (Data->Done)
+    {
+        return true;
+    }
+
+    Path = &Data->Slot[Active];
+    Last = Path->PointCount - 1;
+
+    /* Nearest point of the path, anywhere on the first tick */
+    k = RoverAppPathNearest(Path, Pose->x, Pose->y, Data->Progress,
+                            Data->Acquired ? Path->S[Data->Progress] + Path->Lookahead : FLT_MAX, &t);
+    Data->Progress = k;
+    Data->Acquired = true;
+
+    Along     = Path->S[k] + (t * (Path->S[k + 1] - Path->S[k]));
+    Remaining = Path->S[Last] - Along;
+    ToEnd     = hypotf(Path->X[Last] - Pose->x, Path->Y[Last] - Pose->y);
+
+    /* Where the path ends where it began, only the end counts */
+    if (ToEnd <= ROVER_APP_PATH_GOAL_TOLERANCE && Remaining <= Path->Lookahead)
+    {
+        Data->Done = true;
+        ROVER_APP_EVENT(ROVER_APP_PATH_INF_EID, CFE_EVS_EventType_INFORMATION,
+                        "rover app: end of path reached, %.1f m", (double)Path->S[Last]);
+        return true;
+    }
+
+    /* Lookahead point: the last point S[Lo] <= Target, interpolated to it */
+    Target = Along + Path->Lookahead;
+    if (Target >= Path->S[Last])
+    {
+        Gx = Path->X[Last];
+        Gy = Path->Y[Last];
+    }
+    else
+    {
+        Lo = k;
+        Hi = Last;
+        while (Hi - Lo > 1)
+        {
+            Mid = Lo + ((Hi - Lo) / 2);
+            if (Path->S[Mid] <= Target)
+            {
+                Lo = Mid;
+            }
+            else
+            {
+                Hi = Mid;
+            }
+        }
+        t  = (Path->S[Hi] > Path->S[Lo]) ? (Target - Path->S[Lo]) / (Path->S[Hi] - Path->S[Lo]) : 0.0f;
+        Gx = Path->X[Lo] + (t * (Path->X[Hi] - Path->X[Lo]));
+        Gy = Path->Y[Lo] + (t * (Path->Y[Hi] - Path->Y[Lo]));
+    }
+
+    /* Into the rover frame, and the arc through it: curvature 2 y / d^2 */
+    Yaw = atan2f(2.0f * ((Pose->qw * Pose->qz) + (Pose->qx * Pose->qy)),
+                 1.0f - (2.0f * ((Pose->qy * Pose->qy) + (Pose->qz * Pose->qz))));
+    Dx  = Gx - Pose->x;
+    Dy  = Gy - Pose->y;
+    Lx  = (cosf(Yaw) * Dx) + (sinf(Yaw) * Dy);
+    Ly  = (cosf(Yaw) * Dy) - (sinf(Yaw) * Dx);
+    d2  = (Lx * Lx) + (Ly * Ly);
+
+    /* Slow down over the last lookahead, still heading for the end if off to one side of it */
+    Speed = Path->Speed * fminf(1.0f, fmaxf(Remaining, ToEnd) / Path->Lookahead);
+
+    Twist->linear_x = Speed;
+    if (d2 > 0.0f)
+    {
+        Twist->angular_z = Speed * ((2.0f * Ly) / d2);
+    }
+
+    return true;
+
+} /* End of RoverAppPathFollow() */
+
+/************************/
+/*  End of File Comment */
+/************************/
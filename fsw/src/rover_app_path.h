@@ -0,0 +1,85 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_path.h
+**
+** Purpose:
+**   On-board path following: an uploaded polyline of waypoints is followed
+**   by pure pursuit, with a uniform grid over its segments so that the
+**   nearest segment is found in time independent of the path length.
+**
+** Notes:
+**   Waypoints are uploaded and started from the command task and followed
+**   from the task that services the control pipe, with the same two slot
+**   handoff as the trajectories in rover_app_traj.h: the upload goes into
+**   the slot the control loop is not using, and a start hands it over
+**   with one atomic store.
+**
+*******************************************************************************/
+#ifndef _rover_app_path_h_
+#define _rover_app_path_h_
+
+#include "cfe.h"
+
+#include "rover_app_msg.h"
+#include "rover_app_platform_cfg.h"
+
+#define ROVER_APP_PATH_SLOTS 2
+#define ROVER_APP_PATH_NONE  0xFF /* No path running */
+
+/*
+** A path and its segment grid.  Segment k runs from point k to k + 1 and
+** S[k] is the distance along the path to point k.  The segments that
+** touch cell c are CellSeg[CellStart[c]] to CellSeg[CellStart[c + 1] - 1],
+** cells numbered row by row from (OriginX, OriginY).
+*/
+typedef struct
+{
+    uint32 PointCount;
+    float  Speed;     /* m/s */
+    float  Lookahead; /* m */
+
+    float X[ROVER_APP_PATH_MAX_POINTS];
+    float Y[ROVER_APP_PATH_MAX_POINTS];
+    float S[ROVER_APP_PATH_MAX_POINTS];
+
+    float  OriginX;
+    float  OriginY;
+    float  CellSize;
+    uint32 GridW;
+    uint32 GridH;
+    uint32 CellStart[ROVER_APP_PATH_GRID_CELLS + 1];
+    uint32 CellSeg[ROVER_APP_PATH_GRID_ENTRIES];
+} RoverAppPath_t;
+
+/*
+** Exported functions
+*/
+void  RoverAppPathInit(void);
+int32 RoverAppPathLoad(const RoverAppPathLoadCmd_t *Cmd);
+int32 RoverAppPathStart(float Speed, float Lookahead);
+void  RoverAppPathStop(void);
+bool  RoverAppPathFollow(const RoverAppPose_t *Pose, RoverAppTwist_t *Twist);
+
+#endif /* _rover_app_path_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -0,0 +1,467 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_record.c
+**
+** Purpose:
+**   Input recorder for the rover app.
+**
+** Notes:
+**   Producers reserve space between the writer's Tail and one ring ahead
+**   of it, fill it, and publish the record by setting its Seq last.  The
+**   writer collects complete records from Tail on, writes them straight
+**   from the ring (two writes where they wrap) and only then moves Tail,
+**   so the space is not reused while it is being written.  Records start
+**   on ROVER_APP_RECORD_ALIGN boundaries, so a header never wraps.
+**
+*******************************************************************************/
+
+/*
+** Include Files:
+*/
+#include "rover_app_events.h"
+#include "rover_app_evlimit.h"
+#include "rover_app.h"
+#include "rover_app_record.h"
+
+#include <string.h>
+
+#define ROVER_APP_RECORD_RING_MASK (ROVER_APP_RECORD_RING_SIZE - 1)
+#define ROVER_APP_RECORD_MAX_MSG   (ROVER_APP_RECORD_RING_SIZE / 4) /* Bigger messages are dropped */
+
+/* Writer requests */
+#define ROVER_APP_RECORD_REQ_NONE  0
+#define ROVER_APP_RECORD_REQ_START 1
+#define ROVER_APP_RECORD_REQ_STOP  2
+
+typedef struct
+{
+    union
+    {
+        RoverAppRecordHdr_t Hdr[ROVER_APP_RECORD_RING_SIZE / sizeof(RoverAppRecordHdr_t)];
+        uint8               Bytes[ROVER_APP_RECORD_RING_SIZE];
+    } Ring;
+
+    uint32 Head;     /* Next byte to reserve, shared by all producers */
+    uint32 Tail;     /* Next byte to write, moved by the writer only */
+    bool   Active;   /* Producers record while set */
+    uint32 Recorded; /* Since init */
+    uint32 Dropped;
+
+    /* Commands to the writer */
+    uint32 Request;
+    char   RequestFilename[CFE_MISSION_MAX_PATH_LEN];
+
+    /* Writer */
+    CFE_ES_TaskId_t TaskId;
+    osal_id_t       Fd;
+    bool            FileOpen;
+    char            Filename[CFE_MISSION_MAX_PATH_LEN];
+    uint32          FileRecords;
+    uint32          FileBytes;
+    RoverAppStamp_t LastWrite;
+} RoverAppRecordData_t;
+
+static RoverAppRecordData_t RoverAppRecordData;
+
+extern RoverAppData_t RoverAppData;
+
+#if ROVER_APP_RECORD_ENABLE
+static void RoverAppRecordTask(void);
+#endif
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppRecordInit() -- empty the ring and start the writer task           */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppRecordInit(void)
+{
+    int32 status = CFE_SUCCESS;
+
+    memset(&RoverAppRecordData, 0, sizeof(RoverAppRecordData));
+
+#if ROVER_APP_RECORD_ENABLE
+    status = CFE_ES_CreateChildTask(&RoverAppRecordData.TaskId, "ROVER_APP_RECORD", RoverAppRecordTask,
+                                    CFE_ES_TASK_STACK_ALLOCATE, ROVER_APP_RECORD_TASK_STACK_SIZE,
+                                    ROVER_APP_RECORD_TASK_PRIORITY, 0);
+    if (status != CFE_SUCCESS)
+    {
+        CFE_ES_WriteToSysLog("Rover App: Error creating record task, RC = 0x%08lX\n", (unsigned long)status);
+    }
+#endif
+
+    return status;
+
+} /* End of RoverAppRecordInit() */
+
+/*
+** Copy into the ring from Offset on, wrapping at its end; zeros for a
+** NULL Src
+*/
+static void RoverAppRecordPut(uint32 Offset, const void *Src, uint32 Length)
+{
+    uint32 Start = Offset & ROVER_APP_RECORD_RING_MASK;
+    uint32 First = ROVER_APP_RECORD_RING_SIZE - Start;
+
+    if (First > Length)
+    {
+        First = Length;
+    }
+
+    if (Src == NULL)
+    {
+        memset(&RoverAppRecordData.Ring.Bytes[Start], 0, First);
+        memset(&RoverAppRecordData.Ring.Bytes[0], 0, Length - First);
+    }
+    else
+    {
+        memcpy(&RoverAppRecordData.Ring.Bytes[Start], Src, First);
+        memcpy(&RoverAppRecordData.Ring.Bytes[0], (const uint8 *)Src + First, Length - First);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppRecordMsg() -- record a message while recording, from any task    */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppRecordMsg(const CFE_MSG_Message_t *MsgPtr)
+{
+    RoverAppRecordData_t *Data = &RoverAppRecordData;
+    RoverAppRecordHdr_t  *Hdr;
+    CFE_TIME_SysTime_t    Time;
+    CFE_MSG_Size_t        Size = 0;
+    uint32                RecordSize;
+    uint32                Head;
+
+    if (!__atomic_load_n(&Data->Active, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    CFE_MSG_GetSize(MsgPtr, &Size);
+    if (Size > ROVER_APP_RECORD_MAX_MSG)
+    {
+        __atomic_fetch_add(&Data->Dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    RecordSize = ROVER_APP_RECORD_SIZE(Size);
+
+    Head = __atomic_load_n(&Data->Head, __ATOMIC_RELAXED);
+    do
+    {
+        if (Head + RecordSize - __atomic_load_n(&Data->Tail, __ATOMIC_ACQUIRE) > ROVER_APP_RECORD_RING_SIZE)
+        {
+            __atomic_fetch_add(&Data->Dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&Data->Head, &Head, Head + RecordSize, true, __ATOMIC_RELAXED,
+                                          __ATOMIC_RELAXED));
+
+    Time = CFE_TIME_GetTime();
+
+    Hdr             = &Data->Ring.Hdr[(Head & ROVER_APP_RECORD_RING_MASK) / sizeof(RoverAppRecordHdr_t)];
+    Hdr->Length     = (uint32)Size;
+    Hdr->Seconds    = Time.Seconds;
+    Hdr->Subseconds = Time.Subseconds;
+    RoverAppRecordPut(Head + sizeof(RoverAppRecordHdr_t), MsgPtr, (uint32)Size);
+    RoverAppRecordPut(Head + sizeof(RoverAppRecordHdr_t) + (uint32)Size, NULL,
+                      RecordSize - sizeof(RoverAppRecordHdr_t) - (uint32)Size);
+
+    __atomic_store_n(&Hdr->Seq, Head + 1, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&Data->Recorded, 1, __ATOMIC_RELAXED);
+
+} /* End of RoverAppRecordMsg() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppRecordStart() -- record to a file, switching files if already     */
+/*                          recording                                         */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppRecordStart(const char *Filename)
+{
+#if ROVER_APP_RECORD_ENABLE
+    if (Filename == NULL || Filename[0] == '\0')
+    {
+        Filename = ROVER_APP_RECORD_FILE;
+    }
+
+    if (__atomic_load_n(&RoverAppRecordData.Request, __ATOMIC_ACQUIRE) != ROVER_APP_RECORD_REQ_NONE)
+    {
+        ROVER_APP_EVENT(ROVER_APP_RECORD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: record command already pending");
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    strncpy(RoverAppRecordData.RequestFilename, Filename, sizeof(RoverAppRecordData.RequestFilename) - 1);
+    RoverAppRecordData.RequestFilename[sizeof(RoverAppRecordData.RequestFilename) - 1] = 0;
+    __atomic_store_n(&RoverAppRecordData.Request, ROVER_APP_RECORD_REQ_START, __ATOMIC_RELEASE);
+
+    return CFE_SUCCESS;
+#else
+    ROVER_APP_EVENT(ROVER_APP_RECORD_ERR_EID, CFE_EVS_EventType_ERROR, "rover app: recorder not built in");
+
+    return CFE_STATUS_INCORRECT_STATE;
+#endif
+
+} /* End of RoverAppRecordStart() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppRecordStop() -- write out what is recorded and close the file     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppRecordStop(void)
+{
+    if (!__atomic_load_n(&RoverAppRecordData.Active, __ATOMIC_ACQUIRE) ||
+        __atomic_load_n(&RoverAppRecordData.Request, __ATOMIC_ACQUIRE) != ROVER_APP_RECORD_REQ_NONE)
+    {
+        ROVER_APP_EVENT(ROVER_APP_RECORD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: not recording, or record command already pending");
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    __atomic_store_n(&RoverAppRecordData.Request, ROVER_APP_RECORD_REQ_STOP, __ATOMIC_RELEASE);
+
+    return CFE_SUCCESS;
+
+} /* End of RoverAppRecordStop() */
+
+/*
+** End of the complete records from Tail on (writer side)
+*/
+static uint32 RoverAppRecordCollect(uint32 *Records)
+{
+    RoverAppRecordData_t      *Data = &RoverAppRecordData;
+    const RoverAppRecordHdr_t *Hdr;
+    uint32                     Head;
+    uint32                     End = Data->Tail;
+
+    Head = __atomic_load_n(&Data->Head, __ATOMIC_ACQUIRE);
+    while (End != Head)
+    {
+        Hdr = &Data->Ring.Hdr[(End & ROVER_APP_RECORD_RING_MASK) / sizeof(RoverAppRecordHdr_t)];
+        if (__atomic_load_n(&Hdr->Seq, __ATOMIC_ACQUIRE) != End + 1)
+        {
+            /* Still being filled; pick it up next time */
+            break;
+        }
+
+        End += ROVER_APP_RECORD_SIZE(Hdr->Length);
+        (*Records)++;
+    }
+
+    return End;
+}
+
+/*
+** Write Tail up to End to the file, then hand the space back
+*/
+static int32 RoverAppRecordWrite(uint32 End)
+{
+    RoverAppRecordData_t *Data  = &RoverAppRecordData;
+    uint32                Start = Data->Tail & ROVER_APP_RECORD_RING_MASK;
+    uint32                Bytes = End - Data->Tail;
+    uint32                First = ROVER_APP_RECORD_RING_SIZE - Start;
+    int32                 status = OS_SUCCESS;
+
+    if (First > Bytes)
+    {
+        First = Bytes;
+    }
+
+    if (OS_write(Data->Fd, &Data->Ring.Bytes[Start], First) != (int32)First ||
+        (Bytes > First && OS_write(Data->Fd, &Data->Ring.Bytes[0], Bytes - First) != (int32)(Bytes - First)))
+    {
+        status = OS_ERROR;
+    }
+
+    Data->FileBytes += Bytes;
+    __atomic_store_n(&Data->Tail, End, __ATOMIC_RELEASE);
+
+    return status;
+}
+
+/*
+** Stop recording and write out what was recorded
+*/
+static void RoverAppRecordClose(void)
+{
+    RoverAppRecordData_t *Data = &RoverAppRecordData;
+    int32                 status;
+
+    __atomic_store_n(&Data->Active, false, __ATOMIC_RELEASE);
+
+    status = RoverAppRecordWrite(RoverAppRecordCollect(&Data->FileRecords));
+    OS_close(Data->Fd);
+    Data->FileOpen = false;
+
+    if (status != OS_SUCCESS)
+    {
+        ROVER_APP_EVENT(ROVER_APP_RECORD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: error writing recording %s, recording stopped", Data->Filename);
+        return;
+    }
+
+    ROVER_APP_EVENT(ROVER_APP_RECORD_INF_EID, CFE_EVS_EventType_INFORMATION,
+                    "rover app: recorded %u messages (%u bytes) to %s", (unsigned int)Data->FileRecords,
+                    (unsigned int)Data->FileBytes, Data->Filename);
+}
+
+/*
+** Open the file of the last start command and start recording
+*/
+static void RoverAppRecordOpen(void)
+{
+    RoverAppRecordData_t   *Data = &RoverAppRecordData;
+    RoverAppRecordFileHdr_t FileHdr;
+    int32                   status;
+
+    memcpy(Data->Filename, Data->RequestFilename, sizeof(Data->Filename));
+
+    status = OS_OpenCreate(&Data->Fd, Data->Filename, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_WRITE_ONLY);
+    if (status != OS_SUCCESS)
+    {
+        ROVER_APP_EVENT(ROVER_APP_RECORD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: error creating recording %s, RC = %d", Data->Filename, (int)status);
+        return;
+    }
+
+    FileHdr.Magic   = ROVER_APP_RECORD_FILE_MAGIC;
+    FileHdr.Version = ROVER_APP_RECORD_FILE_VERSION;
+    FileHdr.HdrSize = sizeof(RoverAppRecordHdr_t);
+
+    if (OS_write(Data->Fd, &FileHdr, sizeof(FileHdr)) != (int32)sizeof(FileHdr))
+    {
+        ROVER_APP_EVENT(ROVER_APP_RECORD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: error writing recording %s", Data->Filename);
+        OS_close(Data->Fd);
+        return;
+    }
+
+    Data->FileOpen    = true;
+    Data->FileRecords = 0;
+    Data->FileBytes   = 0;
+    Data->LastWrite   = RoverAppTimeToStamp(CFE_TIME_GetTime());
+    __atomic_store_n(&Data->Active, true, __ATOMIC_RELEASE);
+
+    ROVER_APP_EVENT(ROVER_APP_RECORD_INF_EID, CFE_EVS_EventType_INFORMATION, "rover app: recording to %s",
+                    Data->Filename);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppRecordService() -- one pass of the writer: act on start and stop,  */
+/*                            and write out the ring once it holds            */
+/*                            ROVER_APP_RECORD_WRITE_SIZE bytes or has held   */
+/*                            anything for ROVER_APP_RECORD_FLUSH_MS          */
+/*                                                                            */
+/*   Writer task only; the host harnesses call it in place of the task.      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppRecordService(void)
+{
+    RoverAppRecordData_t *Data = &RoverAppRecordData;
+    RoverAppStamp_t       Now;
+    uint32                Request;
+    uint32                Records   = 0;
+    uint32                Discarded = 0;
+    uint32                End;
+
+    Request = __atomic_load_n(&Data->Request, __ATOMIC_ACQUIRE);
+    if (Request != ROVER_APP_RECORD_REQ_NONE)
+    {
+        if (Data->FileOpen)
+        {
+            RoverAppRecordClose();
+        }
+        if (Request == ROVER_APP_RECORD_REQ_START)
+        {
+            /* Left over from the last recording, or from before it stopped */
+            __atomic_store_n(&Data->Tail, RoverAppRecordCollect(&Discarded), __ATOMIC_RELEASE);
+            RoverAppRecordOpen();
+        }
+        __atomic_store_n(&Data->Request, ROVER_APP_RECORD_REQ_NONE, __ATOMIC_RELEASE);
+    }
+
+    if (!Data->FileOpen)
+    {
+        return;
+    }
+
+    Now = RoverAppTimeToStamp(CFE_TIME_GetTime());
+    End = RoverAppRecordCollect(&Records);
+    if (End == Data->Tail ||
+        ((End - Data->Tail) < ROVER_APP_RECORD_WRITE_SIZE &&
+         (Now - Data->LastWrite) < ((RoverAppStamp_t)ROVER_APP_RECORD_FLUSH_MS << 32) / 1000))
+    {
+        return;
+    }
+
+    Data->FileRecords += Records;
+    Data->LastWrite = Now;
+    if (RoverAppRecordWrite(End) != OS_SUCCESS)
+    {
+        RoverAppRecordClose();
+    }
+
+} /* End of RoverAppRecordService() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppRecordCounts() -- messages recorded and dropped since init         */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppRecordCounts(uint32 *Recorded, uint32 *Dropped)
+{
+    *Recorded = __atomic_load_n(&RoverAppRecordData.Recorded, __ATOMIC_RELAXED);
+    *Dropped  = __atomic_load_n(&RoverAppRecordData.Dropped, __ATOMIC_RELAXED);
+
+} /* End of RoverAppRecordCounts() */
+
+#if ROVER_APP_RECORD_ENABLE
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppRecordTask() -- low priority child task writing recordings         */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void RoverAppRecordTask(void)
+{
+    while (RoverAppData.RunStatus == CFE_ES_RunStatus_APP_RUN)
+    {
+        OS_TaskDelay(ROVER_APP_RECORD_TASK_PERIOD_MS);
+        RoverAppRecordService();
+    }
+
+    if (RoverAppRecordData.FileOpen)
+    {
+        RoverAppRecordClose();
+    }
+
+    CFE_ES_ExitChildTask();
+
+} /* End of RoverAppRecordTask() */
+#endif
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -0,0 +1,99 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_record.h
+**
+** Purpose:
+**   Input recorder.  Every message dispatched to a handler is copied with
+**   its receive time into a byte ring that a low priority child task
+**   appends to a file in large sequential writes.  rover_app_replay feeds
+**   a recording back through the dispatcher.
+**
+** Notes:
+**   Both tasks record; a message takes its space in the ring with one
+**   compare-and-swap and is dropped and counted when the writer is a ring
+**   behind.  Recording starts and stops on command.  Messages coalesced
+**   away by RoverAppDrainPipe() never reach a handler and are not
+**   recorded, so a replay sees what the handlers saw, in that order.
+**
+*******************************************************************************/
+#ifndef _rover_app_record_h_
+#define _rover_app_record_h_
+
+#include "cfe.h"
+
+#include "rover_app_platform_cfg.h"
+
+#define ROVER_APP_RECORD_FILE_MAGIC   0x52565243 /* "RVRC" */
+#define ROVER_APP_RECORD_FILE_VERSION 1
+#define ROVER_APP_RECORD_ALIGN        16 /* Records start on this boundary, in the ring and in files */
+
+#if (ROVER_APP_RECORD_RING_SIZE & (ROVER_APP_RECORD_RING_SIZE - 1)) != 0 || \
+    ROVER_APP_RECORD_RING_SIZE < ROVER_APP_RECORD_WRITE_SIZE
+#error ROVER_APP_RECORD_RING_SIZE must be a power of two of at least ROVER_APP_RECORD_WRITE_SIZE
+#endif
+
+/*
+** Record header, followed by the message and zeros up to the next
+** ROVER_APP_RECORD_ALIGN boundary
+*/
+typedef struct
+{
+    uint32 Seq;        /* Ring offset + 1, set once the record is complete */
+    uint32 Length;     /* Message bytes */
+    uint32 Seconds;    /* Receive time */
+    uint32 Subseconds;
+} RoverAppRecordHdr_t;
+
+typedef struct
+{
+    uint32 Magic;
+    uint16 Version;
+    uint16 HdrSize;
+} RoverAppRecordFileHdr_t;
+
+#define ROVER_APP_RECORD_SIZE(Length)                                                    \
+    (((uint32)sizeof(RoverAppRecordHdr_t) + (uint32)(Length) + ROVER_APP_RECORD_ALIGN - 1) & \
+     ~(uint32)(ROVER_APP_RECORD_ALIGN - 1))
+
+#if ROVER_APP_RECORD_ENABLE
+#define ROVER_APP_RECORD_MSG(MsgPtr) RoverAppRecordMsg(MsgPtr)
+#else
+#define ROVER_APP_RECORD_MSG(MsgPtr) \
+    do                               \
+    {                                \
+    } while (0)
+#endif
+
+/*
+** Exported functions
+*/
+int32 RoverAppRecordInit(void);
+void  RoverAppRecordMsg(const CFE_MSG_Message_t *MsgPtr);
+int32 RoverAppRecordStart(const char *Filename);
+int32 RoverAppRecordStop(void);
+void  RoverAppRecordService(void);
+void  RoverAppRecordCounts(uint32 *Recorded, uint32 *Dropped);
+
+#endif /* _rover_app_record_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -0,0 +1,333 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_sched.c
+**
+** Purpose:
+**   Time-tagged command scheduler for the rover app.
+**
+** Notes:
+**   The heap holds small (time, sequence, slot) keys; the commands stay
+**   in a pool of fixed slots and are only copied on insert and release.
+**   Commands with the same execution time are released in the order they
+**   were inserted.  At most ROVER_APP_SCHED_RELEASE_LIMIT commands go out
+**   per tick, the rest on the following ticks.
+**
+*******************************************************************************/
+
+/*
+** Include Files:
+*/
+#include "rover_app_events.h"
+#include "rover_app_evlimit.h"
+#include "rover_app_sched.h"
+#include "rover_app_diag.h"
+#include "rover_app_msgids.h"
+
+#include <string.h>
+
+typedef struct
+{
+    RoverAppStamp_t Stamp;
+    uint32          Seq;  /* Insertion order, breaks ties */
+    uint32          Slot; /* Pool[] entry */
+} RoverAppSchedKey_t;
+
+typedef union
+{
+    CFE_SB_Buffer_t Buf;
+    uint8           Bytes[ROVER_APP_SCHED_MAX_CMD_SIZE];
+} RoverAppSchedCmd_t;
+
+typedef struct
+{
+    RoverAppSchedKey_t Heap[ROVER_APP_SCHED_CAPACITY];
+    uint32             Count;
+    uint32             NextSeq;
+
+    RoverAppSchedCmd_t Pool[ROVER_APP_SCHED_CAPACITY];
+    uint32             Free[ROVER_APP_SCHED_CAPACITY]; /* Stack of unused Pool[] entries */
+    uint32             FreeCount;
+
+    uint64 LateSumNs;
+
+    RoverAppSchedTlm_t Tlm;
+} RoverAppSchedData_t;
+
+static RoverAppSchedData_t RoverAppSchedData;
+
+static inline bool RoverAppSchedBefore(const RoverAppSchedKey_t *a, const RoverAppSchedKey_t *b)
+{
+    return (a->Stamp < b->Stamp) || (a->Stamp == b->Stamp && (int32)(a->Seq - b->Seq) < 0);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppSchedInit() -- empty the scheduler, set up the packet              */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppSchedInit(void)
+{
+    uint32 i;
+
+    memset(&RoverAppSchedData, 0, sizeof(RoverAppSchedData));
+
+    for (i = 0; i < ROVER_APP_SCHED_CAPACITY; i++)
+    {
+        RoverAppSchedData.Free[i] = ROVER_APP_SCHED_CAPACITY - 1 - i;
+    }
+    RoverAppSchedData.FreeCount = ROVER_APP_SCHED_CAPACITY;
+
+    CFE_MSG_Init(&RoverAppSchedData.Tlm.TlmHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_SCHED_TLM_MID),
+                 sizeof(RoverAppSchedData.Tlm));
+
+} /* End of RoverAppSchedInit() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppSchedInsert() -- queue a time-tagged command, O(log n)             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppSchedInsert(const RoverAppSchedInsertCmd_t *Cmd)
+{
+    RoverAppSchedTlmPayload_t *Payload = &RoverAppSchedData.Tlm.Payload;
+    RoverAppSchedCmd_t        *Entry;
+    RoverAppSchedKey_t         Key;
+    CFE_MSG_Size_t             Size = 0;
+    CFE_TIME_SysTime_t         Exec;
+    uint32                     i;
+    uint32                     Parent;
+
+    if (RoverAppSchedData.Count >= ROVER_APP_SCHED_CAPACITY)
+    {
+        Payload->RejectCount++;
+        ROVER_APP_EVENT(ROVER_APP_SCHED_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: command scheduler full, %u pending", (unsigned int)RoverAppSchedData.Count);
+        return CFE_STATUS_RANGE_ERROR;
+    }
+
+    Entry = &RoverAppSchedData.Pool[RoverAppSchedData.Free[RoverAppSchedData.FreeCount - 1]];
+    memcpy(Entry->Bytes, Cmd->Cmd, sizeof(Entry->Bytes));
+
+    CFE_MSG_GetSize(&Entry->Buf.Msg, &Size);
+    if (Size < sizeof(CFE_MSG_CommandHeader_t) || Size > sizeof(Entry->Bytes))
+    {
+        Payload->RejectCount++;
+        ROVER_APP_EVENT(ROVER_APP_SCHED_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: time-tagged command length %u out of range", (unsigned int)Size);
+        return CFE_STATUS_VALIDATION_FAILURE;
+    }
+
+    Exec.Seconds    = Cmd->ExecSeconds;
+    Exec.Subseconds = Cmd->ExecSubseconds;
+
+    Key.Stamp = RoverAppTimeToStamp(Exec);
+    Key.Seq   = RoverAppSchedData.NextSeq++;
+    Key.Slot  = RoverAppSchedData.Free[--RoverAppSchedData.FreeCount];
+
+    /* Sift up */
+    i = RoverAppSchedData.Count++;
+    while (i > 0)
+    {
+        Parent = (i - 1) / 2;
+        if (!RoverAppSchedBefore(&Key, &RoverAppSchedData.Heap[Parent]))
+        {
+            break;
+        }
+        RoverAppSchedData.Heap[i] = RoverAppSchedData.Heap[Parent];
+        i                         = Parent;
+    }
+    RoverAppSchedData.Heap[i] = Key;
+
+    Payload->InsertCount++;
+
+    return CFE_SUCCESS;
+
+} /* End of RoverAppSchedInsert() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppSchedPop() -- remove the earliest command, O(log n)                */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void RoverAppSchedPop(void)
+{
+    RoverAppSchedKey_t *Heap = RoverAppSchedData.Heap;
+    RoverAppSchedKey_t  Last;
+    uint32              Count;
+    uint32              Child;
+    uint32              i = 0;
+
+    RoverAppSchedData.Free[RoverAppSchedData.FreeCount++] = Heap[0].Slot;
+
+    Count = --RoverAppSchedData.Count;
+    Last  = Heap[Count];
+
+    /* Sift the last key down from the root */
+    while ((Child = (2 * i) + 1) < Count)
+    {
+        if (Child + 1 < Count && RoverAppSchedBefore(&Heap[Child + 1], &Heap[Child]))
+        {
+            Child++;
+        }
+        if (!RoverAppSchedBefore(&Heap[Child], &Last))
+        {
+            break;
+        }
+        Heap[i] = Heap[Child];
+        i       = Child;
+    }
+    Heap[i] = Last;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppSchedRelease() -- send the commands due at Now, HR tick only       */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppSchedRelease(RoverAppStamp_t Now)
+{
+    RoverAppSchedTlmPayload_t *Payload = &RoverAppSchedData.Tlm.Payload;
+    const RoverAppSchedKey_t  *Top;
+    CFE_SB_MsgId_t             MsgId;
+    CFE_Status_t               status;
+    uint64                     LateNs;
+    uint32                     Released = 0;
+
+    while (RoverAppSchedData.Count > 0 && Released < ROVER_APP_SCHED_RELEASE_LIMIT)
+    {
+        Top = &RoverAppSchedData.Heap[0];
+        if (Top->Stamp > Now)
+        {
+            break;
+        }
+
+        status = CFE_SB_TransmitMsg(&RoverAppSchedData.Pool[Top->Slot].Buf.Msg, true);
+        if (status == CFE_SUCCESS)
+        {
+#if ROVER_APP_DIAG_ENABLE
+            RoverAppDiagAdd(ROVER_APP_DIAG_SCHED_LATE, Top->Stamp, Now);
+#endif
+            LateNs = RoverAppStampToNs(Now - Top->Stamp);
+            RoverAppSchedData.LateSumNs += LateNs;
+            if (LateNs > Payload->LateMaxNs)
+            {
+                Payload->LateMaxNs = (LateNs > 0xFFFFFFFFULL) ? 0xFFFFFFFFU : (uint32)LateNs;
+            }
+            Payload->ReleaseCount++;
+        }
+        else
+        {
+            /* Dropped, not retried: it would only be later still next tick */
+            CFE_MSG_GetMsgId(&RoverAppSchedData.Pool[Top->Slot].Buf.Msg, &MsgId);
+            Payload->SendErrorCount++;
+            ROVER_APP_EVENT(ROVER_APP_SCHED_ERR_EID, CFE_EVS_EventType_ERROR,
+                            "rover app: error sending time-tagged command 0x%04X, RC = 0x%08lX",
+                            (unsigned int)CFE_SB_MsgIdToValue(MsgId), (unsigned long)status);
+        }
+        Released++;
+
+        RoverAppSchedPop();
+    }
+
+} /* End of RoverAppSchedRelease() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppSchedFlush() -- drop every pending command                         */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppSchedFlush(void)
+{
+    uint32 Flushed = RoverAppSchedData.Count;
+
+    while (RoverAppSchedData.Count > 0)
+    {
+        RoverAppSchedPop();
+    }
+
+    RoverAppSchedData.Tlm.Payload.FlushCount += Flushed;
+
+    ROVER_APP_EVENT(ROVER_APP_SCHED_INF_EID, CFE_EVS_EventType_INFORMATION,
+                    "rover app: %u time-tagged commands flushed", (unsigned int)Flushed);
+
+} /* End of RoverAppSchedFlush() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppSchedReport() -- send the pending commands, in execution order     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppSchedReport(void)
+{
+    RoverAppSchedTlmPayload_t *Payload = &RoverAppSchedData.Tlm.Payload;
+    RoverAppSchedKey_t         Sorted[ROVER_APP_SCHED_CAPACITY];
+    RoverAppSchedKey_t         Key;
+    RoverAppSchedEntry_t      *Entry;
+    const CFE_MSG_Message_t   *MsgPtr;
+    CFE_SB_MsgId_t             MsgId   = CFE_SB_INVALID_MSG_ID;
+    CFE_MSG_FcnCode_t          FcnCode = 0;
+    CFE_MSG_Size_t             Size    = 0;
+    uint32                     Count   = RoverAppSchedData.Count;
+    uint32                     i;
+    uint32                     j;
+
+    /* Insertion sort of a copy of the heap; it is mostly ordered already */
+    memcpy(Sorted, RoverAppSchedData.Heap, Count * sizeof(Sorted[0]));
+    for (i = 1; i < Count; i++)
+    {
+        Key = Sorted[i];
+        for (j = i; j > 0 && RoverAppSchedBefore(&Key, &Sorted[j - 1]); j--)
+        {
+            Sorted[j] = Sorted[j - 1];
+        }
+        Sorted[j] = Key;
+    }
+
+    memset(Payload->Entry, 0, sizeof(Payload->Entry));
+    for (i = 0; i < Count; i++)
+    {
+        MsgPtr = &RoverAppSchedData.Pool[Sorted[i].Slot].Buf.Msg;
+        Entry  = &Payload->Entry[i];
+
+        CFE_MSG_GetMsgId(MsgPtr, &MsgId);
+        CFE_MSG_GetFcnCode(MsgPtr, &FcnCode);
+        CFE_MSG_GetSize(MsgPtr, &Size);
+
+        Entry->ExecSeconds    = (uint32)(Sorted[i].Stamp >> 32);
+        Entry->ExecSubseconds = (uint32)Sorted[i].Stamp;
+        Entry->MsgId          = (uint16)CFE_SB_MsgIdToValue(MsgId);
+        Entry->FcnCode        = (uint8)FcnCode;
+        Entry->Size           = (uint8)Size;
+    }
+
+    Payload->EntryCount = Count;
+    Payload->LateMeanNs =
+        (Payload->ReleaseCount > 0) ? (uint32)(RoverAppSchedData.LateSumNs / Payload->ReleaseCount) : 0;
+
+    CFE_SB_TimeStampMsg(&RoverAppSchedData.Tlm.TlmHeader.Msg);
+
+    return CFE_SB_TransmitMsg(&RoverAppSchedData.Tlm.TlmHeader.Msg, true);
+
+} /* End of RoverAppSchedReport() */
+
+/************************/
+/*  End of File Comment */
+/************************/
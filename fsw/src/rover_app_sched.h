@@ -0,0 +1,55 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_sched.h
+**
+** Purpose:
+**   Time-tagged command scheduler.  Commands wait in a fixed-capacity
+**   min-heap keyed on execution time and are sent on the software bus by
+**   the first HR tick at or after it.
+**
+** Notes:
+**   ROVER_APP_SCHED_CMD_MID is subscribed on the control pipe, so the
+**   scheduler commands and the HR tick run on the same task and the heap
+**   needs no lock.
+**
+*******************************************************************************/
+#ifndef _rover_app_sched_h_
+#define _rover_app_sched_h_
+
+#include "cfe.h"
+
+#include "rover_app_history.h"
+#include "rover_app_msg.h"
+
+/*
+** Exported functions
+*/
+void  RoverAppSchedInit(void);
+int32 RoverAppSchedInsert(const RoverAppSchedInsertCmd_t *Cmd);
+void  RoverAppSchedFlush(void);
+int32 RoverAppSchedReport(void);
+void  RoverAppSchedRelease(RoverAppStamp_t Now);
+
+#endif /* _rover_app_sched_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
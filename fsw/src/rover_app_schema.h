@@ -0,0 +1,157 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_schema.h
+**
+** Purpose:
+**   The messages the rover app receives, in one place.  The dispatch
+**   table, the length checks, the statistics rows and the subscriptions
+**   made by RoverAppInit() are all expanded from these lists.
+**
+** Notes:
+**   Adding a message: define its MID in rover_app_msgids.h (and CC and
+**   struct in rover_app_msg.h), write
+**       int32 Handler(const Type *Msg);
+**   and add a ROVER_APP_SCHEMA_MESSAGES row.  Handlers only see messages
+**   whose length passes the row's Length rule.
+**
+*******************************************************************************/
+#ifndef _rover_app_schema_h_
+#define _rover_app_schema_h_
+
+#include "rover_app_msgids.h"
+#include "rover_app_msg.h"
+
+/*
+** Message length rules
+*/
+#define ROVER_APP_LENGTH_EXACT 0 /* sizeof(Type) */
+#define ROVER_APP_LENGTH_MIN   1 /* At least sizeof(Type) */
+
+/*
+** Pipes a MID can be subscribed on
+*/
+#define ROVER_APP_PIPE_COMMAND 0 /* RoverAppData.CommandPipe, main task */
+#define ROVER_APP_PIPE_CONTROL 1 /* RoverAppData.ControlPipe, control task if enabled */
+
+/*
+** Multi-rover mode (rover_app_fleet.h): one command and one odometry MID
+** per fleet vehicle, handled on the control pipe with the HR tick
+*/
+#if ROVER_APP_FLEET_SIZE > 0
+#define ROVER_APP_SCHEMA_FLEET_SUBSCRIPTIONS(X)                                                      \
+    X(ROVER_APP_FLEET_CMD_MID_BASE, ROVER_APP_FLEET_SIZE, ROVER_APP_PIPE_CONTROL, true,              \
+      "Fleet Command")                                                                               \
+    X(ROVER_APP_FLEET_ODOM_MID_BASE, ROVER_APP_FLEET_SIZE, ROVER_APP_PIPE_CONTROL, false,            \
+      "Fleet Odom data")
+#define ROVER_APP_SCHEMA_FLEET_MESSAGES(X)                                                           \
+    X(FLEET_TWIST, ROVER_APP_FLEET_CMD_MID_BASE, ROVER_APP_FLEET_SET_TWIST_CC, RoverAppTwistCmd_t,   \
+      ROVER_APP_LENGTH_EXACT, RoverAppFleetTwistCmd)                                                 \
+    X(FLEET_ODOM, ROVER_APP_FLEET_ODOM_MID_BASE, 0, RoverAppCmdRobotState_t,                         \
+      ROVER_APP_LENGTH_EXACT, RoverAppProcessFleetOdom)
+#else
+#define ROVER_APP_SCHEMA_FLEET_SUBSCRIPTIONS(X)
+#define ROVER_APP_SCHEMA_FLEET_MESSAGES(X)
+#endif
+
+/*
+** Subscriptions: X(MsgId, Count, Pipe, Ground, Name)
+**   Count   - MIDs subscribed, MsgId to MsgId + Count - 1; all of a range
+**             dispatch as MsgId
+**   Ground  - messages are traced as ground commands on dispatch
+**   Name    - used in init error messages
+*/
+#define ROVER_APP_SCHEMA_SUBSCRIPTIONS(X)                                               \
+    X(ROVER_APP_SEND_HK_MID, 1, ROVER_APP_PIPE_COMMAND, false, "HK request")            \
+    X(ROVER_APP_CMD_MID, 1, ROVER_APP_PIPE_COMMAND, true, "Command")                    \
+    X(ROVER_APP_CMD_ODOM_MID, 1, ROVER_APP_PIPE_CONTROL, false, "Odom data")            \
+    X(ROVER_APP_HR_CONTROL_MID, 1, ROVER_APP_PIPE_CONTROL, false, "HR Wakeup Command")  \
+    X(ROVER_APP_SCHED_CMD_MID, 1, ROVER_APP_PIPE_CONTROL, true, "Scheduler Command")    \
+    ROVER_APP_SCHEMA_FLEET_SUBSCRIPTIONS(X)
+
+/*
+** Messages: X(Name, MsgId, FcnCode, Type, Length, Handler)
+**   Name gives the dispatch index ROVER_APP_MSG_<Name>.  Messages without
+**   command codes use 0.
+**   Length  - ROVER_APP_LENGTH_EXACT: the handler sees messages of exactly
+**             sizeof(Type) only.  ROVER_APP_LENGTH_MIN: at least that, for
+**             wakeups and requests with no payload, whose senders may use
+**             either a command or a telemetry header
+*/
+#define ROVER_APP_SCHEMA_MESSAGES(X)                                                                 \
+    X(ODOM, ROVER_APP_CMD_ODOM_MID, 0, RoverAppCmdRobotState_t,                                      \
+      ROVER_APP_LENGTH_EXACT, RoverAppProcessFlightOdom)                                             \
+    X(HR_WAKEUP, ROVER_APP_HR_CONTROL_MID, 0, CFE_MSG_Message_t,                                     \
+      ROVER_APP_LENGTH_MIN, HighRateControLoop)                                                      \
+    X(SEND_HK, ROVER_APP_SEND_HK_MID, 0, CFE_MSG_Message_t,                                          \
+      ROVER_APP_LENGTH_MIN, RoverAppReportHousekeeping)                                              \
+    X(NOOP, ROVER_APP_CMD_MID, ROVER_APP_NOOP_CC, RoverAppNoopCmd_t,                                 \
+      ROVER_APP_LENGTH_EXACT, RoverAppNoop)                                                          \
+    X(SET_TWIST, ROVER_APP_CMD_MID, ROVER_APP_SET_TWIST_CC, RoverAppTwistCmd_t,                      \
+      ROVER_APP_LENGTH_EXACT, RoverAppCmdTwist)                                                      \
+    X(TRACE_DUMP, ROVER_APP_CMD_MID, ROVER_APP_TRACE_DUMP_CC, RoverAppTraceDumpCmd_t,                \
+      ROVER_APP_LENGTH_EXACT, RoverAppTraceDumpCmd)                                                  \
+    X(RESET_DIAG, ROVER_APP_CMD_MID, ROVER_APP_RESET_DIAG_CC, RoverAppResetDiagCmd_t,                \
+      ROVER_APP_LENGTH_EXACT, RoverAppResetDiagCmd)                                                  \
+    X(SEND_STATS, ROVER_APP_CMD_MID, ROVER_APP_SEND_STATS_CC, RoverAppSendStatsCmd_t,                \
+      ROVER_APP_LENGTH_EXACT, RoverAppSendStatsCmd)                                                  \
+    X(TRAJ_LOAD, ROVER_APP_CMD_MID, ROVER_APP_TRAJ_LOAD_CC, RoverAppTrajLoadCmd_t,                   \
+      ROVER_APP_LENGTH_EXACT, RoverAppTrajLoadCmd)                                                   \
+    X(TRAJ_START, ROVER_APP_CMD_MID, ROVER_APP_TRAJ_START_CC, RoverAppTrajStartCmd_t,                \
+      ROVER_APP_LENGTH_EXACT, RoverAppTrajStartCmd)                                                  \
+    X(TRAJ_STOP, ROVER_APP_CMD_MID, ROVER_APP_TRAJ_STOP_CC, RoverAppTrajStopCmd_t,                   \
+      ROVER_APP_LENGTH_EXACT, RoverAppTrajStopCmd)                                                   \
+    X(PATH_LOAD, ROVER_APP_CMD_MID, ROVER_APP_PATH_LOAD_CC, RoverAppPathLoadCmd_t,                   \
+      ROVER_APP_LENGTH_EXACT, RoverAppPathLoadCmd)                                                   \
+    X(PATH_START, ROVER_APP_CMD_MID, ROVER_APP_PATH_START_CC, RoverAppPathStartCmd_t,                \
+      ROVER_APP_LENGTH_EXACT, RoverAppPathStartCmd)                                                  \
+    X(PATH_STOP, ROVER_APP_CMD_MID, ROVER_APP_PATH_STOP_CC, RoverAppPathStopCmd_t,                   \
+      ROVER_APP_LENGTH_EXACT, RoverAppPathStopCmd)                                                   \
+    X(SET_OUTPUT, ROVER_APP_CMD_MID, ROVER_APP_SET_OUTPUT_CC, RoverAppSetOutputCmd_t,                \
+      ROVER_APP_LENGTH_EXACT, RoverAppSetOutputCmd)                                                  \
+    X(SET_EVENT_LIMIT, ROVER_APP_CMD_MID, ROVER_APP_SET_EVENT_LIMIT_CC, RoverAppSetEventLimitCmd_t,  \
+      ROVER_APP_LENGTH_EXACT, RoverAppSetEventLimitCmd)                                              \
+    X(RECORD_START, ROVER_APP_CMD_MID, ROVER_APP_RECORD_START_CC, RoverAppRecordStartCmd_t,          \
+      ROVER_APP_LENGTH_EXACT, RoverAppRecordStartCmd)                                                \
+    X(RECORD_STOP, ROVER_APP_CMD_MID, ROVER_APP_RECORD_STOP_CC, RoverAppRecordStopCmd_t,             \
+      ROVER_APP_LENGTH_EXACT, RoverAppRecordStopCmd)                                                 \
+    X(BLACKBOX_DUMP, ROVER_APP_CMD_MID, ROVER_APP_BLACKBOX_DUMP_CC, RoverAppBlackBoxDumpCmd_t,       \
+      ROVER_APP_LENGTH_EXACT, RoverAppBlackBoxDumpCmd)                                               \
+    X(SCHED_INSERT, ROVER_APP_SCHED_CMD_MID, ROVER_APP_SCHED_INSERT_CC, RoverAppSchedInsertCmd_t,    \
+      ROVER_APP_LENGTH_EXACT, RoverAppSchedInsertCmd)                                                \
+    X(SCHED_LIST, ROVER_APP_SCHED_CMD_MID, ROVER_APP_SCHED_LIST_CC, RoverAppSchedListCmd_t,          \
+      ROVER_APP_LENGTH_EXACT, RoverAppSchedListCmd)                                                  \
+    X(SCHED_FLUSH, ROVER_APP_SCHED_CMD_MID, ROVER_APP_SCHED_FLUSH_CC, RoverAppSchedFlushCmd_t,       \
+      ROVER_APP_LENGTH_EXACT, RoverAppSchedFlushCmd)                                                 \
+    ROVER_APP_SCHEMA_FLEET_MESSAGES(X)
+
+/*
+** Counting helper, usable in #if
+*/
+#define ROVER_APP_SCHEMA_COUNT_ONE(...) +1
+
+#define ROVER_APP_SUBSCRIPTION_COUNT (0 ROVER_APP_SCHEMA_SUBSCRIPTIONS(ROVER_APP_SCHEMA_COUNT_ONE))
+#define ROVER_APP_MSG_COUNT          (0 ROVER_APP_SCHEMA_MESSAGES(ROVER_APP_SCHEMA_COUNT_ONE))
+
+#endif /* _rover_app_schema_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -0,0 +1,158 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_seqlock.h
+**
+** Purpose:
+**   Lock-free publication of odometry and twist state between tasks.
+**
+** Notes:
+**   Each cell has exactly one writer task.  The writer never waits.  A
+**   reader retries at most ROVER_APP_SEQLOCK_MAX_RETRIES times and then
+**   reports failure, so a high priority reader can never spin behind a
+**   preempted low priority writer; it keeps its previous copy instead.
+**   Payloads are copied one 32-bit word at a time with atomic accesses.
+**
+*******************************************************************************/
+#ifndef _rover_app_seqlock_h_
+#define _rover_app_seqlock_h_
+
+#include "cfe.h"
+
+#include "rover_app_msg.h"
+#include "rover_app_platform_cfg.h"
+
+#include <string.h>
+
+#define ROVER_APP_SEQLOCK_WORDS(Type) (sizeof(Type) / sizeof(uint32))
+#define ROVER_APP_SEQLOCK_MAX_WORDS   32 /* Largest payload a reader can copy */
+
+typedef struct
+{
+    uint32 Seq; /* Odd while a write is in progress */
+    union
+    {
+        RoverAppOdometry_t Value;
+        uint32             Words[ROVER_APP_SEQLOCK_WORDS(RoverAppOdometry_t)];
+    } Data;
+} RoverAppOdomCell_t;
+
+typedef struct
+{
+    uint32 Seq; /* Odd while a write is in progress */
+    union
+    {
+        RoverAppTwist_t Value;
+        uint32          Words[ROVER_APP_SEQLOCK_WORDS(RoverAppTwist_t)];
+    } Data;
+} RoverAppTwistCell_t;
+
+/*
+** Generic word-wise seqlock write, single writer
+*/
+static inline void RoverAppSeqLockWrite(uint32 *Seq, uint32 *Dst, const void *Src, uint32 Words)
+{
+    uint32 Start = __atomic_load_n(Seq, __ATOMIC_RELAXED);
+    uint32 Word;
+    uint32 i;
+
+    __atomic_store_n(Seq, Start + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    for (i = 0; i < Words; i++)
+    {
+        memcpy(&Word, (const uint8 *)Src + (i * sizeof(uint32)), sizeof(Word));
+        __atomic_store_n(&Dst[i], Word, __ATOMIC_RELAXED);
+    }
+
+    __atomic_store_n(Seq, Start + 2, __ATOMIC_RELEASE);
+}
+
+/*
+** Generic word-wise seqlock read, returns false if no consistent copy
+** could be taken within the retry budget; Dst is untouched in that case.
+*/
+static inline bool RoverAppSeqLockRead(const uint32 *Seq, const uint32 *Src, void *Dst, uint32 Words)
+{
+    uint32 Copy[ROVER_APP_SEQLOCK_MAX_WORDS];
+    uint32 Before;
+    uint32 After;
+    uint32 Try;
+    uint32 i;
+
+    if (Words > ROVER_APP_SEQLOCK_MAX_WORDS)
+    {
+        return false;
+    }
+
+    for (Try = 0; Try < ROVER_APP_SEQLOCK_MAX_RETRIES; Try++)
+    {
+        Before = __atomic_load_n(Seq, __ATOMIC_ACQUIRE);
+        if (Before & 1)
+        {
+            continue;
+        }
+
+        for (i = 0; i < Words; i++)
+        {
+            Copy[i] = __atomic_load_n(&Src[i], __ATOMIC_RELAXED);
+        }
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        After = __atomic_load_n(Seq, __ATOMIC_RELAXED);
+
+        if (Before == After)
+        {
+            memcpy(Dst, Copy, Words * sizeof(uint32));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+** Typed wrappers
+*/
+static inline void RoverAppOdomPublish(RoverAppOdomCell_t *Cell, const RoverAppOdometry_t *Odom)
+{
+    RoverAppSeqLockWrite(&Cell->Seq, Cell->Data.Words, Odom, ROVER_APP_SEQLOCK_WORDS(RoverAppOdometry_t));
+}
+
+static inline bool RoverAppOdomRead(const RoverAppOdomCell_t *Cell, RoverAppOdometry_t *Odom)
+{
+    return RoverAppSeqLockRead(&Cell->Seq, Cell->Data.Words, Odom, ROVER_APP_SEQLOCK_WORDS(RoverAppOdometry_t));
+}
+
+static inline void RoverAppTwistPublish(RoverAppTwistCell_t *Cell, const RoverAppTwist_t *Twist)
+{
+    RoverAppSeqLockWrite(&Cell->Seq, Cell->Data.Words, Twist, ROVER_APP_SEQLOCK_WORDS(RoverAppTwist_t));
+}
+
+static inline bool RoverAppTwistRead(const RoverAppTwistCell_t *Cell, RoverAppTwist_t *Twist)
+{
+    return RoverAppSeqLockRead(&Cell->Seq, Cell->Data.Words, Twist, ROVER_APP_SEQLOCK_WORDS(RoverAppTwist_t));
+}
+
+#endif /* _rover_app_seqlock_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -0,0 +1,199 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_shape.c
+**
+** Purpose:
+**   Acceleration and jerk limited twist shaping for the rover app.
+**
+** Notes:
+**   Each axis aims for the acceleration that would just bring it to rest
+**   on the commanded velocity, capped at the acceleration limit, and moves
+**   its acceleration toward that by at most J dt per tick.  Coming to rest
+**   from n J dt takes n ticks and changes the velocity by
+**   J dt^2 n (n + 1) / 2, so that is the profile used rather than the
+**   continuous sqrt(2 J |error|), which the discrete ramp lags behind.
+**   The velocity lands on the target with the acceleration at J dt or
+**   less.  Six axes, one square root each: the cost per tick is fixed.
+**
+*******************************************************************************/
+
+/*
+**   Include Files:
+*/
+#include "rover_app_shape.h"
+
+#include <math.h>
+#include <string.h>
+
+#define ROVER_APP_SHAPE_AXES ROVER_APP_PARAMS_AXES
+
+typedef struct
+{
+    float AccelMax[ROVER_APP_SHAPE_AXES]; /* 0 for no limit */
+    float JerkMax[ROVER_APP_SHAPE_AXES];
+
+    float           Velocity[ROVER_APP_SHAPE_AXES]; /* Last twist sent */
+    float           Accel[ROVER_APP_SHAPE_AXES];
+    RoverAppStamp_t LastStamp; /* 0 before the first tick */
+} RoverAppShapeData_t;
+
+static RoverAppShapeData_t RoverAppShapeData;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppShapeInit() -- start from rest with the given limits               */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppShapeInit(const RoverAppParams_t *Params)
+{
+    memset(&RoverAppShapeData, 0, sizeof(RoverAppShapeData));
+    RoverAppShapeConfig(Params);
+
+} /* End of RoverAppShapeInit() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppShapeConfig() -- take the limits, control task only               */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppShapeConfig(const RoverAppParams_t *Params)
+{
+    memcpy(RoverAppShapeData.AccelMax, Params->ShapeAccelMax, sizeof(RoverAppShapeData.AccelMax));
+    memcpy(RoverAppShapeData.JerkMax, Params->ShapeJerkMax, sizeof(RoverAppShapeData.JerkMax));
+
+} /* End of RoverAppShapeConfig() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppShapeSeed() -- ramp on from a twist already being sent, with no    */
+/*                        acceleration, before the first tick                 */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppShapeSeed(const RoverAppTwist_t *Twist)
+{
+    RoverAppShapeData.Velocity[0] = Twist->linear_x;
+    RoverAppShapeData.Velocity[1] = Twist->linear_y;
+    RoverAppShapeData.Velocity[2] = Twist->linear_z;
+    RoverAppShapeData.Velocity[3] = Twist->angular_x;
+    RoverAppShapeData.Velocity[4] = Twist->angular_y;
+    RoverAppShapeData.Velocity[5] = Twist->angular_z;
+    memset(RoverAppShapeData.Accel, 0, sizeof(RoverAppShapeData.Accel));
+
+} /* End of RoverAppShapeSeed() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppShapeStep() -- twist to send this tick, control task only          */
+/*                                                                            */
+/*   The time step is the time since the previous call, at most             */
+/*   ROVER_APP_SHAPE_MAX_STEP_MS.  Twist may be the same as Target.           */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppShapeStep(const RoverAppTwist_t *Target, RoverAppStamp_t Now, RoverAppTwist_t *Twist)
+{
+    RoverAppShapeData_t *Data = &RoverAppShapeData;
+    float                Goal[ROVER_APP_SHAPE_AXES];
+    float                dt;
+    float                Error;
+    float                Want;
+    float                Step;
+    float                v;
+    uint32               j;
+
+    Goal[0] = Target->linear_x;
+    Goal[1] = Target->linear_y;
+    Goal[2] = Target->linear_z;
+    Goal[3] = Target->angular_x;
+    Goal[4] = Target->angular_y;
+    Goal[5] = Target->angular_z;
+
+    dt = (Data->LastStamp != 0 && Now > Data->LastStamp) ? RoverAppStampToSeconds((int64)(Now - Data->LastStamp))
+                                                         : 0.0f;
+    if (dt > (ROVER_APP_SHAPE_MAX_STEP_MS / 1000.0f))
+    {
+        dt = ROVER_APP_SHAPE_MAX_STEP_MS / 1000.0f;
+    }
+    Data->LastStamp = Now;
+
+    for (j = 0; j < ROVER_APP_SHAPE_AXES; j++)
+    {
+        Error = Goal[j] - Data->Velocity[j];
+
+        if (Data->JerkMax[j] > 0.0f)
+        {
+            Step = Data->JerkMax[j] * dt;
+            if (Step <= 0.0f)
+            {
+                continue;
+            }
+
+            /* Acceleration that comes to rest on the target */
+            Want = Step * floorf((sqrtf(1.0f + ((8.0f * fabsf(Error)) / (Step * dt))) - 1.0f) * 0.5f);
+            if (Data->AccelMax[j] > 0.0f && Want > Data->AccelMax[j])
+            {
+                Want = Data->AccelMax[j];
+            }
+            Want = (Error < 0.0f) ? -Want : Want;
+
+            Data->Accel[j] += fmaxf(-Step, fminf(Step, Want - Data->Accel[j]));
+
+            /* Less than the smallest step away: finish */
+            if (fabsf(Error) <= Step * dt && fabsf(Data->Accel[j]) <= Step)
+            {
+                Data->Velocity[j] = Goal[j];
+                Data->Accel[j]    = 0.0f;
+                continue;
+            }
+        }
+        else if (Data->AccelMax[j] > 0.0f)
+        {
+            Data->Accel[j] = (dt > 0.0f) ? fmaxf(-Data->AccelMax[j], fminf(Data->AccelMax[j], Error / dt)) : 0.0f;
+        }
+        else
+        {
+            Data->Velocity[j] = Goal[j];
+            Data->Accel[j]    = 0.0f;
+            continue;
+        }
+
+        v = Data->Velocity[j] + (Data->Accel[j] * dt);
+
+        /* Landing on or going past the target this tick ends the ramp */
+        if ((Error > 0.0f && v >= Goal[j]) || (Error < 0.0f && v <= Goal[j]))
+        {
+            v              = Goal[j];
+            Data->Accel[j] = 0.0f;
+        }
+        Data->Velocity[j] = v;
+    }
+
+    Twist->linear_x  = Data->Velocity[0];
+    Twist->linear_y  = Data->Velocity[1];
+    Twist->linear_z  = Data->Velocity[2];
+    Twist->angular_x = Data->Velocity[3];
+    Twist->angular_y = Data->Velocity[4];
+    Twist->angular_z = Data->Velocity[5];
+
+} /* End of RoverAppShapeStep() */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -0,0 +1,55 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_shape.h
+**
+** Purpose:
+**   Twist shaping: the twist sent to the vehicle ramps to the commanded
+**   one under per-axis acceleration and jerk limits.
+**
+** Notes:
+**   Runs once per HR tick on the task that services the control pipe,
+**   which owns all of its state.  The limits come from RoverAppTable_t
+**   through RoverAppParams_t, 0 disables a limit, and both 0 passes the
+**   command straight through.
+**
+*******************************************************************************/
+#ifndef _rover_app_shape_h_
+#define _rover_app_shape_h_
+
+#include "cfe.h"
+
+#include "rover_app_history.h"
+#include "rover_app_msg.h"
+#include "rover_app_params.h"
+
+/*
+** Exported functions
+*/
+void RoverAppShapeInit(const RoverAppParams_t *Params);
+void RoverAppShapeConfig(const RoverAppParams_t *Params);
+void RoverAppShapeSeed(const RoverAppTwist_t *Twist);
+void RoverAppShapeStep(const RoverAppTwist_t *Target, RoverAppStamp_t Now, RoverAppTwist_t *Twist);
+
+#endif /* _rover_app_shape_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -0,0 +1,210 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_stats.c
+**
+** Purpose:
+**   Per message ID / command code statistics for the rover app.
+**
+** Notes:
+**   Counters live in the telemetry packet itself; only the 64-bit time
+**   sums are kept aside.  Entries are indexed like the dispatch table,
+**   with one more for messages it does not know.  That one can be hit
+**   from both pipes, so it is the only entry updated atomically.  The
+**   report reads entries other tasks may be updating; a sample landing
+**   mid-report may be counted in some fields only.
+**
+*******************************************************************************/
+
+/*
+** Include Files:
+*/
+#include "rover_app_stats.h"
+#include "rover_app_dispatch.h"
+#include "rover_app_msgids.h"
+
+#include <string.h>
+
+#if ROVER_APP_MSG_COUNT + 1 > ROVER_APP_STATS_MAX_ENTRIES
+#error ROVER_APP_STATS_MAX_ENTRIES too small for the messages in rover_app_schema.h
+#endif
+
+/* Entry of everything the dispatch table does not know */
+#define ROVER_APP_STATS_OTHER ROVER_APP_MSG_COUNT
+
+typedef struct
+{
+    uint64 TotalNs[ROVER_APP_STATS_MAX_ENTRIES];
+
+    RoverAppStatsTlm_t Tlm;
+} RoverAppStatsData_t;
+
+static RoverAppStatsData_t RoverAppStatsData;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppStatsRaiseMax() -- atomically raise *Max to Value                  */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void RoverAppStatsRaiseMax(uint32 *Max, uint32 Value)
+{
+    uint32 Old = __atomic_load_n(Max, __ATOMIC_RELAXED);
+
+    do
+    {
+        if (Value <= Old)
+        {
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(Max, &Old, Value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+} /* End of RoverAppStatsRaiseMax() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppStatsInit() -- lay out the table                                   */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppStatsInit(void)
+{
+    RoverAppStatsTlmPayload_t *Payload = &RoverAppStatsData.Tlm.Payload;
+    uint32                     i;
+
+    memset(&RoverAppStatsData, 0, sizeof(RoverAppStatsData));
+
+    CFE_MSG_Init(&RoverAppStatsData.Tlm.TlmHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_STATS_TLM_MID),
+                 sizeof(RoverAppStatsData.Tlm));
+
+    for (i = 0; i < ROVER_APP_MSG_COUNT; i++)
+    {
+        Payload->Entry[i].MsgId   = RoverAppDispatchTable[i].MsgId;
+        Payload->Entry[i].FcnCode = RoverAppDispatchTable[i].FcnCode;
+    }
+
+    Payload->Entry[ROVER_APP_STATS_OTHER].MsgId = ROVER_APP_STATS_OTHER_MID;
+    Payload->EntryCount                         = ROVER_APP_STATS_OTHER + 1;
+
+} /* End of RoverAppStatsInit() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppStatsReceived() -- count a message off a pipe                      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppStatsReceived(uint32 Index, const CFE_MSG_Message_t *MsgPtr)
+{
+    RoverAppMsgStats_t *Entry;
+    CFE_MSG_Size_t      Size = 0;
+
+    CFE_MSG_GetSize(MsgPtr, &Size);
+
+    if (Index >= ROVER_APP_STATS_OTHER)
+    {
+        Entry = &RoverAppStatsData.Tlm.Payload.Entry[ROVER_APP_STATS_OTHER];
+        __atomic_fetch_add(&Entry->MsgCount, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&Entry->ByteCount, (uint32)Size, __ATOMIC_RELAXED);
+        return;
+    }
+
+    Entry = &RoverAppStatsData.Tlm.Payload.Entry[Index];
+    Entry->MsgCount++;
+    Entry->ByteCount += (uint32)Size;
+
+} /* End of RoverAppStatsReceived() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppStatsProcessed() -- add a processing time to an entry              */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppStatsProcessed(uint32 Index, RoverAppStamp_t Start, RoverAppStamp_t End)
+{
+    RoverAppMsgStats_t *Entry;
+    uint64              Ns;
+    uint32              MaxNs;
+
+    if (End < Start)
+    {
+        return;
+    }
+
+    Ns    = RoverAppStampToNs(End - Start);
+    MaxNs = (Ns > 0xFFFFFFFFULL) ? 0xFFFFFFFFU : (uint32)Ns;
+
+    if (Index >= ROVER_APP_STATS_OTHER)
+    {
+        __atomic_fetch_add(&RoverAppStatsData.TotalNs[ROVER_APP_STATS_OTHER], Ns, __ATOMIC_RELAXED);
+        RoverAppStatsRaiseMax(&RoverAppStatsData.Tlm.Payload.Entry[ROVER_APP_STATS_OTHER].MaxNs, MaxNs);
+        return;
+    }
+
+    Entry = &RoverAppStatsData.Tlm.Payload.Entry[Index];
+
+    RoverAppStatsData.TotalNs[Index] += Ns;
+    if (MaxNs > Entry->MaxNs)
+    {
+        Entry->MaxNs = MaxNs;
+    }
+
+} /* End of RoverAppStatsProcessed() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppStatsLengthError() -- count a message rejected for its length      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppStatsLengthError(uint32 Index)
+{
+    if (Index >= ROVER_APP_STATS_OTHER)
+    {
+        __atomic_fetch_add(&RoverAppStatsData.Tlm.Payload.Entry[ROVER_APP_STATS_OTHER].LenErrCount, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    RoverAppStatsData.Tlm.Payload.Entry[Index].LenErrCount++;
+
+} /* End of RoverAppStatsLengthError() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppStatsReport() -- send the statistics packet                        */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppStatsReport(void)
+{
+    RoverAppStatsTlmPayload_t *Payload = &RoverAppStatsData.Tlm.Payload;
+    uint64                     TotalUs;
+    uint32                     i;
+
+    for (i = 0; i < Payload->EntryCount; i++)
+    {
+        TotalUs                  = __atomic_load_n(&RoverAppStatsData.TotalNs[i], __ATOMIC_RELAXED) / 1000;
+        Payload->Entry[i].TotalUs = (TotalUs > 0xFFFFFFFFULL) ? 0xFFFFFFFFU : (uint32)TotalUs;
+    }
+
+    CFE_SB_TimeStampMsg(&RoverAppStatsData.Tlm.TlmHeader.Msg);
+
+    return CFE_SB_TransmitMsg(&RoverAppStatsData.Tlm.TlmHeader.Msg, true);
+
+} /* End of RoverAppStatsReport() */
+
+/************************/
+/*  End of File Comment */
+/************************/
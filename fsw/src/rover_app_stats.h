@@ -0,0 +1,56 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_stats.h
+**
+** Purpose:
+**   Per message ID / command code traffic and processing statistics.
+**
+** Notes:
+**   Every (MID, CC) in rover_app_schema.h gets its entry at init, so the
+**   table never changes shape at run time and each entry is only written
+**   by the task whose pipe carries that MID.  Entries are addressed by
+**   dispatch index (see RoverAppDispatchLookup()); anything else lands in
+**   the ROVER_APP_STATS_OTHER_MID entry, which both tasks may write and
+**   which is therefore updated atomically.
+**
+*******************************************************************************/
+#ifndef _rover_app_stats_h_
+#define _rover_app_stats_h_
+
+#include "cfe.h"
+
+#include "rover_app_history.h"
+#include "rover_app_msg.h"
+
+/*
+** Exported functions
+*/
+void  RoverAppStatsInit(void);
+void  RoverAppStatsReceived(uint32 Index, const CFE_MSG_Message_t *MsgPtr);
+void  RoverAppStatsProcessed(uint32 Index, RoverAppStamp_t Start, RoverAppStamp_t End);
+void  RoverAppStatsLengthError(uint32 Index);
+int32 RoverAppStatsReport(void);
+
+#endif /* _rover_app_stats_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -0,0 +1,386 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_trace.c
+**
+** Purpose:
+**   Binary trace logger for the rover app.
+**
+** Notes:
+**   Producers reserve a slot with an atomic increment of the head index
+**   and publish the record by writing its sequence number last, so any
+**   task may trace without locks or system calls.  There is a single
+**   consumer (the drain task, or the dump command when the task is
+**   disabled); records it falls behind on are overwritten and reported
+**   as a ROVER_APP_TRACE_PT_LOST record.
+**
+*******************************************************************************/
+
+/*
+** Include Files:
+*/
+#include "rover_app_events.h"
+#include "rover_app_evlimit.h"
+#include "rover_app.h"
+#include "rover_app_trace.h"
+
+#include <string.h>
+
+#define ROVER_APP_TRACE_RING_MASK   (ROVER_APP_TRACE_RING_SIZE - 1)
+#define ROVER_APP_TRACE_DRAIN_BLOCK 128 /* Records per OS_write() */
+
+typedef struct
+{
+    RoverAppTraceRecord_t Ring[ROVER_APP_TRACE_RING_SIZE];
+
+    uint32 Head; /* Next index to reserve, shared by all producers */
+    uint32 Tail; /* Next index to drain, consumer only */
+    uint32 Lost; /* Overwritten records not reported yet, consumer only */
+
+    RoverAppTraceRecord_t Block[ROVER_APP_TRACE_DRAIN_BLOCK];
+
+    /* Drain task */
+    CFE_ES_TaskId_t TaskId;
+    bool            SwitchPending;
+    char            SwitchFilename[CFE_MISSION_MAX_PATH_LEN];
+} RoverAppTraceData_t;
+
+static RoverAppTraceData_t RoverAppTraceData;
+
+extern RoverAppData_t RoverAppData;
+
+#if ROVER_APP_TRACE_TASK_ENABLE
+static void RoverAppTraceTask(void);
+#endif
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTraceInit() -- reset the ring and start the drain task             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppTraceInit(void)
+{
+    int32 status = CFE_SUCCESS;
+
+    memset(&RoverAppTraceData, 0, sizeof(RoverAppTraceData));
+
+#if ROVER_APP_TRACE_TASK_ENABLE
+    status = CFE_ES_CreateChildTask(&RoverAppTraceData.TaskId, "ROVER_APP_TRACE", RoverAppTraceTask,
+                                    CFE_ES_TASK_STACK_ALLOCATE, ROVER_APP_TRACE_TASK_STACK_SIZE,
+                                    ROVER_APP_TRACE_TASK_PRIORITY, 0);
+    if (status != CFE_SUCCESS)
+    {
+        CFE_ES_WriteToSysLog("Rover App: Error creating trace task, RC = 0x%08lX\n", (unsigned long)status);
+    }
+#endif
+
+    return status;
+
+} /* End of RoverAppTraceInit() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTraceAdd() -- append one record, safe from any task                */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppTraceAdd(uint8 Level, uint8 Point, uint16 MsgId, uint8 FcnCode, uint16 Length, int32 Status)
+{
+    RoverAppTraceRecord_t *Rec;
+    CFE_TIME_SysTime_t     Time;
+    uint32                 Index;
+
+    Index = __atomic_fetch_add(&RoverAppTraceData.Head, 1, __ATOMIC_RELAXED);
+    Rec   = &RoverAppTraceData.Ring[Index & ROVER_APP_TRACE_RING_MASK];
+
+    /* Mark the slot busy before touching the payload */
+    __atomic_store_n(&Rec->Seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    Time = CFE_TIME_GetTime();
+
+    Rec->Seconds    = Time.Seconds;
+    Rec->Subseconds = Time.Subseconds;
+    Rec->Status     = Status;
+    Rec->MsgId      = MsgId;
+    Rec->Length     = Length;
+    Rec->FcnCode    = FcnCode;
+    Rec->Point      = Point;
+    Rec->Level      = Level;
+    Rec->Spare      = 0;
+
+    __atomic_store_n(&Rec->Seq, Index + 1, __ATOMIC_RELEASE);
+
+} /* End of RoverAppTraceAdd() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTraceMsg() -- append one record describing a message               */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppTraceMsg(uint8 Level, uint8 Point, const CFE_MSG_Message_t *MsgPtr, int32 Status)
+{
+    CFE_SB_MsgId_t    MsgId   = CFE_SB_INVALID_MSG_ID;
+    CFE_MSG_FcnCode_t FcnCode = 0;
+    size_t            Size    = 0;
+
+    CFE_MSG_GetMsgId(MsgPtr, &MsgId);
+    CFE_MSG_GetFcnCode(MsgPtr, &FcnCode);
+    CFE_MSG_GetSize(MsgPtr, &Size);
+
+    RoverAppTraceAdd(Level, Point, (uint16)CFE_SB_MsgIdToValue(MsgId), (uint8)FcnCode, (uint16)Size, Status);
+
+} /* End of RoverAppTraceMsg() */
+
+/*
+** Copy up to Max published records out of the ring (consumer side)
+*/
+static uint32 RoverAppTraceCollect(RoverAppTraceRecord_t *Out, uint32 Max)
+{
+    RoverAppTraceRecord_t *Rec;
+    uint32                 Head;
+    uint32                 Seq;
+    uint32                 Count = 0;
+
+    Head = __atomic_load_n(&RoverAppTraceData.Head, __ATOMIC_ACQUIRE);
+
+    /* Producers lapped us: everything older than one ring is gone */
+    if (Head - RoverAppTraceData.Tail > ROVER_APP_TRACE_RING_SIZE)
+    {
+        RoverAppTraceData.Lost += Head - RoverAppTraceData.Tail - ROVER_APP_TRACE_RING_SIZE;
+        RoverAppTraceData.Tail = Head - ROVER_APP_TRACE_RING_SIZE;
+    }
+
+    if (RoverAppTraceData.Lost != 0 && Max > 0)
+    {
+        memset(&Out[0], 0, sizeof(Out[0]));
+        Out[0].Point  = ROVER_APP_TRACE_PT_LOST;
+        Out[0].Status = (int32)RoverAppTraceData.Lost;
+        RoverAppTraceData.Lost = 0;
+        Count++;
+    }
+
+    while (RoverAppTraceData.Tail != Head && Count < Max)
+    {
+        Rec = &RoverAppTraceData.Ring[RoverAppTraceData.Tail & ROVER_APP_TRACE_RING_MASK];
+        Seq = __atomic_load_n(&Rec->Seq, __ATOMIC_ACQUIRE);
+
+        if (Seq != RoverAppTraceData.Tail + 1)
+        {
+            if ((int32)(Seq - (RoverAppTraceData.Tail + 1)) > 0)
+            {
+                /* Already overwritten by a later lap */
+                RoverAppTraceData.Lost++;
+                RoverAppTraceData.Tail++;
+                continue;
+            }
+
+            /* Still being written; pick it up next time */
+            break;
+        }
+
+        Out[Count] = *Rec;
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&Rec->Seq, __ATOMIC_RELAXED) != Seq)
+        {
+            /* Overwritten while we copied it */
+            RoverAppTraceData.Lost++;
+            RoverAppTraceData.Tail++;
+            continue;
+        }
+
+        Count++;
+        RoverAppTraceData.Tail++;
+    }
+
+    return Count;
+}
+
+/*
+** Drain everything currently published to an open file
+*/
+static int32 RoverAppTraceWrite(osal_id_t Fd, uint32 *RecordCount)
+{
+    uint32 Count;
+    size_t Bytes;
+
+    while ((Count = RoverAppTraceCollect(RoverAppTraceData.Block, ROVER_APP_TRACE_DRAIN_BLOCK)) > 0)
+    {
+        Bytes = Count * sizeof(RoverAppTraceRecord_t);
+        if (OS_write(Fd, RoverAppTraceData.Block, Bytes) != (int32)Bytes)
+        {
+            return OS_ERROR;
+        }
+
+        *RecordCount += Count;
+    }
+
+    return OS_SUCCESS;
+}
+
+static int32 RoverAppTraceOpen(osal_id_t *Fd, const char *Filename)
+{
+    RoverAppTraceFileHdr_t Hdr;
+    int32                  status;
+
+    status = OS_OpenCreate(Fd, Filename, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_WRITE_ONLY);
+    if (status != OS_SUCCESS)
+    {
+        return status;
+    }
+
+    Hdr.Magic      = ROVER_APP_TRACE_FILE_MAGIC;
+    Hdr.Version    = ROVER_APP_TRACE_FILE_VERSION;
+    Hdr.RecordSize = sizeof(RoverAppTraceRecord_t);
+
+    if (OS_write(*Fd, &Hdr, sizeof(Hdr)) != (int32)sizeof(Hdr))
+    {
+        OS_close(*Fd);
+        return OS_ERROR;
+    }
+
+    return OS_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTraceDump() -- write the ring to a file                            */
+/*                                                                            */
+/*   With the drain task running, this switches its output file instead.     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppTraceDump(const char *Filename)
+{
+    if (Filename == NULL || Filename[0] == '\0')
+    {
+        Filename = ROVER_APP_TRACE_FILE;
+    }
+
+#if ROVER_APP_TRACE_TASK_ENABLE
+    if (__atomic_load_n(&RoverAppTraceData.SwitchPending, __ATOMIC_ACQUIRE))
+    {
+        ROVER_APP_EVENT(ROVER_APP_TRACE_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: trace file switch already pending");
+        return OS_ERROR;
+    }
+
+    strncpy(RoverAppTraceData.SwitchFilename, Filename, sizeof(RoverAppTraceData.SwitchFilename) - 1);
+    RoverAppTraceData.SwitchFilename[sizeof(RoverAppTraceData.SwitchFilename) - 1] = 0;
+    __atomic_store_n(&RoverAppTraceData.SwitchPending, true, __ATOMIC_RELEASE);
+
+    return CFE_SUCCESS;
+#else
+    osal_id_t Fd;
+    uint32    RecordCount = 0;
+    int32     status;
+
+    status = RoverAppTraceOpen(&Fd, Filename);
+    if (status != OS_SUCCESS)
+    {
+        ROVER_APP_EVENT(ROVER_APP_TRACE_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: error creating trace file %s, RC = %d", Filename, (int)status);
+        return status;
+    }
+
+    status = RoverAppTraceWrite(Fd, &RecordCount);
+    OS_close(Fd);
+
+    if (status != OS_SUCCESS)
+    {
+        ROVER_APP_EVENT(ROVER_APP_TRACE_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: error writing trace file %s", Filename);
+        return status;
+    }
+
+    ROVER_APP_EVENT(ROVER_APP_TRACE_DUMP_INF_EID, CFE_EVS_EventType_INFORMATION,
+                    "rover app: dumped %u trace records to %s", (unsigned int)RecordCount, Filename);
+
+    return CFE_SUCCESS;
+#endif
+
+} /* End of RoverAppTraceDump() */
+
+#if ROVER_APP_TRACE_TASK_ENABLE
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTraceTask() -- low priority child task streaming the ring          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void RoverAppTraceTask(void)
+{
+    osal_id_t Fd;
+    bool      FileOpen;
+    uint32    RecordCount = 0;
+
+    FileOpen = (RoverAppTraceOpen(&Fd, ROVER_APP_TRACE_FILE) == OS_SUCCESS);
+    if (!FileOpen)
+    {
+        ROVER_APP_EVENT(ROVER_APP_TRACE_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: error creating trace file %s", ROVER_APP_TRACE_FILE);
+    }
+
+    while (RoverAppData.RunStatus == CFE_ES_RunStatus_APP_RUN)
+    {
+        OS_TaskDelay(ROVER_APP_TRACE_TASK_PERIOD_MS);
+
+        if (__atomic_load_n(&RoverAppTraceData.SwitchPending, __ATOMIC_ACQUIRE))
+        {
+            if (FileOpen)
+            {
+                RoverAppTraceWrite(Fd, &RecordCount);
+                OS_close(Fd);
+            }
+
+            FileOpen = (RoverAppTraceOpen(&Fd, RoverAppTraceData.SwitchFilename) == OS_SUCCESS);
+            if (FileOpen)
+            {
+                ROVER_APP_EVENT(ROVER_APP_TRACE_DUMP_INF_EID, CFE_EVS_EventType_INFORMATION,
+                                "rover app: %u trace records written, now tracing to %s",
+                                (unsigned int)RecordCount, RoverAppTraceData.SwitchFilename);
+            }
+            else
+            {
+                ROVER_APP_EVENT(ROVER_APP_TRACE_ERR_EID, CFE_EVS_EventType_ERROR,
+                                "rover app: error creating trace file %s", RoverAppTraceData.SwitchFilename);
+            }
+
+            RecordCount = 0;
+            __atomic_store_n(&RoverAppTraceData.SwitchPending, false, __ATOMIC_RELEASE);
+        }
+
+        if (FileOpen && RoverAppTraceWrite(Fd, &RecordCount) != OS_SUCCESS)
+        {
+            ROVER_APP_EVENT(ROVER_APP_TRACE_ERR_EID, CFE_EVS_EventType_ERROR,
+                            "rover app: error writing trace file, tracing to file stopped");
+            OS_close(Fd);
+            FileOpen = false;
+        }
+    }
+
+    if (FileOpen)
+    {
+        RoverAppTraceWrite(Fd, &RecordCount);
+        OS_close(Fd);
+    }
+
+    CFE_ES_ExitChildTask();
+
+} /* End of RoverAppTraceTask() */
+#endif
@@ -0,0 +1,119 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_trace.h
+**
+** Purpose:
+**   Binary trace logger.  Fixed-size records go into a lock-free ring
+**   that is drained to a file by a low priority child task or on command.
+**
+** Notes:
+**   Trace points above ROVER_APP_TRACE_LEVEL compile to nothing.
+**
+*******************************************************************************/
+#ifndef _rover_app_trace_h_
+#define _rover_app_trace_h_
+
+#include "cfe.h"
+
+#include "rover_app_platform_cfg.h"
+
+/*
+** Trace levels
+*/
+#define ROVER_APP_TRACE_LEVEL_OFF   0
+#define ROVER_APP_TRACE_LEVEL_ERROR 1
+#define ROVER_APP_TRACE_LEVEL_INFO  2
+#define ROVER_APP_TRACE_LEVEL_DEBUG 3
+
+/*
+** Trace points
+*/
+#define ROVER_APP_TRACE_PT_LOST       0 /* Status holds the number of records overwritten */
+#define ROVER_APP_TRACE_PT_GROUND_CMD 1
+#define ROVER_APP_TRACE_PT_ODOM       2
+#define ROVER_APP_TRACE_PT_HK         3 /* Status holds the reported command counter */
+#define ROVER_APP_TRACE_PT_LEN_ERR    4 /* Status holds the expected length */
+#define ROVER_APP_TRACE_PT_HR_TICK    5
+
+#define ROVER_APP_TRACE_FILE_MAGIC   0x52565452 /* "RVTR" */
+#define ROVER_APP_TRACE_FILE_VERSION 1
+
+#if (ROVER_APP_TRACE_RING_SIZE & (ROVER_APP_TRACE_RING_SIZE - 1)) != 0
+#error ROVER_APP_TRACE_RING_SIZE must be a power of two
+#endif
+
+/*
+** Fixed-size trace record, as stored in the ring and in trace files
+*/
+typedef struct
+{
+    uint32 Seq;        /* Ring index + 1, zero while the record is being written */
+    uint32 Seconds;
+    uint32 Subseconds;
+    int32  Status;
+    uint16 MsgId;
+    uint16 Length;
+    uint8  FcnCode;
+    uint8  Point;
+    uint8  Level;
+    uint8  Spare;
+} RoverAppTraceRecord_t;
+
+typedef struct
+{
+    uint32 Magic;
+    uint16 Version;
+    uint16 RecordSize;
+} RoverAppTraceFileHdr_t;
+
+#define ROVER_APP_TRACE_ENABLED(Level) (ROVER_APP_TRACE_LEVEL >= (Level))
+
+#define ROVER_APP_TRACE(Level, Point, MsgId, FcnCode, Length, Status)           \
+    do                                                                          \
+    {                                                                           \
+        if (ROVER_APP_TRACE_ENABLED(Level))                                     \
+        {                                                                       \
+            RoverAppTraceAdd((Level), (Point), (MsgId), (FcnCode), (Length), (Status)); \
+        }                                                                       \
+    } while (0)
+
+#define ROVER_APP_TRACE_MSG(Level, Point, MsgPtr, Status)        \
+    do                                                           \
+    {                                                            \
+        if (ROVER_APP_TRACE_ENABLED(Level))                      \
+        {                                                        \
+            RoverAppTraceMsg((Level), (Point), (MsgPtr), (Status)); \
+        }                                                        \
+    } while (0)
+
+/*
+** Exported functions
+*/
+int32 RoverAppTraceInit(void);
+void  RoverAppTraceAdd(uint8 Level, uint8 Point, uint16 MsgId, uint8 FcnCode, uint16 Length, int32 Status);
+void  RoverAppTraceMsg(uint8 Level, uint8 Point, const CFE_MSG_Message_t *MsgPtr, int32 Status);
+int32 RoverAppTraceDump(const char *Filename);
+
+#endif /* _rover_app_trace_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
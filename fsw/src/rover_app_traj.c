@@ -0,0 +1,408 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_traj.c
+**
+** Purpose:
+**   Uploaded twist trajectories for the rover app.
+**
+** Notes:
+**   Segments are monotone cubic Hermite (Fritsch-Butland slopes): C1, and
+**   never overshooting the knots, so a velocity between two setpoints
+**   stays between them.  The control loop caches the segment it used
+**   last, so evaluation walks forward at most a segment or two per tick.
+**
+*******************************************************************************/
+
+/*
+** Include Files:
+*/
+#include "rover_app_events.h"
+#include "rover_app_evlimit.h"
+#include "rover_app_traj.h"
+
+#include <math.h>
+#include <string.h>
+
+#define ROVER_APP_TRAJ_AXES 6
+
+typedef struct
+{
+    RoverAppTraj_t Slot[ROVER_APP_TRAJ_SLOTS];
+
+    /* Command task */
+    RoverAppTrajKnot_t Staged[ROVER_APP_TRAJ_MAX_KNOTS];
+    uint32             StagedCount;
+    uint8              Active;  /* Slot the control loop runs, ROVER_APP_TRAJ_NONE when idle */
+    uint8              Started; /* Slot of the last start, the next one builds the other */
+
+    float Value[ROVER_APP_TRAJ_AXES][ROVER_APP_TRAJ_MAX_KNOTS]; /* RoverAppTrajBuild() scratch */
+    float Width[ROVER_APP_TRAJ_MAX_KNOTS];
+
+    /* Control task */
+    uint8  Acked;   /* Last Active the control loop picked up */
+    uint32 Segment; /* Segment of Slot[Acked] used on the previous tick */
+} RoverAppTrajData_t;
+
+static RoverAppTrajData_t RoverAppTrajData;
+
+/*
+** RoverAppTwist_t as an array of axes
+*/
+static inline void RoverAppTrajAxes(const RoverAppTwist_t *Twist, float *Axis)
+{
+    Axis[0] = Twist->linear_x;
+    Axis[1] = Twist->linear_y;
+    Axis[2] = Twist->linear_z;
+    Axis[3] = Twist->angular_x;
+    Axis[4] = Twist->angular_y;
+    Axis[5] = Twist->angular_z;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTrajSlope() -- Hermite slope at knot k on one axis                 */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static float RoverAppTrajSlope(const float *Value, const float *Width, uint32 k, uint32 Count)
+{
+    float d0;
+    float d1;
+
+    if (k == 0)
+    {
+        return (Value[1] - Value[0]) / Width[0];
+    }
+    if (k == Count - 1)
+    {
+        return (Value[k] - Value[k - 1]) / Width[k - 1];
+    }
+
+    d0 = (Value[k] - Value[k - 1]) / Width[k - 1];
+    d1 = (Value[k + 1] - Value[k]) / Width[k];
+
+    /* Flat at local extrema keeps the segment inside its knots */
+    if ((d0 * d1) <= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    return (3.0f * (Width[k - 1] + Width[k])) /
+           ((((2.0f * Width[k]) + Width[k - 1]) / d0) + ((Width[k] + (2.0f * Width[k - 1])) / d1));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTrajBuild() -- knots to segment coefficients                       */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void RoverAppTrajBuild(RoverAppTraj_t *Traj, const RoverAppTrajKnot_t *Knot, uint32 Count)
+{
+    float (*Value)[ROVER_APP_TRAJ_MAX_KNOTS] = RoverAppTrajData.Value;
+    float *Width                             = RoverAppTrajData.Width;
+    float  Axis[ROVER_APP_TRAJ_AXES];
+    float  m0;
+    float  m1;
+    float  d;
+    float  h;
+    uint32 j;
+    uint32 k;
+
+    memset(Traj->Segment, 0, sizeof(Traj->Segment));
+    Traj->KnotCount = Count;
+
+    for (k = 0; k < Count; k++)
+    {
+        Traj->Knot[k] = (((RoverAppStamp_t)Knot[k].TimeMs) << 32) / 1000;
+        Width[k]      = (k + 1 < Count) ? (0.001f * (float)(Knot[k + 1].TimeMs - Knot[k].TimeMs)) : 0.0f;
+
+        RoverAppTrajAxes(&Knot[k].twist, Axis);
+        for (j = 0; j < ROVER_APP_TRAJ_AXES; j++)
+        {
+            Value[j][k] = Axis[j];
+        }
+    }
+
+    for (j = 0; j < ROVER_APP_TRAJ_AXES; j++)
+    {
+        m1 = RoverAppTrajSlope(Value[j], Width, 0, Count);
+
+        for (k = 0; k + 1 < Count; k++)
+        {
+            h  = Width[k];
+            d  = (Value[j][k + 1] - Value[j][k]) / h;
+            m0 = m1;
+            m1 = RoverAppTrajSlope(Value[j], Width, k + 1, Count);
+
+            Traj->Segment[k].A[j] = Value[j][k];
+            Traj->Segment[k].B[j] = m0;
+            Traj->Segment[k].C[j] = ((3.0f * d) - (2.0f * m0) - m1) / h;
+            Traj->Segment[k].D[j] = (m0 + m1 - (2.0f * d)) / (h * h);
+        }
+
+        /* Held after the last knot */
+        Traj->Segment[Count - 1].A[j] = Value[j][Count - 1];
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTrajInit() -- no trajectory, nothing staged                        */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppTrajInit(void)
+{
+    memset(&RoverAppTrajData, 0, sizeof(RoverAppTrajData));
+
+    RoverAppTrajData.Active  = ROVER_APP_TRAJ_NONE;
+    RoverAppTrajData.Started = ROVER_APP_TRAJ_NONE;
+    RoverAppTrajData.Acked   = ROVER_APP_TRAJ_NONE;
+
+} /* End of RoverAppTrajInit() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTrajLoad() -- append a command's knots to the staging area         */
+/*                                                                            */
+/*   The whole command is rejected if any of its knots is bad; what was      */
+/*   staged before it is kept, so it can be sent again.                      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppTrajLoad(const RoverAppTrajLoadCmd_t *Cmd)
+{
+    const RoverAppTrajKnot_t *Knot;
+    uint32                    Staged;
+    uint32                    PrevMs = 0;
+    float                     Axis[ROVER_APP_TRAJ_AXES];
+    uint32                    i;
+    uint32                    j;
+
+    Staged = (Cmd->FirstKnot == 0) ? 0 : RoverAppTrajData.StagedCount;
+
+    if (Cmd->FirstKnot != Staged)
+    {
+        ROVER_APP_EVENT(ROVER_APP_TRAJ_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: trajectory knot %u out of order, %u staged", (unsigned int)Cmd->FirstKnot,
+                        (unsigned int)Staged);
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    if (Cmd->KnotCount > ROVER_APP_TRAJ_KNOTS_PER_CMD || Staged + Cmd->KnotCount > ROVER_APP_TRAJ_MAX_KNOTS)
+    {
+        ROVER_APP_EVENT(ROVER_APP_TRAJ_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: trajectory too long, %u + %u knots, max %u", (unsigned int)Staged,
+                        (unsigned int)Cmd->KnotCount, (unsigned int)ROVER_APP_TRAJ_MAX_KNOTS);
+        return CFE_STATUS_RANGE_ERROR;
+    }
+
+    for (i = 0; i < Cmd->KnotCount; i++)
+    {
+        Knot = &Cmd->Knot[i];
+
+        if (i > 0)
+        {
+            PrevMs = Cmd->Knot[i - 1].TimeMs;
+        }
+        else if (Staged > 0)
+        {
+            PrevMs = RoverAppTrajData.Staged[Staged - 1].TimeMs;
+        }
+
+        if ((Staged + i) > 0 && Knot->TimeMs <= PrevMs)
+        {
+            ROVER_APP_EVENT(ROVER_APP_TRAJ_ERR_EID, CFE_EVS_EventType_ERROR,
+                            "rover app: trajectory knot %u time %u ms not after %u ms", (unsigned int)(Staged + i),
+                            (unsigned int)Knot->TimeMs, (unsigned int)PrevMs);
+            return CFE_STATUS_VALIDATION_FAILURE;
+        }
+
+        RoverAppTrajAxes(&Knot->twist, Axis);
+        for (j = 0; j < ROVER_APP_TRAJ_AXES; j++)
+        {
+            if (!isfinite(Axis[j]))
+            {
+                ROVER_APP_EVENT(ROVER_APP_TRAJ_ERR_EID, CFE_EVS_EventType_ERROR,
+                                "rover app: trajectory knot %u is not finite", (unsigned int)(Staged + i));
+                return CFE_STATUS_VALIDATION_FAILURE;
+            }
+        }
+    }
+
+    memcpy(&RoverAppTrajData.Staged[Staged], Cmd->Knot, Cmd->KnotCount * sizeof(Cmd->Knot[0]));
+    RoverAppTrajData.StagedCount = Staged + Cmd->KnotCount;
+
+    return CFE_SUCCESS;
+
+} /* End of RoverAppTrajLoad() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTrajStart() -- run the staged knots from Start on                  */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 RoverAppTrajStart(RoverAppStamp_t Start)
+{
+    RoverAppTraj_t *Traj;
+    uint8           Active;
+    uint8           Slot;
+
+    if (RoverAppTrajData.StagedCount < 2)
+    {
+        ROVER_APP_EVENT(ROVER_APP_TRAJ_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: trajectory needs at least 2 knots, %u staged",
+                        (unsigned int)RoverAppTrajData.StagedCount);
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    /*
+    ** Once the control loop has acknowledged the current slot it never
+    ** touches the other one until told to.  That is the other one from
+    ** the last start, not from Active: after a stop both read NONE while
+    ** the loop may still be running the slot it last picked up.
+    */
+    Active = RoverAppTrajData.Active;
+    if (__atomic_load_n(&RoverAppTrajData.Acked, __ATOMIC_ACQUIRE) != Active)
+    {
+        ROVER_APP_EVENT(ROVER_APP_TRAJ_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "rover app: previous trajectory change not yet applied by the control loop");
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    Slot = (RoverAppTrajData.Started == 0) ? 1 : 0;
+    Traj = &RoverAppTrajData.Slot[Slot];
+
+    RoverAppTrajBuild(Traj, RoverAppTrajData.Staged, RoverAppTrajData.StagedCount);
+    Traj->Start = Start;
+
+    RoverAppTrajData.Started = Slot;
+    __atomic_store_n(&RoverAppTrajData.Active, Slot, __ATOMIC_RELEASE);
+
+    ROVER_APP_EVENT(ROVER_APP_TRAJ_INF_EID, CFE_EVS_EventType_INFORMATION,
+                    "rover app: trajectory of %u knots over %u ms started",
+                    (unsigned int)Traj->KnotCount,
+                    (unsigned int)RoverAppTrajData.Staged[Traj->KnotCount - 1].TimeMs);
+
+    return CFE_SUCCESS;
+
+} /* End of RoverAppTrajStart() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTrajStop() -- hand the twist back to SET_TWIST                     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppTrajStop(void)
+{
+    __atomic_store_n(&RoverAppTrajData.Active, ROVER_APP_TRAJ_NONE, __ATOMIC_RELEASE);
+
+} /* End of RoverAppTrajStop() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTrajEval() -- trajectory twist at Now, control task only           */
+/*                                                                            */
+/*   Returns false with Twist untouched when no trajectory is running or it  */
+/*   has not started yet.  After the last knot its twist is held.            */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+bool RoverAppTrajEval(RoverAppStamp_t Now, RoverAppTwist_t *Twist)
+{
+    const RoverAppTraj_t        *Traj;
+    const RoverAppTrajSegment_t *Seg;
+    RoverAppStamp_t              Offset;
+    uint32                       k;
+    uint32                       Lo;
+    uint32                       Hi;
+    uint32                       Mid;
+    uint8                        Active;
+    float                        s;
+    float                        v[ROVER_APP_TRAJ_AXES];
+    uint32                       j;
+
+    Active = __atomic_load_n(&RoverAppTrajData.Active, __ATOMIC_ACQUIRE);
+    if (Active != RoverAppTrajData.Acked)
+    {
+        __atomic_store_n(&RoverAppTrajData.Acked, Active, __ATOMIC_RELEASE);
+        RoverAppTrajData.Segment = 0;
+    }
+
+    if (Active == ROVER_APP_TRAJ_NONE)
+    {
+        return false;
+    }
+
+    Traj = &RoverAppTrajData.Slot[Active];
+    if (Now < Traj->Start)
+    {
+        return false;
+    }
+
+    Offset = Now - Traj->Start;
+    k      = RoverAppTrajData.Segment;
+
+    if (Offset < Traj->Knot[k])
+    {
+        /* Time went backwards: search again */
+        Lo = 0;
+        Hi = k;
+        while (Lo < Hi)
+        {
+            Mid = Lo + ((Hi - Lo + 1) / 2);
+            if (Traj->Knot[Mid] <= Offset)
+            {
+                Lo = Mid;
+            }
+            else
+            {
+                Hi = Mid - 1;
+            }
+        }
+        k = Lo;
+    }
+
+    while (k + 1 < Traj->KnotCount && Offset >= Traj->Knot[k + 1])
+    {
+        k++;
+    }
+
+    RoverAppTrajData.Segment = k;
+
+    Seg = &Traj->Segment[k];
+    s   = (Offset > Traj->Knot[k]) ? RoverAppStampToSeconds((int64)(Offset - Traj->Knot[k])) : 0.0f;
+
+    for (j = 0; j < ROVER_APP_TRAJ_AXES; j++)
+    {
+        v[j] = Seg->A[j] + (s * (Seg->B[j] + (s * (Seg->C[j] + (s * Seg->D[j])))));
+    }
+
+    Twist->linear_x  = v[0];
+    Twist->linear_y  = v[1];
+    Twist->linear_z  = v[2];
+    Twist->angular_x = v[3];
+    Twist->angular_y = v[4];
+    Twist->angular_z = v[5];
+
+    return true;
+
+} /* End of RoverAppTrajEval() */
+
+/************************/
+/*  End of File Comment */
+/************************/
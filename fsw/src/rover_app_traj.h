@@ -0,0 +1,80 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_traj.h
+**
+** Purpose:
+**   Uploaded twist trajectories: timed knots turned into piecewise cubic
+**   segments once, on start, and evaluated by the control loop each tick.
+**
+** Notes:
+**   Knots are uploaded and started from the command task, and evaluated
+**   from the task that services the control pipe.  Trajectories are
+**   built into whichever of two slots the control loop is not using and
+**   handed over with one atomic store; a start is refused until the
+**   control loop has picked up the previous one.
+**
+*******************************************************************************/
+#ifndef _rover_app_traj_h_
+#define _rover_app_traj_h_
+
+#include "cfe.h"
+
+#include "rover_app_history.h"
+#include "rover_app_msg.h"
+#include "rover_app_platform_cfg.h"
+
+#define ROVER_APP_TRAJ_SLOTS 2
+#define ROVER_APP_TRAJ_NONE  0xFF /* No trajectory running */
+
+/*
+** One cubic per twist axis, v(s) = A + B s + C s^2 + D s^3 with s the
+** time since the segment's knot in seconds
+*/
+typedef struct
+{
+    float A[6];
+    float B[6];
+    float C[6];
+    float D[6];
+} RoverAppTrajSegment_t;
+
+typedef struct
+{
+    uint32                KnotCount;
+    RoverAppStamp_t       Start;                             /* Time of TimeMs 0 */
+    RoverAppStamp_t       Knot[ROVER_APP_TRAJ_MAX_KNOTS];    /* Since Start */
+    RoverAppTrajSegment_t Segment[ROVER_APP_TRAJ_MAX_KNOTS]; /* The last one holds the final knot */
+} RoverAppTraj_t;
+
+/*
+** Exported functions
+*/
+void  RoverAppTrajInit(void);
+int32 RoverAppTrajLoad(const RoverAppTrajLoadCmd_t *Cmd);
+int32 RoverAppTrajStart(RoverAppStamp_t Start);
+void  RoverAppTrajStop(void);
+bool  RoverAppTrajEval(RoverAppStamp_t Now, RoverAppTwist_t *Twist);
+
+#endif /* _rover_app_traj_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
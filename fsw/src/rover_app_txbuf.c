@@ -0,0 +1,131 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_txbuf.c
+**
+** Purpose:
+**   Zero-copy telemetry transmit for the rover app.
+**
+** Notes:
+**   The counters are shared by the tasks and only ever incremented.
+**
+*******************************************************************************/
+
+/*
+** Include Files:
+*/
+#include "rover_app_txbuf.h"
+#include "rover_app_platform_cfg.h"
+
+#include <string.h>
+
+typedef struct
+{
+    uint32 ZeroCopyCount; /* Sent from an SB buffer */
+    uint32 FallbackCount; /* No SB buffer, sent from the local copy */
+    uint32 ErrorCount;    /* CFE_SB_TransmitBuffer() failed, packet lost */
+} RoverAppTxBufData_t;
+
+static RoverAppTxBufData_t RoverAppTxBufData;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTxBufInit() -- clear the counts                                    */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppTxBufInit(void)
+{
+    memset(&RoverAppTxBufData, 0, sizeof(RoverAppTxBufData));
+
+} /* End of RoverAppTxBufInit() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTxBufGet() -- packet of Size bytes to fill, with Local's header    */
+/*                                                                            */
+/*   Returns an SB buffer, or Local itself when SB has none.  Either way      */
+/*   it goes to RoverAppTxBufSend() with the same Local, so ask whether the   */
+/*   packet is due before taking one.                                         */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void *RoverAppTxBufGet(CFE_MSG_TelemetryHeader_t *Local, size_t Size)
+{
+#if ROVER_APP_ZERO_COPY_ENABLE
+    CFE_SB_Buffer_t *BufPtr = CFE_SB_AllocateMessageBuffer(Size);
+
+    if (BufPtr != NULL)
+    {
+        memcpy(BufPtr, Local, sizeof(*Local));
+        return BufPtr;
+    }
+
+    __atomic_fetch_add(&RoverAppTxBufData.FallbackCount, 1, __ATOMIC_RELAXED);
+#else
+    (void)Size;
+#endif
+
+    return Local;
+
+} /* End of RoverAppTxBufGet() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTxBufSend() -- time stamp and send a packet                       */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppTxBufSend(void *Tlm, const CFE_MSG_TelemetryHeader_t *Local)
+{
+    CFE_SB_TimeStampMsg((CFE_MSG_Message_t *)Tlm);
+
+    if (Tlm == (const void *)Local)
+    {
+        CFE_SB_TransmitMsg((CFE_MSG_Message_t *)Tlm, true);
+        return;
+    }
+
+    /* SB owns the buffer once sent, and leaves it to us on error */
+    if (CFE_SB_TransmitBuffer((CFE_SB_Buffer_t *)Tlm, true) == CFE_SUCCESS)
+    {
+        __atomic_fetch_add(&RoverAppTxBufData.ZeroCopyCount, 1, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        CFE_SB_ReleaseMessageBuffer((CFE_SB_Buffer_t *)Tlm);
+        __atomic_fetch_add(&RoverAppTxBufData.ErrorCount, 1, __ATOMIC_RELAXED);
+    }
+
+} /* End of RoverAppTxBufSend() */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* RoverAppTxBufCounts() -- packets sent each way, and lost                   */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void RoverAppTxBufCounts(uint32 *ZeroCopyCount, uint32 *FallbackCount, uint32 *ErrorCount)
+{
+    *ZeroCopyCount = __atomic_load_n(&RoverAppTxBufData.ZeroCopyCount, __ATOMIC_RELAXED);
+    *FallbackCount = __atomic_load_n(&RoverAppTxBufData.FallbackCount, __ATOMIC_RELAXED);
+    *ErrorCount    = __atomic_load_n(&RoverAppTxBufData.ErrorCount, __ATOMIC_RELAXED);
+
+} /* End of RoverAppTxBufCounts() */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -0,0 +1,53 @@
+/*******************************************************************************
+**
+**      GSC-18128-1, "Core Flight Executive Version 6.7"
+**
+**      Copyright (c) 2006-2019 United States Government as represented by
+**      the Administrator of the National Aeronautics and Space Administration.
+**      All Rights Reserved.
+**
+**      Licensed under the Apache License, Version 2.0 (the "License");
+**      you may not use this file except in compliance with the License.
+**      You may obtain a copy of the License at
+**
+**        http://www.apache.org/licenses/LICENSE-2.0
+**
+**      Unless required by applicable law or agreed to in writing, software
+**      distributed under the License is distributed on an "AS IS" BASIS,
+**      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**      See the License for the specific language governing permissions and
+**      limitations under the License.
+**
+** File: rover_app_txbuf.h
+**
+** Purpose:
+**   Zero-copy transmit of the HR rate telemetry: packets are built in
+**   buffers from CFE_SB_AllocateMessageBuffer() and handed to SB with
+**   CFE_SB_TransmitBuffer(), so SB does not copy them again.
+**
+** Notes:
+**   Each packet keeps a local copy, initialized once with CFE_MSG_Init(),
+**   whose header is copied into every buffer.  When SB has no buffer to
+**   give, RoverAppTxBufGet() returns the local copy instead and the packet
+**   goes out with CFE_SB_TransmitMsg() as before.  Callable from any task;
+**   HK reports the counts.
+**
+*******************************************************************************/
+#ifndef _rover_app_txbuf_h_
+#define _rover_app_txbuf_h_
+
+#include "cfe.h"
+
+/*
+** Exported functions
+*/
+void  RoverAppTxBufInit(void);
+void *RoverAppTxBufGet(CFE_MSG_TelemetryHeader_t *Local, size_t Size);
+void  RoverAppTxBufSend(void *Tlm, const CFE_MSG_TelemetryHeader_t *Local);
+void  RoverAppTxBufCounts(uint32 *ZeroCopyCount, uint32 *FallbackCount, uint32 *ErrorCount);
+
+#endif /* _rover_app_txbuf_h_ */
+
+/************************/
+/*  End of File Comment */
+/************************/
@@ -23,8 +23,7 @@
 #include "cfe_tbl_filedef.h" /* Required to obtain the CFE_TBL_FILEDEF macro definition */
 #include "rover_app_table.h"
 
-// Example
-RoverAppTable_t RoverAppTable = {1,2};
+RoverAppTable_t RoverAppTable = ROVER_APP_TABLE_DEFAULTS;
 
 
 /*
@@ -34,4 +33,4 @@ RoverAppTable_t RoverAppTable = {1,2};
 **    3) a brief description of the contents of the file image
 **    4) the desired name of the table image binary file that is cFE compatible
 */
-CFE_TBL_FILEDEF(RoverAppTable, RoverApp.RoverAppTable, Table Utility Test Table, rover_app_tbl.tbl)
+CFE_TBL_FILEDEF(RoverAppTable, ROVER_APP.RoverAppTable, Rover app limits and scales, rover_app_tbl.tbl)
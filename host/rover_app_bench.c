@@ -0,0 +1,835 @@
+/*******************************************************************************
+**
+** File: rover_app_bench.c
+**
+** Purpose:
+**   Host microbenchmark of the rover_app message path.  Each input stream
+**   is pushed through the app's packet dispatcher against the stub cFE
+**   and reported as throughput (msgs/s) and per-message latency
+**   percentiles.  The odom_eval and dead_reckon rows time the two ways the
+**   control loop can produce its per-tick state, on their own: 1 kHz ticks
+**   against 50 Hz odometry.  traj_eval times the twist of a full-size
+**   uploaded trajectory at 1 kHz ticks, shape_step the acceleration and
+**   jerk limited ramp of the twist sent.  The path_* rows time the path
+**   follower on paths of 100 to 100k waypoints.  With a fleet configured,
+**   fleet_odom times an odometry message of a fleet vehicle through the
+**   range lookup, fleet_tick the pass over all vehicles, and hr_fleet the
+**   whole HR wakeup with every vehicle active, to compare with hr_wakeup.
+**   hr_copy and fleet_copy repeat hr_wakeup and hr_fleet with SB out of
+**   buffers, so the telemetry goes out with a copy instead of zero-copy.
+**   compact_enc and compact_dec time the quantized state of the compact
+**   telemetry packet each way; the table report ends with its round-trip
+**   error over random states.  twist_nolim repeats twist_cmd with the
+**   event rate limits off, so every event is formatted.  blackbox_add
+**   times the flight recorder's per-tick entry on its own.  table_update
+**   times a table update end to end: the load staged in Table Services,
+**   validated and derived on the HK request, and taken by the next tick.
+**   cds_update times the warm restart block offered a moving state every
+**   1 kHz tick, with the CDS written every ROVER_APP_CDS_PERIOD_MS.
+**
+**   Usage: rover_app_bench [-n iterations] [-c] [-v]
+**      -n  messages per stream (default 200000)
+**      -c  print CSV instead of a table
+**      -v  keep the app's console output and print events
+**
+*******************************************************************************/
+
+#include "rover_app_events.h"
+#include "rover_app.h"
+#include "rover_app_msgids.h"
+#include "rover_app_traj.h"
+#include "rover_app_shape.h"
+#include "rover_app_path.h"
+#include "rover_app_fleet.h"
+#include "rover_app_compact.h"
+#include "rover_app_evlimit.h"
+#include "rover_app_blackbox.h"
+#include "rover_app_params.h"
+#include "rover_app_cds.h"
+#include "stub_cfe.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define BENCH_DEFAULT_ITERATIONS 200000
+#define BENCH_WARMUP_ITERATIONS  1000
+
+/* State stage timing: stamp units (2^-32 s) per tick and per odometry sample */
+#define BENCH_TICK_STAMP        (((RoverAppStamp_t)1 << 32) / 1000)
+#define BENCH_TICKS_PER_ODOM    20
+#define BENCH_TRAJ_KNOT_MS      100
+#define BENCH_PATH_OFFSET       0.3f /* Rover to the side of the path, m */
+#define BENCH_COMPACT_STATES    256  /* Random states the compact rows cycle through */
+
+typedef struct
+{
+    const char *Name;
+    void (*Handler)(CFE_SB_Buffer_t *SBBufPtr);
+    uint32 Arg;  /* Set up for the handler: the path length of the path rows */
+    bool   Copy;    /* SB has no buffers to give, telemetry goes out with a copy */
+    bool   NoLimit; /* Events are not rate limited */
+    union
+    {
+        CFE_SB_Buffer_t Buf;
+        uint8           Bytes[256];
+    };
+} BenchMsg_t;
+
+typedef struct
+{
+    double MsgsPerSec;
+    uint64 Min;
+    uint64 P50;
+    uint64 P90;
+    uint64 P99;
+    uint64 P999;
+    uint64 Max;
+} BenchResult_t;
+
+static FILE *BenchOut;
+
+static RoverAppOdomHistory_t       BenchHistory;
+static RoverAppDeadReckon_t        BenchDeadReckon;
+static RoverAppStamp_t             BenchStamp;
+static RoverAppStamp_t             BenchCdsStamp; /* Past the app's own CDS writes */
+static uint32                      BenchTick;
+static volatile RoverAppOdometry_t BenchState; /* Keeps the stages from being optimized out */
+static volatile RoverAppTwist_t    BenchTwist;
+static uint32                      BenchTrajTicks;
+static uint32                      BenchPathPoints;
+static uint32                      BenchPathTicks;
+static RoverAppOdometry_t          BenchCompactState[BENCH_COMPACT_STATES];
+static RoverAppCompactState_t      BenchCompactPacked[BENCH_COMPACT_STATES];
+static float                       BenchCompactScale[ROVER_APP_COMPACT_FIELDS];
+static volatile uint16             BenchCompactFlags;
+static RoverAppDiagTlm_t           BenchDiag;
+static bool                        BenchDiagSeen;
+
+static int BenchCompareU64(const void *a, const void *b)
+{
+    uint64 x = *(const uint64 *)a;
+    uint64 y = *(const uint64 *)b;
+
+    return (x > y) - (x < y);
+}
+
+static uint64 BenchPercentile(const uint64 *Sorted, uint32 Count, double Pct)
+{
+    uint32 Index = (uint32)(Pct * (double)(Count - 1) / 100.0);
+
+    return Sorted[Index];
+}
+
+static void BenchInitCmd(BenchMsg_t *Msg, const char *Name, uint32 MsgId, CFE_MSG_FcnCode_t Cc, size_t Size)
+{
+    memset(Msg, 0, sizeof(*Msg));
+    Msg->Name    = Name;
+    Msg->Handler = RoverAppProcessCommandPacket;
+
+    CFE_MSG_Init(&Msg->Buf.Msg, CFE_SB_ValueToMsgId(MsgId), Size);
+    CFE_MSG_SetFcnCode(&Msg->Buf.Msg, Cc);
+}
+
+/*
+** A full history of a rover turning at constant rate, 50 Hz samples
+*/
+static void BenchInitHistory(void)
+{
+    RoverAppOdometry_t Odom;
+    uint32             i;
+
+    memset(&Odom, 0, sizeof(Odom));
+    Odom.pose.qw          = 1.0f;
+    Odom.twist.linear_x   = 0.5f;
+    Odom.twist.angular_z  = 0.2f;
+
+    RoverAppOdomHistoryInit(&BenchHistory);
+    for (i = 0; i < ROVER_APP_ODOM_HISTORY_SIZE; i++)
+    {
+        RoverAppOdomHistoryInsert(&BenchHistory, BENCH_TICK_STAMP * BENCH_TICKS_PER_ODOM * (i + 1), &Odom);
+        RoverAppPoseIntegrate(&Odom.pose, &Odom.twist, 0.001f * BENCH_TICKS_PER_ODOM);
+    }
+
+    memset(&BenchDeadReckon, 0, sizeof(BenchDeadReckon));
+    BenchStamp = BENCH_TICK_STAMP * BENCH_TICKS_PER_ODOM * ROVER_APP_ODOM_HISTORY_SIZE;
+    BenchTick  = 0;
+}
+
+/*
+** Ticks walk just past the newest sample, as a loop running ahead of
+** odometry does
+*/
+static void BenchOdomEval(CFE_SB_Buffer_t *SBBufPtr)
+{
+    RoverAppOdometry_t Odom;
+
+    (void)SBBufPtr;
+
+    BenchTick = (BenchTick + 1) % BENCH_TICKS_PER_ODOM;
+    RoverAppOdomHistoryEval(&BenchHistory, BenchStamp + (BENCH_TICK_STAMP * BenchTick), &Odom);
+    BenchState = Odom;
+}
+
+static void BenchDeadReckonStep(CFE_SB_Buffer_t *SBBufPtr)
+{
+    RoverAppOdometry_t Odom;
+
+    (void)SBBufPtr;
+
+    BenchTick = (BenchTick + 1) % BENCH_TICKS_PER_ODOM;
+    if (BenchTick == 0)
+    {
+        BenchDeadReckon.Reanchor = true;
+    }
+    RoverAppDeadReckonStep(&BenchDeadReckon, &BenchHistory, NULL, BenchStamp + (BENCH_TICK_STAMP * BenchTick), &Odom);
+    BenchState = Odom;
+}
+
+/*
+** A ROVER_APP_TRAJ_MAX_KNOTS trajectory, uploaded and started through
+** the app's commands at stamp 0
+*/
+static void BenchInitTraj(void)
+{
+    RoverAppTrajLoadCmd_t Cmd;
+    RoverAppTrajKnot_t   *Knot;
+    uint32                k;
+
+    memset(&Cmd, 0, sizeof(Cmd));
+    CFE_MSG_Init(&Cmd.CmdHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_CMD_MID), sizeof(Cmd));
+    CFE_MSG_SetFcnCode(&Cmd.CmdHeader.Msg, ROVER_APP_TRAJ_LOAD_CC);
+
+    for (k = 0; k < ROVER_APP_TRAJ_MAX_KNOTS; k++)
+    {
+        Knot                  = &Cmd.Knot[k % ROVER_APP_TRAJ_KNOTS_PER_CMD];
+        Knot->TimeMs          = k * BENCH_TRAJ_KNOT_MS;
+        Knot->twist.linear_x  = 0.1f * (float)(k % 10);
+        Knot->twist.angular_z = 0.05f * (float)((int)(k % 7) - 3);
+
+        if ((k + 1) % ROVER_APP_TRAJ_KNOTS_PER_CMD == 0 || k + 1 == ROVER_APP_TRAJ_MAX_KNOTS)
+        {
+            Cmd.KnotCount = (uint16)((k % ROVER_APP_TRAJ_KNOTS_PER_CMD) + 1);
+            Cmd.FirstKnot = (uint16)(k + 1 - Cmd.KnotCount);
+            RoverAppProcessCommandPacket((CFE_SB_Buffer_t *)&Cmd);
+        }
+    }
+
+    RoverAppTrajStart(0);
+
+    BenchTick      = 0;
+    BenchTrajTicks = ROVER_APP_TRAJ_MAX_KNOTS * BENCH_TRAJ_KNOT_MS;
+}
+
+/*
+** Ticks run through the whole trajectory and start over
+*/
+static void BenchTrajEval(CFE_SB_Buffer_t *SBBufPtr)
+{
+    RoverAppTwist_t Twist;
+
+    (void)SBBufPtr;
+
+    BenchTick = (BenchTick + 1) % BenchTrajTicks;
+    RoverAppTrajEval(BENCH_TICK_STAMP * BenchTick, &Twist);
+    BenchTwist = Twist;
+}
+
+/*
+** A path of Points waypoints 1 m apart, a meander 20 m either side of the
+** x axis, uploaded and started through the app's commands
+*/
+static float BenchPathY(float x)
+{
+    return 20.0f * sinf(x / 30.0f);
+}
+
+static void BenchInitPath(uint32 Points, uint32 Ticks)
+{
+    RoverAppPathLoadCmd_t  Load;
+    RoverAppPathStartCmd_t Start;
+    uint32                 k;
+
+    memset(&Load, 0, sizeof(Load));
+    CFE_MSG_Init(&Load.CmdHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_CMD_MID), sizeof(Load));
+    CFE_MSG_SetFcnCode(&Load.CmdHeader.Msg, ROVER_APP_PATH_LOAD_CC);
+
+    for (k = 0; k < Points; k++)
+    {
+        Load.Point[k % ROVER_APP_PATH_POINTS_PER_CMD].x = (float)k;
+        Load.Point[k % ROVER_APP_PATH_POINTS_PER_CMD].y = BenchPathY((float)k);
+
+        if ((k + 1) % ROVER_APP_PATH_POINTS_PER_CMD == 0 || k + 1 == Points)
+        {
+            Load.PointCount = (uint16)((k % ROVER_APP_PATH_POINTS_PER_CMD) + 1);
+            Load.FirstPoint = k + 1 - Load.PointCount;
+            RoverAppProcessCommandPacket((CFE_SB_Buffer_t *)&Load);
+        }
+    }
+
+    CFE_MSG_Init(&Start.CmdHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_CMD_MID), sizeof(Start));
+    CFE_MSG_SetFcnCode(&Start.CmdHeader.Msg, ROVER_APP_PATH_START_CC);
+    Start.Speed     = 1.0f;
+    Start.Lookahead = 2.0f;
+    RoverAppProcessCommandPacket((CFE_SB_Buffer_t *)&Start);
+
+    BenchTick       = 0;
+    BenchPathPoints = Points;
+    BenchPathTicks  = Ticks;
+}
+
+/*
+** The rover moves along 90% of the path over the run, off to one side
+*/
+static void BenchPathFollow(CFE_SB_Buffer_t *SBBufPtr)
+{
+    RoverAppPose_t  Pose;
+    RoverAppTwist_t Twist;
+    float           x;
+
+    (void)SBBufPtr;
+
+    BenchTick++;
+    x = 0.9f * (float)(BenchPathPoints - 1) * ((float)BenchTick / (float)BenchPathTicks);
+
+    memset(&Pose, 0, sizeof(Pose));
+    Pose.x  = x;
+    Pose.y  = BenchPathY(x) + BENCH_PATH_OFFSET;
+    Pose.qw = 1.0f;
+
+    RoverAppPathFollow(&Pose, &Twist);
+    BenchTwist = Twist;
+}
+
+/*
+** Shaping with the default limits, toward a setpoint that changes every
+** 500 ticks so the axes are ramping most of the time
+*/
+static void BenchShapeStep(CFE_SB_Buffer_t *SBBufPtr)
+{
+    RoverAppTwist_t Target;
+    RoverAppTwist_t Twist;
+
+    (void)SBBufPtr;
+
+    BenchTick++;
+    memset(&Target, 0, sizeof(Target));
+    Target.linear_x  = 0.1f * (float)((BenchTick / 500) % 10);
+    Target.angular_z = 0.05f * (float)((int)((BenchTick / 500) % 7) - 3);
+
+    RoverAppShapeStep(&Target, BENCH_TICK_STAMP * BenchTick, &Twist);
+    BenchTwist = Twist;
+}
+
+/*
+** One flight recorder entry per tick, from the bench history and the
+** stage outputs, as the end of an HR tick adds it
+*/
+static void BenchBlackBoxAdd(CFE_SB_Buffer_t *SBBufPtr)
+{
+    RoverAppOdometry_t State  = BenchState;
+    RoverAppTwist_t    Target = BenchTwist;
+    RoverAppStamp_t    Now;
+
+    (void)SBBufPtr;
+
+    BenchTick++;
+    Now = BenchStamp + (BENCH_TICK_STAMP * (BenchTick % BENCH_TICKS_PER_ODOM));
+    RoverAppBlackBoxAdd(Now, Now + (BENCH_TICK_STAMP / 10), &BenchHistory, &State, &Target, &Target);
+}
+
+/*
+** Tables alternating between the default shaping limits and twice them,
+** so every update changes something
+*/
+static void BenchTableUpdate(CFE_SB_Buffer_t *SBBufPtr)
+{
+    RoverAppTable_t Table = ROVER_APP_TABLE_DEFAULTS;
+
+    (void)SBBufPtr;
+
+    if (++BenchTick & 1)
+    {
+        Table.LinearAccelMax  *= 2.0f;
+        Table.AngularAccelMax *= 2.0f;
+    }
+    StubCfe_TableStage(ROVER_APP_TABLE_NAME, &Table, sizeof(Table));
+    RoverAppParamsManage();
+    RoverAppParamsSwap();
+}
+
+/*
+** A state that moves every tick, so the block always changes and the
+** rate limit alone decides the writes
+*/
+static void BenchCdsUpdate(CFE_SB_Buffer_t *SBBufPtr)
+{
+    RoverAppOdometry_t State = BenchState;
+    RoverAppTwist_t    Twist = BenchTwist;
+
+    (void)SBBufPtr;
+
+    BenchTick++;
+    State.pose.x += 0.001f * (float)BenchTick;
+    RoverAppCdsUpdate(BenchCdsStamp + (BENCH_TICK_STAMP * BenchTick), &State, &Twist, &Twist,
+                      ROVER_APP_CDS_SOURCE_TWIST);
+}
+
+/*
+** Uniform in [Lo, Hi)
+*/
+static float BenchRandom(float Lo, float Hi)
+{
+    return Lo + ((Hi - Lo) * (float)rand() / ((float)RAND_MAX + 1.0f));
+}
+
+/*
+** Random states inside the default ranges: positions to +-300 m, linear
+** rates to +-30 m/s, angular rates to +-30 rad/s and any attitude
+*/
+static void BenchInitCompact(void)
+{
+    RoverAppTable_t     Table = ROVER_APP_TABLE_DEFAULTS;
+    RoverAppOdometry_t *State;
+    float               Norm;
+    uint32              i;
+
+    srand(1);
+    RoverAppCompactScales(&Table, BenchCompactScale);
+    for (i = 0; i < BENCH_COMPACT_STATES; i++)
+    {
+        State                  = &BenchCompactState[i];
+        State->pose.x          = BenchRandom(-300.0f, 300.0f);
+        State->pose.y          = BenchRandom(-300.0f, 300.0f);
+        State->pose.z          = BenchRandom(-300.0f, 300.0f);
+        State->pose.qx         = BenchRandom(-1.0f, 1.0f);
+        State->pose.qy         = BenchRandom(-1.0f, 1.0f);
+        State->pose.qz         = BenchRandom(-1.0f, 1.0f);
+        State->pose.qw         = BenchRandom(-1.0f, 1.0f);
+        State->twist.linear_x  = BenchRandom(-30.0f, 30.0f);
+        State->twist.linear_y  = BenchRandom(-30.0f, 30.0f);
+        State->twist.linear_z  = BenchRandom(-30.0f, 30.0f);
+        State->twist.angular_x = BenchRandom(-30.0f, 30.0f);
+        State->twist.angular_y = BenchRandom(-30.0f, 30.0f);
+        State->twist.angular_z = BenchRandom(-30.0f, 30.0f);
+
+        Norm = sqrtf((State->pose.qx * State->pose.qx) + (State->pose.qy * State->pose.qy) +
+                     (State->pose.qz * State->pose.qz) + (State->pose.qw * State->pose.qw));
+        State->pose.qx /= Norm;
+        State->pose.qy /= Norm;
+        State->pose.qz /= Norm;
+        State->pose.qw /= Norm;
+
+        RoverAppCompactEncode(State, BenchCompactScale, &BenchCompactPacked[i]);
+    }
+    BenchTick = 0;
+}
+
+static void BenchCompactEncode(CFE_SB_Buffer_t *SBBufPtr)
+{
+    RoverAppCompactState_t Packed;
+
+    (void)SBBufPtr;
+
+    RoverAppCompactEncode(&BenchCompactState[BenchTick++ % BENCH_COMPACT_STATES], BenchCompactScale, &Packed);
+    BenchCompactFlags = Packed.Flags;
+}
+
+static void BenchCompactDecode(CFE_SB_Buffer_t *SBBufPtr)
+{
+    RoverAppOdometry_t State;
+
+    (void)SBBufPtr;
+
+    RoverAppCompactDecode(&BenchCompactPacked[BenchTick++ % BENCH_COMPACT_STATES], BenchCompactScale, &State);
+    BenchState = State;
+}
+
+/*
+** Largest round-trip error of the compact states, per kind of field; the
+** attitude error is the angle of the rotation between the two
+*/
+static void BenchPrintCompact(void)
+{
+    RoverAppOdometry_t Out;
+    const float       *a;
+    const float       *b;
+    float              Sign;
+    float              MaxPos     = 0.0f;
+    float              MaxLinear  = 0.0f;
+    float              MaxAngular = 0.0f;
+    float              MaxAtt     = 0.0f;
+    uint32             Saturated  = 0;
+    uint32             i;
+
+    for (i = 0; i < BENCH_COMPACT_STATES; i++)
+    {
+        RoverAppCompactDecode(&BenchCompactPacked[i], BenchCompactScale, &Out);
+        a = &BenchCompactState[i].pose.x;
+        b = &Out.pose.x;
+        MaxPos = fmaxf(MaxPos, fmaxf(fabsf(a[0] - b[0]), fmaxf(fabsf(a[1] - b[1]), fabsf(a[2] - b[2]))));
+        a = &BenchCompactState[i].twist.linear_x;
+        b = &Out.twist.linear_x;
+        MaxLinear = fmaxf(MaxLinear, fmaxf(fabsf(a[0] - b[0]), fmaxf(fabsf(a[1] - b[1]), fabsf(a[2] - b[2]))));
+        a = &BenchCompactState[i].twist.angular_x;
+        b = &Out.twist.angular_x;
+        MaxAngular = fmaxf(MaxAngular, fmaxf(fabsf(a[0] - b[0]), fmaxf(fabsf(a[1] - b[1]), fabsf(a[2] - b[2]))));
+
+        /* Rotation angle from the chord between the nearer of +-q, 4 asin(|a - b| / 2) */
+        a   = &BenchCompactState[i].pose.qx;
+        b   = &Out.pose.qx;
+        Sign = ((a[0] * b[0]) + (a[1] * b[1]) + (a[2] * b[2]) + (a[3] * b[3]) < 0.0f) ? -1.0f : 1.0f;
+        MaxAtt = fmaxf(MaxAtt, 4.0f * asinf(0.5f * sqrtf(((a[0] - (Sign * b[0])) * (a[0] - (Sign * b[0]))) +
+                                                         ((a[1] - (Sign * b[1])) * (a[1] - (Sign * b[1]))) +
+                                                         ((a[2] - (Sign * b[2])) * (a[2] - (Sign * b[2]))) +
+                                                         ((a[3] - (Sign * b[3])) * (a[3] - (Sign * b[3]))))));
+
+        Saturated += ((BenchCompactPacked[i].Flags & ROVER_APP_COMPACT_SAT_MASK) != 0);
+    }
+
+    fprintf(BenchOut,
+            "\ncompact state: %u of %u bytes, max error over %u states: position %.4f m, attitude %.6f rad, "
+            "linear %.5f m/s, angular %.5f rad/s, %u saturated\n",
+            (unsigned int)sizeof(RoverAppCompactState_t), (unsigned int)sizeof(RoverAppOdometry_t),
+            (unsigned int)BENCH_COMPACT_STATES, MaxPos, MaxAtt, MaxLinear, MaxAngular, (unsigned int)Saturated);
+}
+
+#if ROVER_APP_FLEET_SIZE > 0
+/*
+** Every fleet vehicle driving and turning, ticked at 1 kHz.  The path of
+** the path rows is stopped so hr_fleet differs from hr_wakeup by the
+** fleet only.
+*/
+static void BenchInitFleet(void)
+{
+    RoverAppTable_t  Table = ROVER_APP_TABLE_DEFAULTS;
+    RoverAppParams_t Params;
+    RoverAppTwist_t  Twist;
+    uint32           i;
+
+    RoverAppPathStop();
+    RoverAppParamsMake(&Table, &Params);
+    RoverAppFleetInit(&Params);
+    memset(&Twist, 0, sizeof(Twist));
+    for (i = 0; i < ROVER_APP_FLEET_SIZE; i++)
+    {
+        Twist.linear_x  = 0.1f * (float)(i % 10);
+        Twist.angular_z = 0.05f * (float)((int)(i % 7) - 3);
+        RoverAppFleetSetTwist(i, &Twist);
+    }
+    BenchTick = 0;
+}
+
+static void BenchFleetTick(CFE_SB_Buffer_t *SBBufPtr)
+{
+    (void)SBBufPtr;
+
+    BenchTick++;
+    RoverAppFleetTick(BENCH_TICK_STAMP * BenchTick);
+}
+#endif
+
+/*
+** Keeps the last diagnostics packet the app sends
+*/
+static void BenchTransmitHook(const CFE_MSG_Message_t *MsgPtr, CFE_MSG_Size_t Size, void *Arg)
+{
+    CFE_SB_MsgId_t MsgId;
+
+    (void)Arg;
+
+    CFE_MSG_GetMsgId(MsgPtr, &MsgId);
+    if (CFE_SB_MsgIdToValue(MsgId) == ROVER_APP_DIAG_TLM_MID && Size == sizeof(BenchDiag))
+    {
+        memcpy(&BenchDiag, MsgPtr, sizeof(BenchDiag));
+        BenchDiagSeen = true;
+    }
+}
+
+static void BenchPrintDiag(const char *Name, const RoverAppDiagStats_t *Stats)
+{
+    fprintf(BenchOut, "%-12s %12u %8u %8u %8u %8u %8u %10u\n", Name, (unsigned int)Stats->Count,
+            (unsigned int)Stats->MinNs, (unsigned int)Stats->MeanNs, (unsigned int)Stats->P50Ns,
+            (unsigned int)Stats->P99Ns, (unsigned int)Stats->P999Ns, (unsigned int)Stats->MaxNs);
+}
+
+static void BenchRun(BenchMsg_t *Msg, uint32 Iterations, uint64 *Samples, BenchResult_t *Result)
+{
+    uint64 Start;
+    uint64 Elapsed;
+    uint64 t0;
+    uint32 i;
+
+    for (i = 0; i < BENCH_WARMUP_ITERATIONS; i++)
+    {
+        Msg->Handler(&Msg->Buf);
+    }
+
+    /* Throughput pass, free of per-message clock reads */
+    Start = StubCfe_NowNs();
+    for (i = 0; i < Iterations; i++)
+    {
+        Msg->Handler(&Msg->Buf);
+    }
+    Elapsed = StubCfe_NowNs() - Start;
+
+    Result->MsgsPerSec = (Elapsed > 0) ? ((double)Iterations * 1e9 / (double)Elapsed) : 0.0;
+
+    /* Latency pass */
+    for (i = 0; i < Iterations; i++)
+    {
+        t0 = StubCfe_NowNs();
+        Msg->Handler(&Msg->Buf);
+        Samples[i] = StubCfe_NowNs() - t0;
+    }
+
+    qsort(Samples, Iterations, sizeof(Samples[0]), BenchCompareU64);
+
+    Result->Min  = Samples[0];
+    Result->P50  = BenchPercentile(Samples, Iterations, 50.0);
+    Result->P90  = BenchPercentile(Samples, Iterations, 90.0);
+    Result->P99  = BenchPercentile(Samples, Iterations, 99.0);
+    Result->P999 = BenchPercentile(Samples, Iterations, 99.9);
+    Result->Max  = Samples[Iterations - 1];
+}
+
+int main(int argc, char *argv[])
+{
+    BenchMsg_t         Msgs[23];
+    uint32             MsgCount = 19;
+    BenchResult_t      Result;
+    RoverAppTwistCmd_t *Twist;
+    RoverAppCmdRobotState_t *Odom;
+    uint64            *Samples;
+    uint32             Iterations = BENCH_DEFAULT_ITERATIONS;
+    bool               Csv        = false;
+    bool               Verbose    = false;
+    uint32             i;
+    int                opt;
+
+    while ((opt = getopt(argc, argv, "n:cv")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                Iterations = (uint32)strtoul(optarg, NULL, 0);
+                break;
+            case 'c':
+                Csv = true;
+                break;
+            case 'v':
+                Verbose = true;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n iterations] [-c] [-v]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (Iterations == 0)
+    {
+        Iterations = 1;
+    }
+
+    /*
+    ** The app writes to stdout on the message path; keep paying for the
+    ** write but send it to /dev/null so the report stays readable.
+    */
+    BenchOut = fdopen(dup(STDOUT_FILENO), "w");
+    if (BenchOut == NULL)
+    {
+        perror("fdopen");
+        return EXIT_FAILURE;
+    }
+    if (!Verbose && freopen("/dev/null", "w", stdout) == NULL)
+    {
+        perror("freopen");
+        return EXIT_FAILURE;
+    }
+
+    Samples = malloc(sizeof(*Samples) * Iterations);
+    if (Samples == NULL)
+    {
+        perror("malloc");
+        return EXIT_FAILURE;
+    }
+
+    StubCfe_Reset();
+    StubCfe_SetVerbose(Verbose);
+    StubCfe_SetTransmitHook(BenchTransmitHook, NULL);
+
+    if (RoverAppInit() != CFE_SUCCESS)
+    {
+        fprintf(stderr, "RoverAppInit failed\n");
+        return EXIT_FAILURE;
+    }
+
+    BenchInitCmd(&Msgs[0], "odom", ROVER_APP_CMD_ODOM_MID, 0, sizeof(RoverAppCmdRobotState_t));
+    Odom                 = (RoverAppCmdRobotState_t *)&Msgs[0].Buf;
+    Odom->odom.pose.x    = 1.0f;
+    Odom->odom.pose.qw   = 1.0f;
+    Odom->odom.twist.linear_x = 0.5f;
+
+    BenchInitCmd(&Msgs[1], "twist_cmd", ROVER_APP_CMD_MID, ROVER_APP_SET_TWIST_CC, sizeof(RoverAppTwistCmd_t));
+    Twist                    = (RoverAppTwistCmd_t *)&Msgs[1].Buf;
+    Twist->twist.linear_x    = 0.25f;
+    Twist->twist.angular_z   = 0.1f;
+
+    BenchInitCmd(&Msgs[2], "hk_request", ROVER_APP_SEND_HK_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    BenchInitCmd(&Msgs[3], "hr_wakeup", ROVER_APP_HR_CONTROL_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+
+    BenchInitCmd(&Msgs[4], "hr_copy", ROVER_APP_HR_CONTROL_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    Msgs[4].Copy = true;
+
+    BenchInitHistory();
+    BenchInitCmd(&Msgs[5], "odom_eval", ROVER_APP_HR_CONTROL_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    Msgs[5].Handler = BenchOdomEval;
+    BenchInitCmd(&Msgs[6], "dead_reckon", ROVER_APP_HR_CONTROL_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    Msgs[6].Handler = BenchDeadReckonStep;
+    BenchInitCmd(&Msgs[7], "traj_eval", ROVER_APP_HR_CONTROL_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    Msgs[7].Handler = BenchTrajEval;
+    BenchInitCmd(&Msgs[8], "shape_step", ROVER_APP_HR_CONTROL_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    Msgs[8].Handler = BenchShapeStep;
+    BenchInitCmd(&Msgs[9], "path_100", ROVER_APP_HR_CONTROL_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    BenchInitCmd(&Msgs[10], "path_1k", ROVER_APP_HR_CONTROL_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    BenchInitCmd(&Msgs[11], "path_10k", ROVER_APP_HR_CONTROL_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    BenchInitCmd(&Msgs[12], "path_100k", ROVER_APP_HR_CONTROL_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    for (i = 9; i < 13; i++)
+    {
+        Msgs[i].Handler = BenchPathFollow;
+        Msgs[i].Arg     = (i == 9) ? 100 : (i == 10) ? 1000 : (i == 11) ? 10000 : 100000;
+    }
+
+    BenchInitCmd(&Msgs[13], "compact_enc", ROVER_APP_SEND_HK_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    Msgs[13].Handler = BenchCompactEncode;
+    BenchInitCmd(&Msgs[14], "compact_dec", ROVER_APP_SEND_HK_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    Msgs[14].Handler = BenchCompactDecode;
+
+    BenchInitCmd(&Msgs[15], "twist_nolim", ROVER_APP_CMD_MID, ROVER_APP_SET_TWIST_CC, sizeof(RoverAppTwistCmd_t));
+    memcpy(&Msgs[15].Buf, &Msgs[1].Buf, sizeof(RoverAppTwistCmd_t));
+    Msgs[15].NoLimit = true;
+
+    BenchInitCmd(&Msgs[16], "blackbox_add", ROVER_APP_HR_CONTROL_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    Msgs[16].Handler = BenchBlackBoxAdd;
+    BenchInitCmd(&Msgs[17], "table_update", ROVER_APP_SEND_HK_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    Msgs[17].Handler = BenchTableUpdate;
+    BenchInitCmd(&Msgs[18], "cds_update", ROVER_APP_HR_CONTROL_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    Msgs[18].Handler = BenchCdsUpdate;
+
+#if ROVER_APP_FLEET_SIZE > 0
+    BenchInitCmd(&Msgs[19], "fleet_odom", ROVER_APP_FLEET_ODOM_MID_BASE + (ROVER_APP_FLEET_SIZE / 2), 0,
+                 sizeof(RoverAppCmdRobotState_t));
+    Odom                 = (RoverAppCmdRobotState_t *)&Msgs[19].Buf;
+    Odom->odom.pose.x    = 1.0f;
+    Odom->odom.pose.qw   = 1.0f;
+    BenchInitCmd(&Msgs[20], "fleet_tick", ROVER_APP_HR_CONTROL_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    Msgs[20].Handler = BenchFleetTick;
+    BenchInitCmd(&Msgs[21], "hr_fleet", ROVER_APP_HR_CONTROL_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    BenchInitCmd(&Msgs[22], "fleet_copy", ROVER_APP_HR_CONTROL_MID, 0, sizeof(RoverAppNoArgsCmd_t));
+    Msgs[22].Copy = true;
+    MsgCount      = 23;
+#endif
+
+    if (Csv)
+    {
+        fprintf(BenchOut, "stream,msgs_per_s,min_ns,p50_ns,p90_ns,p99_ns,p99.9_ns,max_ns\n");
+    }
+    else
+    {
+        fprintf(BenchOut, "rover_app bench: %u messages per stream\n\n", (unsigned int)Iterations);
+        fprintf(BenchOut, "%-12s %12s %8s %8s %8s %8s %8s %10s\n", "stream", "msgs/s", "min", "p50", "p90", "p99",
+                "p99.9", "max [ns]");
+    }
+
+    for (i = 0; i < MsgCount; i++)
+    {
+        if (Msgs[i].Handler == BenchTrajEval)
+        {
+            BenchInitTraj();
+        }
+        if (Msgs[i].Handler == BenchShapeStep)
+        {
+            RoverAppTable_t  Table = ROVER_APP_TABLE_DEFAULTS;
+            RoverAppParams_t Params;
+
+            RoverAppParamsMake(&Table, &Params);
+            RoverAppShapeInit(&Params);
+            BenchTick = 0;
+        }
+        if (Msgs[i].Handler == BenchPathFollow)
+        {
+            BenchInitPath(Msgs[i].Arg, BENCH_WARMUP_ITERATIONS + (2 * Iterations));
+        }
+        if (Msgs[i].Handler == BenchCompactEncode)
+        {
+            BenchInitCompact();
+        }
+        if (Msgs[i].Handler == BenchCdsUpdate)
+        {
+            BenchCdsStamp = RoverAppTimeToStamp(CFE_TIME_GetTime()) + ((RoverAppStamp_t)1 << 32);
+            BenchTick     = 0;
+        }
+#if ROVER_APP_FLEET_SIZE > 0
+        if (Msgs[i].Handler == BenchFleetTick)
+        {
+            BenchInitFleet();
+        }
+#endif
+
+        StubCfe_SetAllocateFail(Msgs[i].Copy);
+        if (Msgs[i].NoLimit)
+        {
+            RoverAppEvLimitSet(0, 0.0f, 1);
+        }
+        BenchRun(&Msgs[i], Iterations, Samples, &Result);
+        if (Msgs[i].NoLimit)
+        {
+            RoverAppTable_t Table = ROVER_APP_TABLE_DEFAULTS;
+
+            RoverAppEvLimitSet(0, Table.EventRate, Table.EventBurst);
+        }
+        StubCfe_SetAllocateFail(false);
+
+        fprintf(BenchOut, Csv ? "%s,%.0f,%llu,%llu,%llu,%llu,%llu,%llu\n" : "%-12s %12.0f %8llu %8llu %8llu %8llu %8llu %10llu\n",
+                Msgs[i].Name, Result.MsgsPerSec, (unsigned long long)Result.Min, (unsigned long long)Result.P50,
+                (unsigned long long)Result.P90, (unsigned long long)Result.P99, (unsigned long long)Result.P999,
+                (unsigned long long)Result.Max);
+    }
+
+    /*
+    ** The app's own view of the same runs, from its diagnostics packet
+    */
+    Msgs[2].Handler(&Msgs[2].Buf);
+    if (!Csv && BenchDiagSeen)
+    {
+        fprintf(BenchOut, "\napp diagnostics packet (ns):\n%-12s %12s %8s %8s %8s %8s %8s %10s\n", "histogram",
+                "count", "min", "mean", "p50", "p99", "p99.9", "max");
+        BenchPrintDiag("tick_exec", &BenchDiag.Payload.TickExec);
+        BenchPrintDiag("tick_period", &BenchDiag.Payload.TickPeriod);
+        BenchPrintDiag("odom_exec", &BenchDiag.Payload.OdomExec);
+        BenchPrintDiag("sched_late", &BenchDiag.Payload.SchedLate);
+    }
+
+    if (!Csv)
+    {
+        BenchPrintCompact();
+    }
+
+    if (!Csv)
+    {
+        fprintf(BenchOut, "\nstub cFE: %llu transmits (%llu bytes, %llu copied), %llu buffers allocated, "
+                "%llu events (%u held back), %llu pipe overflows\n",
+                (unsigned long long)StubCfe_GetCounters()->TransmitCount,
+                (unsigned long long)StubCfe_GetCounters()->TransmitBytes,
+                (unsigned long long)StubCfe_GetCounters()->CopyBytes,
+                (unsigned long long)StubCfe_GetCounters()->AllocateCount,
+                (unsigned long long)StubCfe_GetCounters()->EventCount, (unsigned int)RoverAppEvLimitSuppressed(),
+                (unsigned long long)StubCfe_GetCounters()->PipeOverflowCount);
+    }
+
+    fflush(BenchOut);
+    free(Samples);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,115 @@
+/*******************************************************************************
+**
+** File: rover_app_blackbox_decode.c
+**
+** Purpose:
+**   Renders a rover_app flight recorder dump (see rover_app_blackbox.h) as
+**   CSV, one row per HR tick with times relative to the trigger.
+**
+**   Usage: rover_app_blackbox_decode <dump file>
+**
+*******************************************************************************/
+
+#include "rover_app_blackbox.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+static const char *BlackBoxReasonName(uint32 Reason)
+{
+    switch (Reason)
+    {
+        case ROVER_APP_BLACKBOX_COMMAND:
+            return "COMMAND";
+        case ROVER_APP_BLACKBOX_ODOM_STALE:
+            return "ODOM_STALE";
+        case ROVER_APP_BLACKBOX_LEN_ERR:
+            return "LEN_ERR";
+        case ROVER_APP_BLACKBOX_APP_ERROR:
+            return "APP_ERROR";
+        default:
+            return "?";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    RoverAppBlackBoxFileHdr_t Hdr;
+    RoverAppBlackBoxEntry_t   Entry;
+    FILE                     *File;
+    double                    Trigger;
+    double                    Yaw;
+    const RoverAppPose_t     *Pose;
+    unsigned long             Count = 0;
+    unsigned long             Gaps  = 0;
+    uint32                    LastSeq = 0;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s <dump file>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    File = fopen(argv[1], "rb");
+    if (File == NULL)
+    {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    if (fread(&Hdr, sizeof(Hdr), 1, File) != 1 || Hdr.Magic != ROVER_APP_BLACKBOX_FILE_MAGIC)
+    {
+        fprintf(stderr, "%s: not a rover_app flight recorder dump\n", argv[1]);
+        fclose(File);
+        return EXIT_FAILURE;
+    }
+
+    if (Hdr.Version != ROVER_APP_BLACKBOX_FILE_VERSION || Hdr.EntrySize != sizeof(Entry))
+    {
+        fprintf(stderr, "%s: unsupported dump version %u (entry size %u)\n", argv[1], (unsigned int)Hdr.Version,
+                (unsigned int)Hdr.EntrySize);
+        fclose(File);
+        return EXIT_FAILURE;
+    }
+
+    Trigger = (double)Hdr.TriggerSeconds + ((double)Hdr.TriggerSubseconds / 4294967296.0);
+
+    printf("# %s at %.6f s, %u ticks\n", BlackBoxReasonName(Hdr.Reason), Trigger, (unsigned int)Hdr.EntryCount);
+    printf("seq,t_s,period_us,exec_us,odom_age_us,x,y,yaw,vx,wz,target_vx,target_wz,twist_vx,twist_wz\n");
+
+    while (fread(&Entry, sizeof(Entry), 1, File) == 1)
+    {
+        if (Count > 0 && Entry.Seq != LastSeq + 1)
+        {
+            Gaps++;
+        }
+        LastSeq = Entry.Seq;
+
+        Pose = &Entry.State.pose;
+        Yaw  = atan2(2.0 * ((double)Pose->qw * Pose->qz + (double)Pose->qx * Pose->qy),
+                     1.0 - 2.0 * ((double)Pose->qy * Pose->qy + (double)Pose->qz * Pose->qz));
+
+        printf("%u,%.6f,%u,%u,", (unsigned int)Entry.Seq,
+               (double)Entry.Seconds + ((double)Entry.Subseconds / 4294967296.0) - Trigger,
+               (unsigned int)Entry.PeriodUs, (unsigned int)Entry.ExecUs);
+        if (Entry.OdomAgeUs == ROVER_APP_BLACKBOX_NO_ODOM)
+        {
+            printf(",");
+        }
+        else
+        {
+            printf("%u,", (unsigned int)Entry.OdomAgeUs);
+        }
+        printf("%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n", (double)Pose->x, (double)Pose->y, Yaw,
+               (double)Entry.State.twist.linear_x, (double)Entry.State.twist.angular_z,
+               (double)Entry.Target.linear_x, (double)Entry.Target.angular_z, (double)Entry.Twist.linear_x,
+               (double)Entry.Twist.angular_z);
+        Count++;
+    }
+
+    fclose(File);
+
+    fprintf(stderr, "%lu ticks, %lu gaps\n", Count, Gaps);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,285 @@
+/*******************************************************************************
+**
+** File: rover_app_replay.c
+**
+** Purpose:
+**   Replays a rover_app input recording (see rover_app_record.h) through
+**   the app's dispatcher against the stub cFE, as fast as it will go.
+**   CFE_TIME_GetTime() returns each message's recorded receive time while
+**   it is handled, so a replay is deterministic: the telemetry digest at
+**   the end is the same on every run of the same recording and build, and
+**   changes when a handler change changes what the app sends.
+**
+**   Usage: rover_app_replay [-v] <recording>
+**      -v  keep the app's console output and print events
+**
+*******************************************************************************/
+
+#include "rover_app_events.h"
+#include "rover_app.h"
+#include "rover_app_dispatch.h"
+#include "rover_app_record.h"
+#include "stub_cfe.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define REPLAY_ROWS (ROVER_APP_MSG_UNKNOWN_CC + 1) /* Per dispatch index, unknown MIDs and CCs included */
+
+typedef struct
+{
+    uint64 Count;
+    uint64 Ns;
+    uint64 MaxNs;
+} ReplayRow_t;
+
+static FILE              *ReplayOut;
+static CFE_TIME_SysTime_t ReplayTime;
+static uint64             ReplayDigest = 0xcbf29ce484222325ULL; /* FNV-1a offset basis */
+static uint64             ReplayTlmCount;
+static ReplayRow_t        ReplayRows[REPLAY_ROWS];
+
+static CFE_TIME_SysTime_t ReplayTimeSource(void *Arg)
+{
+    (void)Arg;
+
+    return ReplayTime;
+}
+
+/*
+** FNV-1a over every packet the app sends
+*/
+static void ReplayTransmitHook(const CFE_MSG_Message_t *MsgPtr, CFE_MSG_Size_t Size, void *Arg)
+{
+    const uint8 *Bytes = (const uint8 *)MsgPtr;
+    size_t       i;
+
+    (void)Arg;
+
+    for (i = 0; i < Size; i++)
+    {
+        ReplayDigest = (ReplayDigest ^ Bytes[i]) * 0x100000001b3ULL;
+    }
+    ReplayTlmCount++;
+}
+
+static int ReplayCompareU64(const void *a, const void *b)
+{
+    uint64 x = *(const uint64 *)a;
+    uint64 y = *(const uint64 *)b;
+
+    return (x > y) - (x < y);
+}
+
+static uint8 *ReplayLoad(const char *Filename, size_t *Size)
+{
+    FILE  *File;
+    uint8 *Bytes;
+    long   Length;
+
+    File = fopen(Filename, "rb");
+    if (File == NULL)
+    {
+        perror(Filename);
+        return NULL;
+    }
+
+    if (fseek(File, 0, SEEK_END) != 0 || (Length = ftell(File)) < 0 || fseek(File, 0, SEEK_SET) != 0)
+    {
+        perror(Filename);
+        fclose(File);
+        return NULL;
+    }
+
+    Bytes = malloc((size_t)Length + 1);
+    if (Bytes == NULL || fread(Bytes, 1, (size_t)Length, File) != (size_t)Length)
+    {
+        fprintf(stderr, "%s: read failed\n", Filename);
+        free(Bytes);
+        fclose(File);
+        return NULL;
+    }
+
+    fclose(File);
+    *Size = (size_t)Length;
+
+    return Bytes;
+}
+
+int main(int argc, char *argv[])
+{
+    RoverAppRecordFileHdr_t FileHdr;
+    RoverAppRecordHdr_t     Hdr;
+    union
+    {
+        CFE_SB_Buffer_t Buf;
+        uint8           Bytes[ROVER_APP_RECORD_RING_SIZE / 4];
+    } Msg;
+    uint8  *File;
+    size_t  FileSize = 0;
+    size_t  Offset;
+    uint64 *Samples;
+    uint64  Count = 0;
+    uint64  Truncated = 0;
+    uint64  First = 0;
+    uint64  Last  = 0;
+    uint64  WallNs;
+    uint64  t0;
+    uint32  Index;
+    bool    Verbose = false;
+    int     opt;
+
+    while ((opt = getopt(argc, argv, "v")) != -1)
+    {
+        switch (opt)
+        {
+            case 'v':
+                Verbose = true;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-v] <recording>\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (optind != argc - 1)
+    {
+        fprintf(stderr, "usage: %s [-v] <recording>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    File = ReplayLoad(argv[optind], &FileSize);
+    if (File == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (FileSize < sizeof(FileHdr))
+    {
+        fprintf(stderr, "%s: not a rover_app recording\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+    memcpy(&FileHdr, File, sizeof(FileHdr));
+    if (FileHdr.Magic != ROVER_APP_RECORD_FILE_MAGIC)
+    {
+        fprintf(stderr, "%s: not a rover_app recording\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+    if (FileHdr.Version != ROVER_APP_RECORD_FILE_VERSION || FileHdr.HdrSize != sizeof(Hdr))
+    {
+        fprintf(stderr, "%s: unsupported recording version %u (header size %u)\n", argv[optind],
+                (unsigned int)FileHdr.Version, (unsigned int)FileHdr.HdrSize);
+        return EXIT_FAILURE;
+    }
+
+    /* One sample per record at most */
+    Samples = malloc(sizeof(*Samples) * (FileSize / ROVER_APP_RECORD_ALIGN + 1));
+    if (Samples == NULL)
+    {
+        perror("malloc");
+        return EXIT_FAILURE;
+    }
+
+    ReplayOut = fdopen(dup(STDOUT_FILENO), "w");
+    if (ReplayOut == NULL)
+    {
+        perror("fdopen");
+        return EXIT_FAILURE;
+    }
+    if (!Verbose && freopen("/dev/null", "w", stdout) == NULL)
+    {
+        perror("freopen");
+        return EXIT_FAILURE;
+    }
+
+    StubCfe_Reset();
+    StubCfe_SetVerbose(Verbose);
+    StubCfe_SetTimeSource(ReplayTimeSource, NULL);
+
+    if (RoverAppInit() != CFE_SUCCESS)
+    {
+        fprintf(stderr, "RoverAppInit failed\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Startup telemetry is not part of the replay */
+    StubCfe_SetTransmitHook(ReplayTransmitHook, NULL);
+
+    WallNs = StubCfe_NowNs();
+    for (Offset = sizeof(FileHdr); Offset + sizeof(Hdr) <= FileSize; Offset += ROVER_APP_RECORD_SIZE(Hdr.Length))
+    {
+        memcpy(&Hdr, &File[Offset], sizeof(Hdr));
+        if (Hdr.Length > sizeof(Msg) || Offset + sizeof(Hdr) + Hdr.Length > FileSize)
+        {
+            Truncated++;
+            break;
+        }
+
+        memcpy(Msg.Bytes, &File[Offset + sizeof(Hdr)], Hdr.Length);
+        ReplayTime.Seconds    = Hdr.Seconds;
+        ReplayTime.Subseconds = Hdr.Subseconds;
+        if (Count == 0)
+        {
+            First = StubCfe_SysTimeToNs(ReplayTime);
+        }
+        Last = StubCfe_SysTimeToNs(ReplayTime);
+
+        Index = RoverAppDispatchLookup(&Msg.Buf.Msg);
+
+        t0 = StubCfe_NowNs();
+        RoverAppProcessCommandPacket(&Msg.Buf);
+        Samples[Count] = StubCfe_NowNs() - t0;
+
+        ReplayRows[Index].Count++;
+        ReplayRows[Index].Ns += Samples[Count];
+        if (Samples[Count] > ReplayRows[Index].MaxNs)
+        {
+            ReplayRows[Index].MaxNs = Samples[Count];
+        }
+        Count++;
+    }
+    WallNs = StubCfe_NowNs() - WallNs;
+
+    fprintf(ReplayOut, "rover_app replay: %llu messages, %.3f s recorded, replayed in %.3f s (%.0f msgs/s)%s\n",
+            (unsigned long long)Count, (double)(Last - First) * 1e-9, (double)WallNs * 1e-9,
+            (WallNs != 0) ? (double)Count * 1e9 / (double)WallNs : 0.0, Truncated ? ", recording truncated" : "");
+
+    if (Count != 0)
+    {
+        fprintf(ReplayOut, "\n%-8s %3s %10s %10s %10s\n", "mid", "cc", "msgs", "mean [ns]", "max [ns]");
+        for (Index = 0; Index < REPLAY_ROWS; Index++)
+        {
+            if (ReplayRows[Index].Count == 0)
+            {
+                continue;
+            }
+            if (Index < ROVER_APP_MSG_COUNT)
+            {
+                fprintf(ReplayOut, "0x%04X   %3u", (unsigned int)RoverAppDispatchTable[Index].MsgId,
+                        (unsigned int)RoverAppDispatchTable[Index].FcnCode);
+            }
+            else
+            {
+                fprintf(ReplayOut, "%-12s", (Index == ROVER_APP_MSG_UNKNOWN_MID) ? "bad MID" : "bad CC");
+            }
+            fprintf(ReplayOut, " %10llu %10.0f %10llu\n", (unsigned long long)ReplayRows[Index].Count,
+                    (double)ReplayRows[Index].Ns / (double)ReplayRows[Index].Count,
+                    (unsigned long long)ReplayRows[Index].MaxNs);
+        }
+
+        qsort(Samples, Count, sizeof(Samples[0]), ReplayCompareU64);
+        fprintf(ReplayOut, "\nper message: p50 %llu ns, p99 %llu ns, max %llu ns\n",
+                (unsigned long long)Samples[(Count - 1) / 2], (unsigned long long)Samples[((Count - 1) * 99) / 100],
+                (unsigned long long)Samples[Count - 1]);
+    }
+
+    fprintf(ReplayOut, "telemetry: %llu packets, digest %016llx\n", (unsigned long long)ReplayTlmCount,
+            (unsigned long long)ReplayDigest);
+
+    fflush(ReplayOut);
+    free(Samples);
+    free(File);
+
+    return Truncated ? EXIT_FAILURE : EXIT_SUCCESS;
+}
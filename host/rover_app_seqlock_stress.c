@@ -0,0 +1,230 @@
+/*******************************************************************************
+**
+** File: rover_app_seqlock_stress.c
+**
+** Purpose:
+**   Contention stress of the rover_app seqlock cells (rover_app_seqlock.h).
+**   One writer thread per cell publishes payloads whose words all carry the
+**   same counter; reader threads check every copy they get for mixed
+**   counters (a torn read) or a counter going backwards.  Exits non-zero on
+**   any violation.
+**
+**   Usage: rover_app_seqlock_stress [-t seconds] [-r readers]
+**
+*******************************************************************************/
+
+#include "rover_app_seqlock.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define STRESS_MAX_READERS 16
+
+typedef struct
+{
+    pthread_t Thread;
+    uint64    Reads;
+    uint64    Failed; /* Retry budget exhausted, previous copy kept */
+    uint64    Torn;
+    uint64    Backwards;
+} StressReader_t;
+
+static RoverAppOdomCell_t  OdomCell;
+static RoverAppTwistCell_t TwistCell;
+static volatile bool       StressRun = true;
+
+/*
+** Every payload word carries the same 32-bit counter, stored bit for bit
+*/
+static void StressFill(void *Payload, size_t Size, uint32 Counter)
+{
+    size_t i;
+
+    for (i = 0; i + sizeof(Counter) <= Size; i += sizeof(Counter))
+    {
+        memcpy((uint8 *)Payload + i, &Counter, sizeof(Counter));
+    }
+}
+
+static bool StressConsistent(const void *Payload, size_t Size, uint32 *Counter)
+{
+    uint32 Word;
+    size_t i;
+
+    memcpy(Counter, Payload, sizeof(*Counter));
+
+    for (i = sizeof(Word); i + sizeof(Word) <= Size; i += sizeof(Word))
+    {
+        memcpy(&Word, (const uint8 *)Payload + i, sizeof(Word));
+        if (Word != *Counter)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void *StressOdomWriter(void *Arg)
+{
+    RoverAppOdometry_t Odom;
+    uint32             k = 1;
+
+    (void)Arg;
+
+    while (StressRun)
+    {
+        StressFill(&Odom, sizeof(Odom), k++);
+        RoverAppOdomPublish(&OdomCell, &Odom);
+    }
+
+    return NULL;
+}
+
+static void *StressTwistWriter(void *Arg)
+{
+    RoverAppTwist_t Twist;
+    uint32          k = 1;
+
+    (void)Arg;
+
+    while (StressRun)
+    {
+        StressFill(&Twist, sizeof(Twist), k++);
+        RoverAppTwistPublish(&TwistCell, &Twist);
+    }
+
+    return NULL;
+}
+
+static void StressCheck(StressReader_t *Reader, const void *Payload, size_t Size, uint32 *Last)
+{
+    uint32 Counter;
+
+    if (!StressConsistent(Payload, Size, &Counter))
+    {
+        Reader->Torn++;
+    }
+    else if ((int32)(Counter - *Last) < 0)
+    {
+        Reader->Backwards++;
+    }
+    else
+    {
+        *Last = Counter;
+    }
+}
+
+static void *StressReaderMain(void *Arg)
+{
+    StressReader_t    *Reader = Arg;
+    RoverAppOdometry_t Odom;
+    RoverAppTwist_t    Twist;
+    uint32             LastOdom  = 0;
+    uint32             LastTwist = 0;
+
+    memset(&Odom, 0, sizeof(Odom));
+    memset(&Twist, 0, sizeof(Twist));
+
+    while (StressRun)
+    {
+        if (RoverAppOdomRead(&OdomCell, &Odom))
+        {
+            StressCheck(Reader, &Odom, sizeof(Odom), &LastOdom);
+        }
+        else
+        {
+            Reader->Failed++;
+        }
+
+        if (RoverAppTwistRead(&TwistCell, &Twist))
+        {
+            StressCheck(Reader, &Twist, sizeof(Twist), &LastTwist);
+        }
+        else
+        {
+            Reader->Failed++;
+        }
+
+        Reader->Reads += 2;
+    }
+
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    StressReader_t  Readers[STRESS_MAX_READERS];
+    pthread_t       OdomWriter;
+    pthread_t       TwistWriter;
+    double          Duration    = 2.0;
+    uint32          ReaderCount = 3;
+    uint64          Reads       = 0;
+    uint64          Failed      = 0;
+    uint64          Torn        = 0;
+    uint64          Backwards   = 0;
+    struct timespec Sleep;
+    uint32          i;
+    int             opt;
+
+    while ((opt = getopt(argc, argv, "t:r:")) != -1)
+    {
+        switch (opt)
+        {
+            case 't':
+                Duration = strtod(optarg, NULL);
+                break;
+            case 'r':
+                ReaderCount = (uint32)strtoul(optarg, NULL, 0);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-t seconds] [-r readers]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (ReaderCount == 0 || ReaderCount > STRESS_MAX_READERS)
+    {
+        fprintf(stderr, "readers must be 1..%d\n", STRESS_MAX_READERS);
+        return EXIT_FAILURE;
+    }
+
+    memset(Readers, 0, sizeof(Readers));
+    memset(&OdomCell, 0, sizeof(OdomCell));
+    memset(&TwistCell, 0, sizeof(TwistCell));
+
+    pthread_create(&OdomWriter, NULL, StressOdomWriter, NULL);
+    pthread_create(&TwistWriter, NULL, StressTwistWriter, NULL);
+    for (i = 0; i < ReaderCount; i++)
+    {
+        pthread_create(&Readers[i].Thread, NULL, StressReaderMain, &Readers[i]);
+    }
+
+    Sleep.tv_sec  = (time_t)Duration;
+    Sleep.tv_nsec = (long)((Duration - (double)Sleep.tv_sec) * 1e9);
+    nanosleep(&Sleep, NULL);
+    StressRun = false;
+
+    pthread_join(OdomWriter, NULL);
+    pthread_join(TwistWriter, NULL);
+    for (i = 0; i < ReaderCount; i++)
+    {
+        pthread_join(Readers[i].Thread, NULL);
+        Reads += Readers[i].Reads;
+        Failed += Readers[i].Failed;
+        Torn += Readers[i].Torn;
+        Backwards += Readers[i].Backwards;
+    }
+
+    printf("seqlock stress: %u readers, %.1f s, %ld CPUs\n", (unsigned int)ReaderCount, Duration,
+           sysconf(_SC_NPROCESSORS_ONLN));
+    printf("  writes: odom %u, twist %u generations\n", (unsigned int)(OdomCell.Seq / 2),
+           (unsigned int)(TwistCell.Seq / 2));
+    printf("  reads %llu, retry budget exhausted %llu, torn %llu, backwards %llu\n", (unsigned long long)Reads,
+           (unsigned long long)Failed, (unsigned long long)Torn, (unsigned long long)Backwards);
+    printf("  %s\n", (Torn == 0 && Backwards == 0) ? "PASS" : "FAIL");
+
+    return (Torn == 0 && Backwards == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,1118 @@
+/*******************************************************************************
+**
+** File: rover_app_sim.c
+**
+** Purpose:
+**   Faster-than-real-time closed-loop soak test of rover_app.  A planar
+**   kinematic rover consumes ROVER_APP_TLM_TWIST_MID and produces
+**   ROVER_APP_CMD_ODOM_MID odometry, a virtual clock generates the
+**   ROVER_APP_HR_CONTROL_MID wakeups, HK requests and a ground twist
+**   command profile.  Everything goes through the stub software bus and
+**   is serviced from the app pipe the same way RoverAppMain() does.
+**
+**   With -b the bridge delivers odometry in bursts of that many messages
+**   back to back, as a batching ROS bridge does.  With -T the ground
+**   twist commands are uploaded that many seconds ahead as time-tagged
+**   commands, and cmd->odom latency counts from their execution time.
+**   The latency runs until odometry reports the commanded twist, so it
+**   includes the acceleration ramp; -S turns twist shaping off to see the
+**   pipeline alone.  With -P the rover follows an uploaded figure-eight
+**   path of that many waypoints instead of the ground twist commands.
+**   -N, -D and -H set the output policy of the twist the model drives
+**   from: a packet every N ticks, only on change beyond the deadband D,
+**   and at least every H ticks.  The report counts the HR state bundles
+**   and how old their first sample is when they go out.  -R records the
+**   app's input to a file for rover_app_replay, with the recorder's
+**   writer run on the virtual clock in place of its task.  -K dumps the
+**   flight recorder to a file at the end of the run, for
+**   rover_app_blackbox_decode.  -L loads a table with twice the
+**   shaping limits at that mission time, through Table Services and the
+**   next HK request, as a ground table load does.  -W restarts the app
+**   at that mission time, warm from the Critical Data Store, or cold as
+**   after a power-on reset with -C, and reports how far the first state
+**   and twist after it are off and how long the state takes to get back
+**   on the model.  -O keeps the app down that long before the restart,
+**   with the rover parked, so the CDS block is stale when it comes back.
+**
+**   Usage: rover_app_sim [-t seconds] [-r control_hz] [-o odom_hz]
+**                        [-g command_period_s] [-b odom_burst]
+**                        [-T time_tag_lead_s] [-S] [-P path_points]
+**                        [-N period_ticks] [-D deadband] [-H heartbeat_ticks]
+**                        [-R recording] [-K blackbox_dump] [-L load_time_s]
+**                        [-W restart_time_s] [-C] [-O outage_s] [-v]
+**
+*******************************************************************************/
+
+#include "rover_app_events.h"
+#include "rover_app.h"
+#include "rover_app_msgids.h"
+#include "rover_app_shape.h"
+#include "rover_app_record.h"
+#include "rover_app_blackbox.h"
+#include "rover_app_params.h"
+#include "stub_cfe.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#define SIM_HIST_BUCKETS 512
+#define SIM_NS_PER_SEC   1000000000ULL
+#define SIM_PATH_SIZE    20.0f /* Figure-eight half width, m */
+#define SIM_RECOVER_M    0.1   /* State this close to the model counts as back after a restart */
+
+extern RoverAppData_t RoverAppData;
+
+/*
+** Log-linear histogram, 8 sub-buckets per power of two
+*/
+typedef struct
+{
+    uint64 Count;
+    uint64 Sum;
+    uint64 Min;
+    uint64 Max;
+    uint64 Buckets[SIM_HIST_BUCKETS];
+} SimHist_t;
+
+typedef struct
+{
+    /* Virtual clock */
+    uint64 NowNs;
+
+    /* Kinematic model state */
+    double x;
+    double y;
+    double yaw;
+    double v;
+    double w;
+    uint64 LastIntegrateNs;
+    uint64 TwistUpdates;
+
+    /* Odometry messages the bridge delivers back to back */
+    uint32 OdomBurst;
+
+    /* Ground commands sent this far ahead as time-tagged commands, 0 for none */
+    uint64 TimeTagLeadNs;
+
+    /* Outstanding ground command for latency measurement */
+    bool   CmdPending;
+    uint64 CmdIssuedNs;
+    float  CmdLinear;
+    float  CmdAngular;
+
+    SimHist_t CmdToOdom;
+    SimHist_t TickCost;
+    SimHist_t OdomCost;
+    SimHist_t StateError; /* Control loop state vs model, micrometres */
+    SimHist_t PathError;  /* Distance from the uploaded path, micrometres */
+    SimHist_t BundleAge;  /* First sample of a state bundle when sent, ns */
+
+    /* HR state bundles */
+    uint64 BundleCount;
+    uint64 BundleSamples;
+    uint64 BundleBytes;
+    uint64 BundleBad; /* Size or sample offsets inconsistent */
+
+    /* Uploaded path, PathCount 0 for none */
+    uint32 PathCount;
+    float *PathX;
+    float *PathY;
+
+    /* Last per-message statistics packet the app sent */
+    bool               StatsValid;
+    RoverAppStatsTlm_t Stats;
+
+    /* Last command scheduler packet */
+    bool               SchedValid;
+    RoverAppSchedTlm_t Sched;
+
+    /* App restart, RestartNs 0 before it */
+    uint64          RestartNs;
+    bool            RestartTick;   /* The next tick is the first after it */
+    RoverAppTwist_t RestartTwist;  /* Sent before it */
+    double          RestartError;  /* State of the first tick after it vs model, m */
+    double          RestartStep;   /* Twist of that tick minus RestartTwist, m/s */
+    double          RestartTurn;   /* Same, rad/s */
+    uint64          RecoverNs;     /* First tick within SIM_RECOVER_M of the model, 0 for none */
+    RoverAppPose_t  RestartPose;   /* State of the first tick after it */
+    double          RestartDrift;  /* Farthest later state from it before odometry came in, m */
+} Sim_t;
+
+static Sim_t Sim;
+static FILE *SimOut;
+
+static void SimHistAdd(SimHist_t *Hist, uint64 Value)
+{
+    uint32 Index;
+    uint32 Msb;
+
+    if (Value < 8)
+    {
+        Index = (uint32)Value;
+    }
+    else
+    {
+        Msb   = 63 - (uint32)__builtin_clzll(Value);
+        Index = ((Msb - 2) * 8) + (uint32)((Value >> (Msb - 3)) & 7);
+    }
+
+    if (Hist->Count == 0 || Value < Hist->Min)
+    {
+        Hist->Min = Value;
+    }
+    if (Value > Hist->Max)
+    {
+        Hist->Max = Value;
+    }
+
+    Hist->Buckets[Index]++;
+    Hist->Count++;
+    Hist->Sum += Value;
+}
+
+static uint64 SimHistPercentile(const SimHist_t *Hist, double Pct)
+{
+    uint64 Target;
+    uint64 Seen = 0;
+    uint32 i;
+
+    if (Hist->Count == 0)
+    {
+        return 0;
+    }
+
+    Target = (uint64)ceil(Pct * (double)Hist->Count / 100.0);
+    for (i = 0; i < SIM_HIST_BUCKETS; i++)
+    {
+        Seen += Hist->Buckets[i];
+        if (Seen >= Target && Hist->Buckets[i] != 0)
+        {
+            /* Report the bucket's upper edge, clamped to the observed max */
+            uint64 Upper = (i < 8) ? i : (((uint64)(8 + (i % 8)) + 1) << ((i / 8) - 1)) - 1;
+            return (Upper < Hist->Max) ? Upper : Hist->Max;
+        }
+    }
+
+    return Hist->Max;
+}
+
+static void SimHistPrint(const char *Name, const char *Unit, double Scale, const SimHist_t *Hist)
+{
+    fprintf(SimOut, "  %-22s n=%-9llu min=%-9.3f mean=%-9.3f p50=%-9.3f p99=%-9.3f p99.9=%-9.3f max=%.3f %s\n", Name,
+            (unsigned long long)Hist->Count, Hist->Min * Scale,
+            (Hist->Count > 0) ? ((double)Hist->Sum / (double)Hist->Count) * Scale : 0.0,
+            SimHistPercentile(Hist, 50.0) * Scale, SimHistPercentile(Hist, 99.0) * Scale,
+            SimHistPercentile(Hist, 99.9) * Scale, Hist->Max * Scale, Unit);
+}
+
+static CFE_TIME_SysTime_t SimTimeSource(void *Arg)
+{
+    (void)Arg;
+
+    return StubCfe_NsToSysTime(Sim.NowNs);
+}
+
+/*
+** Kinematic unicycle: integrate the currently applied twist up to now
+*/
+static void SimIntegrate(void)
+{
+    double dt = (double)(Sim.NowNs - Sim.LastIntegrateNs) / (double)SIM_NS_PER_SEC;
+
+    if (fabs(Sim.w) > 1e-9)
+    {
+        double yaw1 = Sim.yaw + (Sim.w * dt);
+        Sim.x += (Sim.v / Sim.w) * (sin(yaw1) - sin(Sim.yaw));
+        Sim.y -= (Sim.v / Sim.w) * (cos(yaw1) - cos(Sim.yaw));
+        Sim.yaw = yaw1;
+    }
+    else
+    {
+        Sim.x += Sim.v * cos(Sim.yaw) * dt;
+        Sim.y += Sim.v * sin(Sim.yaw) * dt;
+    }
+
+    Sim.LastIntegrateNs = Sim.NowNs;
+}
+
+/*
+** Checks a state bundle and how long its first sample waited
+*/
+static void SimBundle(const RoverAppStateBundleTlm_t *Tlm, CFE_MSG_Size_t Size)
+{
+    CFE_TIME_SysTime_t Sent;
+    RoverAppStamp_t    First;
+    uint32             i;
+
+    Sim.BundleCount++;
+    Sim.BundleBytes += Size;
+    if (Size < offsetof(RoverAppStateBundleTlm_t, Payload.Sample) || Tlm->Payload.Count == 0 ||
+        Tlm->Payload.Count > ROVER_APP_BUNDLE_MAX_SAMPLES ||
+        Size != offsetof(RoverAppStateBundleTlm_t, Payload.Sample) + (Tlm->Payload.Count * sizeof(RoverAppStateSample_t)))
+    {
+        Sim.BundleBad++;
+        return;
+    }
+
+    Sim.BundleSamples += Tlm->Payload.Count;
+    for (i = 1; i < Tlm->Payload.Count; i++)
+    {
+        if (Tlm->Payload.Sample[i].OffsetUs <= Tlm->Payload.Sample[i - 1].OffsetUs)
+        {
+            Sim.BundleBad++;
+            return;
+        }
+    }
+
+    CFE_MSG_GetMsgTime(&Tlm->TlmHeader.Msg, &Sent);
+    First = ((RoverAppStamp_t)Tlm->Payload.Seconds << 32) | Tlm->Payload.Subseconds;
+    if (RoverAppTimeToStamp(Sent) >= First)
+    {
+        SimHistAdd(&Sim.BundleAge, ((RoverAppTimeToStamp(Sent) - First) * SIM_NS_PER_SEC) >> 32);
+    }
+}
+
+/*
+** The app's twist output drives the model
+*/
+static void SimTransmitHook(const CFE_MSG_Message_t *MsgPtr, CFE_MSG_Size_t Size, void *Arg)
+{
+    CFE_SB_MsgId_t                   MsgId;
+    const RoverAppTlmRobotCommand_t *Cmd;
+
+    (void)Arg;
+
+    CFE_MSG_GetMsgId(MsgPtr, &MsgId);
+    if (CFE_SB_MsgIdToValue(MsgId) == ROVER_APP_STATS_TLM_MID && Size == sizeof(RoverAppStatsTlm_t))
+    {
+        memcpy(&Sim.Stats, MsgPtr, sizeof(Sim.Stats));
+        Sim.StatsValid = true;
+        return;
+    }
+    if (CFE_SB_MsgIdToValue(MsgId) == ROVER_APP_SCHED_TLM_MID && Size == sizeof(RoverAppSchedTlm_t))
+    {
+        memcpy(&Sim.Sched, MsgPtr, sizeof(Sim.Sched));
+        Sim.SchedValid = true;
+        return;
+    }
+    if (CFE_SB_MsgIdToValue(MsgId) == ROVER_APP_STATE_BUNDLE_TLM_MID)
+    {
+        SimBundle((const RoverAppStateBundleTlm_t *)MsgPtr, Size);
+        return;
+    }
+    if (CFE_SB_MsgIdToValue(MsgId) != ROVER_APP_TLM_TWIST_MID || Size < sizeof(RoverAppTlmRobotCommand_t))
+    {
+        return;
+    }
+
+    Cmd = (const RoverAppTlmRobotCommand_t *)MsgPtr;
+
+    SimIntegrate();
+    Sim.v = Cmd->twist.linear_x;
+    Sim.w = Cmd->twist.angular_z;
+    Sim.TwistUpdates++;
+}
+
+/*
+** Service the app pipes like RoverAppMain() and RoverAppControlTask() do,
+** without pending: one batch per wakeup until the pipe is empty.  The
+** control task runs at higher priority, so its pipe goes first.
+*/
+static void SimServicePipe(CFE_SB_PipeId_t PipeId, SimHist_t *Cost)
+{
+    CFE_SB_Buffer_t *SBBufPtr;
+    uint64           t0;
+
+    while (CFE_SB_ReceiveBuffer(&SBBufPtr, PipeId, CFE_SB_POLL) == CFE_SUCCESS)
+    {
+        t0 = StubCfe_NowNs();
+        RoverAppDrainPipe(PipeId, SBBufPtr);
+        if (Cost != NULL)
+        {
+            SimHistAdd(Cost, StubCfe_NowNs() - t0);
+        }
+    }
+}
+
+static void SimServiceApp(SimHist_t *Cost)
+{
+#if ROVER_APP_CONTROL_TASK_ENABLE
+    SimServicePipe(RoverAppData.ControlPipe, Cost);
+#endif
+    SimServicePipe(RoverAppData.CommandPipe, Cost);
+}
+
+/*
+** Distance from the model rover to the nearest segment of the path
+*/
+static double SimPathDistance(double x, double y)
+{
+    double Best = INFINITY;
+    double Ex;
+    double Ey;
+    double Dx;
+    double Dy;
+    double Len2;
+    double u;
+    uint32 k;
+
+    for (k = 0; k + 1 < Sim.PathCount; k++)
+    {
+        Ex   = Sim.PathX[k + 1] - Sim.PathX[k];
+        Ey   = Sim.PathY[k + 1] - Sim.PathY[k];
+        Dx   = x - Sim.PathX[k];
+        Dy   = y - Sim.PathY[k];
+        Len2 = (Ex * Ex) + (Ey * Ey);
+        u    = (Len2 > 0.0) ? fmax(0.0, fmin(1.0, ((Dx * Ex) + (Dy * Ey)) / Len2)) : 0.0;
+        Best = fmin(Best, hypot(Dx - (u * Ex), Dy - (u * Ey)));
+    }
+
+    return Best;
+}
+
+/*
+** Upload a figure-eight through the origin, crossing itself there, and
+** follow it at 1 m/s
+*/
+static void SimStartPath(uint32 Points)
+{
+    RoverAppPathLoadCmd_t  Load;
+    RoverAppPathStartCmd_t Start;
+    double                 t;
+    uint32                 k;
+
+    Sim.PathCount = Points;
+    Sim.PathX     = malloc(Points * sizeof(float));
+    Sim.PathY     = malloc(Points * sizeof(float));
+
+    memset(&Load, 0, sizeof(Load));
+    CFE_MSG_Init(&Load.CmdHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_CMD_MID), sizeof(Load));
+    CFE_MSG_SetFcnCode(&Load.CmdHeader.Msg, ROVER_APP_PATH_LOAD_CC);
+
+    for (k = 0; k < Points; k++)
+    {
+        t            = (2.0 * M_PI * k) / (Points - 1);
+        Sim.PathX[k] = SIM_PATH_SIZE * (float)sin(t);
+        Sim.PathY[k] = SIM_PATH_SIZE * (float)(sin(t) * cos(t));
+
+        Load.Point[k % ROVER_APP_PATH_POINTS_PER_CMD].x = Sim.PathX[k];
+        Load.Point[k % ROVER_APP_PATH_POINTS_PER_CMD].y = Sim.PathY[k];
+
+        if ((k + 1) % ROVER_APP_PATH_POINTS_PER_CMD == 0 || k + 1 == Points)
+        {
+            Load.PointCount = (uint16)((k % ROVER_APP_PATH_POINTS_PER_CMD) + 1);
+            Load.FirstPoint = k + 1 - Load.PointCount;
+            CFE_SB_TransmitMsg(&Load.CmdHeader.Msg, true);
+            SimServiceApp(NULL);
+        }
+    }
+
+    CFE_MSG_Init(&Start.CmdHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_CMD_MID), sizeof(Start));
+    CFE_MSG_SetFcnCode(&Start.CmdHeader.Msg, ROVER_APP_PATH_START_CC);
+    Start.Speed     = 1.0f;
+    Start.Lookahead = 1.5f;
+    CFE_SB_TransmitMsg(&Start.CmdHeader.Msg, true);
+    SimServiceApp(NULL);
+}
+
+static void SimSendOdom(void)
+{
+    RoverAppCmdRobotState_t Odom;
+    float                   Linear;
+    float                   Angular;
+    uint32                  i;
+
+    SimIntegrate();
+
+    CFE_MSG_Init(&Odom.CmdHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_CMD_ODOM_MID), sizeof(Odom));
+    Odom.odom.pose.x            = (float)Sim.x;
+    Odom.odom.pose.y            = (float)Sim.y;
+    Odom.odom.pose.z            = 0.0f;
+    Odom.odom.pose.qx           = 0.0f;
+    Odom.odom.pose.qy           = 0.0f;
+    Odom.odom.pose.qz           = (float)sin(Sim.yaw / 2.0);
+    Odom.odom.pose.qw           = (float)cos(Sim.yaw / 2.0);
+    Linear                      = (float)Sim.v;
+    Angular                     = (float)Sim.w;
+    Odom.odom.twist.linear_x    = Linear;
+    Odom.odom.twist.linear_y    = 0.0f;
+    Odom.odom.twist.linear_z    = 0.0f;
+    Odom.odom.twist.angular_x   = 0.0f;
+    Odom.odom.twist.angular_y   = 0.0f;
+    Odom.odom.twist.angular_z   = Angular;
+
+    if (Sim.PathCount != 0)
+    {
+        SimHistAdd(&Sim.PathError, (uint64)(SimPathDistance(Sim.x, Sim.y) * 1e6));
+    }
+
+    if (Sim.CmdPending && Linear == Sim.CmdLinear && Angular == Sim.CmdAngular)
+    {
+        SimHistAdd(&Sim.CmdToOdom, Sim.NowNs - Sim.CmdIssuedNs);
+        Sim.CmdPending = false;
+    }
+
+    for (i = 0; i < Sim.OdomBurst; i++)
+    {
+        CFE_SB_TransmitMsg(&Odom.CmdHeader.Msg, true);
+    }
+    SimServiceApp(&Sim.OdomCost);
+}
+
+static void SimSendGroundTwist(uint32 Index)
+{
+    RoverAppTwistCmd_t       Cmd;
+    RoverAppSchedInsertCmd_t Insert;
+
+    CFE_MSG_Init(&Cmd.CmdHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_CMD_MID), sizeof(Cmd));
+    CFE_MSG_SetFcnCode(&Cmd.CmdHeader.Msg, ROVER_APP_SET_TWIST_CC);
+    memset(&Cmd.twist, 0, sizeof(Cmd.twist));
+
+    /* Deterministic profile; consecutive setpoints always differ */
+    Cmd.twist.linear_x  = 0.1f * (float)((Index % 10) + 1);
+    Cmd.twist.angular_z = 0.05f * (float)((int)(Index % 7) - 3);
+
+    Sim.CmdPending  = true;
+    Sim.CmdIssuedNs = Sim.NowNs + Sim.TimeTagLeadNs;
+    Sim.CmdLinear   = Cmd.twist.linear_x;
+    Sim.CmdAngular  = Cmd.twist.angular_z;
+
+    if (Sim.TimeTagLeadNs == 0)
+    {
+        CFE_SB_TransmitMsg(&Cmd.CmdHeader.Msg, true);
+    }
+    else
+    {
+        CFE_TIME_SysTime_t Exec = StubCfe_NsToSysTime(Sim.CmdIssuedNs);
+
+        memset(&Insert, 0, sizeof(Insert));
+        CFE_MSG_Init(&Insert.CmdHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_SCHED_CMD_MID), sizeof(Insert));
+        CFE_MSG_SetFcnCode(&Insert.CmdHeader.Msg, ROVER_APP_SCHED_INSERT_CC);
+        Insert.ExecSeconds    = Exec.Seconds;
+        Insert.ExecSubseconds = Exec.Subseconds;
+        memcpy(Insert.Cmd, &Cmd, sizeof(Cmd));
+
+        CFE_SB_TransmitMsg(&Insert.CmdHeader.Msg, true);
+    }
+    SimServiceApp(NULL);
+}
+
+/*
+** Output policy of the twist packets the model drives from
+*/
+static void SimSetOutput(const RoverAppOutputPolicy_t *Policy)
+{
+    RoverAppSetOutputCmd_t Cmd;
+
+    memset(&Cmd, 0, sizeof(Cmd));
+    CFE_MSG_Init(&Cmd.CmdHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_CMD_MID), sizeof(Cmd));
+    CFE_MSG_SetFcnCode(&Cmd.CmdHeader.Msg, ROVER_APP_SET_OUTPUT_CC);
+    Cmd.Stream = ROVER_APP_OUTPUT_TWIST;
+    Cmd.Policy = *Policy;
+
+    CFE_SB_TransmitMsg(&Cmd.CmdHeader.Msg, true);
+    SimServiceApp(NULL);
+}
+
+/*
+** Ask the command scheduler for its release statistics
+*/
+static void SimPrintSched(void)
+{
+    RoverAppSchedListCmd_t Cmd;
+
+    CFE_MSG_Init(&Cmd.CmdHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_SCHED_CMD_MID), sizeof(Cmd));
+    CFE_MSG_SetFcnCode(&Cmd.CmdHeader.Msg, ROVER_APP_SCHED_LIST_CC);
+    CFE_SB_TransmitMsg(&Cmd.CmdHeader.Msg, true);
+    SimServiceApp(NULL);
+
+    if (!Sim.SchedValid)
+    {
+        fprintf(SimOut, "  no scheduler packet\n");
+        return;
+    }
+
+    fprintf(SimOut, "  time-tagged commands: %u inserted, %u released, %u pending, %u rejected, %u send errors, "
+                    "release late by mean %.3f max %.3f ms\n",
+            (unsigned int)Sim.Sched.Payload.InsertCount, (unsigned int)Sim.Sched.Payload.ReleaseCount,
+            (unsigned int)Sim.Sched.Payload.EntryCount, (unsigned int)Sim.Sched.Payload.RejectCount,
+            (unsigned int)Sim.Sched.Payload.SendErrorCount,
+            Sim.Sched.Payload.LateMeanNs * 1e-6, Sim.Sched.Payload.LateMaxNs * 1e-6);
+}
+
+/*
+** Start recording the app's input, or stop with a NULL Filename
+*/
+static void SimRecord(const char *Filename)
+{
+    RoverAppRecordStartCmd_t Cmd;
+
+    memset(&Cmd, 0, sizeof(Cmd));
+    CFE_MSG_Init(&Cmd.CmdHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_CMD_MID),
+                 (Filename != NULL) ? sizeof(Cmd) : sizeof(RoverAppRecordStopCmd_t));
+    CFE_MSG_SetFcnCode(&Cmd.CmdHeader.Msg, (Filename != NULL) ? ROVER_APP_RECORD_START_CC : ROVER_APP_RECORD_STOP_CC);
+    if (Filename != NULL)
+    {
+        strncpy(Cmd.Filename, Filename, sizeof(Cmd.Filename) - 1);
+    }
+
+    CFE_SB_TransmitMsg(&Cmd.CmdHeader.Msg, true);
+    SimServiceApp(NULL);
+    RoverAppRecordService();
+}
+
+/*
+** Freeze the flight recorder and write it to Filename
+*/
+static void SimBlackBoxDump(const char *Filename)
+{
+    RoverAppBlackBoxDumpCmd_t Cmd;
+
+    memset(&Cmd, 0, sizeof(Cmd));
+    CFE_MSG_Init(&Cmd.CmdHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_CMD_MID), sizeof(Cmd));
+    CFE_MSG_SetFcnCode(&Cmd.CmdHeader.Msg, ROVER_APP_BLACKBOX_DUMP_CC);
+    strncpy(Cmd.Filename, Filename, sizeof(Cmd.Filename) - 1);
+
+    CFE_SB_TransmitMsg(&Cmd.CmdHeader.Msg, true);
+    SimServiceApp(NULL);
+}
+
+static void SimSendNoArgs(uint32 MsgId, SimHist_t *Cost)
+{
+    RoverAppNoArgsCmd_t Cmd;
+
+    CFE_MSG_Init(&Cmd.CmdHeader.Msg, CFE_SB_ValueToMsgId(MsgId), sizeof(Cmd));
+    CFE_SB_TransmitMsg(&Cmd.CmdHeader.Msg, true);
+    SimServiceApp(Cost);
+}
+
+/*
+** HR wakeup; its MID is in the telemetry range, so it goes out with a
+** telemetry header as the scheduler sends it
+*/
+static void SimSendWakeup(SimHist_t *Cost)
+{
+    CFE_MSG_TelemetryHeader_t Wakeup;
+
+    CFE_MSG_Init(&Wakeup.Msg, CFE_SB_ValueToMsgId(ROVER_APP_HR_CONTROL_MID), sizeof(Wakeup));
+    CFE_SB_TransmitMsg(&Wakeup.Msg, true);
+    SimServiceApp(Cost);
+}
+
+/*
+** Ask the app for its per-message statistics and list the traffic.  Its
+** processing times come from the virtual clock here, so they are left out.
+*/
+static void SimPrintStats(void)
+{
+    RoverAppSendStatsCmd_t    Cmd;
+    const RoverAppMsgStats_t *Entry;
+    uint32                    i;
+
+    CFE_MSG_Init(&Cmd.CmdHeader.Msg, CFE_SB_ValueToMsgId(ROVER_APP_CMD_MID), sizeof(Cmd));
+    CFE_MSG_SetFcnCode(&Cmd.CmdHeader.Msg, ROVER_APP_SEND_STATS_CC);
+    CFE_SB_TransmitMsg(&Cmd.CmdHeader.Msg, true);
+    SimServiceApp(NULL);
+
+    if (!Sim.StatsValid)
+    {
+        fprintf(SimOut, "  no statistics packet\n");
+        return;
+    }
+
+    fprintf(SimOut, "\n  per-message traffic (stats packet):\n");
+    fprintf(SimOut, "  %-6s %-4s %10s %12s %8s\n", "MID", "CC", "msgs", "bytes", "len err");
+    for (i = 0; i < Sim.Stats.Payload.EntryCount && i < ROVER_APP_STATS_MAX_ENTRIES; i++)
+    {
+        Entry = &Sim.Stats.Payload.Entry[i];
+        if (Entry->MsgCount == 0)
+        {
+            continue;
+        }
+        fprintf(SimOut, "  0x%04X %-4u %10u %12u %8u\n", (unsigned int)Entry->MsgId, (unsigned int)Entry->FcnCode,
+                (unsigned int)Entry->MsgCount, (unsigned int)Entry->ByteCount, (unsigned int)Entry->LenErrCount);
+    }
+}
+
+/*
+** Move an event time later, unless it is never due
+*/
+static void SimShift(uint64 *Next, uint64 By)
+{
+    if (*Next != UINT64_MAX)
+    {
+        *Next += By;
+    }
+}
+
+/*
+** Compare the state the control loop just published with the model
+*/
+static void SimCheckState(void)
+{
+    RoverAppOdometry_t State;
+    double             Error;
+    double             Drift;
+
+    if (!RoverAppOdomRead(&RoverAppData.StateCell, &State))
+    {
+        return;
+    }
+
+    SimIntegrate();
+    Error = hypot(State.pose.x - Sim.x, State.pose.y - Sim.y);
+    SimHistAdd(&Sim.StateError, (uint64)(Error * 1e6));
+
+    if (Sim.RestartTick)
+    {
+        Sim.RestartTick  = false;
+        Sim.RestartPose  = State.pose;
+        Sim.RestartError = Error;
+        Sim.RestartStep  = RoverAppData.LastTwist.twist.linear_x - Sim.RestartTwist.linear_x;
+        Sim.RestartTurn  = RoverAppData.LastTwist.twist.angular_z - Sim.RestartTwist.angular_z;
+    }
+    else if (Sim.RestartNs != 0 && RoverAppData.OdomHistory.Count == 0)
+    {
+        Drift = hypot(State.pose.x - Sim.RestartPose.x, State.pose.y - Sim.RestartPose.y);
+        if (Drift > Sim.RestartDrift)
+        {
+            Sim.RestartDrift = Drift;
+        }
+    }
+    if (Sim.RestartNs != 0 && Sim.RecoverNs == 0 && Error < SIM_RECOVER_M)
+    {
+        Sim.RecoverNs = Sim.NowNs;
+    }
+}
+
+/*
+** Start the app on a fresh stub cFE, whose CDS still holds what the
+** previous start left in it
+*/
+static bool SimStartApp(bool Verbose, bool NoShaping, RoverAppTable_t *Table, const RoverAppOutputPolicy_t *Output)
+{
+    RoverAppParams_t Params;
+
+    StubCfe_Reset();
+    StubCfe_SetVerbose(Verbose);
+    StubCfe_SetTimeSource(SimTimeSource, NULL);
+    StubCfe_SetTransmitHook(SimTransmitHook, NULL);
+
+    if (RoverAppInit() != CFE_SUCCESS)
+    {
+        fprintf(stderr, "RoverAppInit failed\n");
+        return false;
+    }
+    if (NoShaping)
+    {
+        Table->LinearAccelMax  = 0.0f;
+        Table->LinearJerkMax   = 0.0f;
+        Table->AngularAccelMax = 0.0f;
+        Table->AngularJerkMax  = 0.0f;
+        RoverAppParamsMake(Table, &Params);
+        RoverAppShapeConfig(&Params);
+    }
+    if (Output != NULL)
+    {
+        SimSetOutput(Output);
+    }
+
+    return true;
+}
+
+static uint64 SimPeriodNs(double Hz)
+{
+    return (Hz > 0.0) ? (uint64)((double)SIM_NS_PER_SEC / Hz) : UINT64_MAX;
+}
+
+int main(int argc, char *argv[])
+{
+    double        Duration  = 3600.0;
+    double        ControlHz = 1000.0;
+    double        OdomHz    = 50.0;
+    double        CmdPeriod = 1.0;
+    bool          Verbose   = false;
+    bool          NoShaping = false;
+    uint32        PathPoints = 0;
+    bool          SetOutput  = false;
+    uint64        EndNs;
+    uint64        NextTick;
+    uint64        NextOdom;
+    uint64        NextCmd;
+    uint64        NextHk;
+    uint64        NextRecord = UINT64_MAX;
+    uint64        RecordPeriod = (uint64)ROVER_APP_RECORD_TASK_PERIOD_MS * 1000000ULL;
+    const char   *Recording  = NULL;
+    const char   *BlackBox   = NULL;
+    double        TableLoad  = -1.0;
+    uint64        NextTable  = UINT64_MAX;
+    double        Restart    = -1.0;
+    bool          ColdRestart = false;
+    uint64        NextRestart = UINT64_MAX;
+    uint64        OutageNs    = 0;
+    RoverAppTable_t Table    = ROVER_APP_TABLE_DEFAULTS;
+    uint64        TickPeriod;
+    uint64        OdomPeriod;
+    uint64        CmdPeriodNs;
+    uint64        HkPeriod = SIM_NS_PER_SEC;
+    uint64        WallStart;
+    uint64        WallNs;
+    uint64        Ticks    = 0;
+    uint32        CmdIndex = 0;
+    uint32        OdomBurst = 1;
+    double        TimeTagLead = 0.0;
+    struct rusage Usage;
+    RoverAppOutputPolicy_t Output;
+    int           opt;
+
+    memset(&Output, 0, sizeof(Output));
+    Output.Mode   = ROVER_APP_OUTPUT_PERIODIC;
+    Output.Period = ROVER_APP_OUTPUT_PERIOD;
+
+    while ((opt = getopt(argc, argv, "t:r:o:g:b:T:SP:N:D:H:R:K:L:W:CO:v")) != -1)
+    {
+        switch (opt)
+        {
+            case 't':
+                Duration = strtod(optarg, NULL);
+                break;
+            case 'r':
+                ControlHz = strtod(optarg, NULL);
+                break;
+            case 'o':
+                OdomHz = strtod(optarg, NULL);
+                break;
+            case 'g':
+                CmdPeriod = strtod(optarg, NULL);
+                break;
+            case 'b':
+                OdomBurst = (uint32)strtoul(optarg, NULL, 0);
+                break;
+            case 'T':
+                TimeTagLead = strtod(optarg, NULL);
+                break;
+            case 'S':
+                NoShaping = true;
+                break;
+            case 'P':
+                PathPoints = (uint32)strtoul(optarg, NULL, 0);
+                break;
+            case 'N':
+                Output.Period = (uint16)strtoul(optarg, NULL, 0);
+                SetOutput     = true;
+                break;
+            case 'D':
+                Output.Mode     = ROVER_APP_OUTPUT_ON_CHANGE;
+                Output.Deadband = strtof(optarg, NULL);
+                SetOutput       = true;
+                break;
+            case 'H':
+                Output.Heartbeat = (uint16)strtoul(optarg, NULL, 0);
+                SetOutput        = true;
+                break;
+            case 'R':
+                Recording = optarg;
+                break;
+            case 'K':
+                BlackBox = optarg;
+                break;
+            case 'L':
+                TableLoad = strtod(optarg, NULL);
+                break;
+            case 'W':
+                Restart = strtod(optarg, NULL);
+                break;
+            case 'C':
+                ColdRestart = true;
+                break;
+            case 'O':
+                OutageNs = (uint64)(strtod(optarg, NULL) * (double)SIM_NS_PER_SEC);
+                break;
+            case 'v':
+                Verbose = true;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-t seconds] [-r control_hz] [-o odom_hz] [-g command_period_s] [-b odom_burst] "
+                                "[-T time_tag_lead_s] [-S] [-P path_points] [-N period_ticks] [-D deadband] "
+                                "[-H heartbeat_ticks] [-R recording] [-K blackbox_dump] [-L load_time_s] "
+                                "[-W restart_time_s] [-C] [-O outage_s] [-v]\n",
+                        argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (ControlHz <= 0.0 || Duration <= 0.0 || OdomBurst == 0 || PathPoints == 1)
+    {
+        fprintf(stderr, "control rate, duration and odometry burst must be positive, a path needs 2 points\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Keep the app's console chatter out of the report */
+    SimOut = fdopen(dup(STDOUT_FILENO), "w");
+    if (SimOut == NULL)
+    {
+        perror("fdopen");
+        return EXIT_FAILURE;
+    }
+    if (!Verbose && freopen("/dev/null", "w", stdout) == NULL)
+    {
+        perror("freopen");
+        return EXIT_FAILURE;
+    }
+
+    memset(&Sim, 0, sizeof(Sim));
+    Sim.OdomBurst = OdomBurst;
+    Sim.TimeTagLeadNs = (TimeTagLead > 0.0) ? (uint64)(TimeTagLead * (double)SIM_NS_PER_SEC) : 0;
+
+    if (!SimStartApp(Verbose, NoShaping, &Table, SetOutput ? &Output : NULL))
+    {
+        return EXIT_FAILURE;
+    }
+    if (Recording != NULL)
+    {
+        SimRecord(Recording);
+        NextRecord = RecordPeriod;
+    }
+
+    TickPeriod  = SimPeriodNs(ControlHz);
+    OdomPeriod  = SimPeriodNs(OdomHz);
+    CmdPeriodNs = (CmdPeriod > 0.0) ? (uint64)(CmdPeriod * (double)SIM_NS_PER_SEC) : UINT64_MAX;
+    EndNs       = (uint64)(Duration * (double)SIM_NS_PER_SEC);
+
+    NextTick = TickPeriod;
+    NextOdom = OdomPeriod;
+    NextCmd  = 0;
+
+    if (PathPoints != 0)
+    {
+        SimStartPath(PathPoints);
+        NextCmd = UINT64_MAX;
+    }
+    NextHk   = HkPeriod;
+    if (TableLoad >= 0.0)
+    {
+        NextTable = (uint64)(TableLoad * (double)SIM_NS_PER_SEC);
+    }
+    if (Restart > 0.0)
+    {
+        NextRestart = (uint64)(Restart * (double)SIM_NS_PER_SEC);
+    }
+
+    WallStart = StubCfe_NowNs();
+
+    /*
+    ** Discrete-event loop on the virtual clock
+    */
+    while (Sim.NowNs < EndNs)
+    {
+        uint64 Next = NextTick;
+
+        if (NextOdom < Next)
+        {
+            Next = NextOdom;
+        }
+        if (NextCmd < Next)
+        {
+            Next = NextCmd;
+        }
+        if (NextHk < Next)
+        {
+            Next = NextHk;
+        }
+        if (NextRecord < Next)
+        {
+            Next = NextRecord;
+        }
+        if (NextTable < Next)
+        {
+            Next = NextTable;
+        }
+        if (NextRestart < Next)
+        {
+            Next = NextRestart;
+        }
+
+        Sim.NowNs = Next;
+
+        if (Sim.NowNs == NextRestart)
+        {
+            if (OutageNs != 0)
+            {
+                /* The rover stops and the mission resumes after the outage */
+                SimIntegrate();
+                Sim.v = 0.0;
+                Sim.w = 0.0;
+                Sim.NowNs += OutageNs;
+                Sim.LastIntegrateNs = Sim.NowNs;
+                EndNs += OutageNs;
+                SimShift(&NextTick, OutageNs);
+                SimShift(&NextOdom, OutageNs);
+                SimShift(&NextCmd, OutageNs);
+                SimShift(&NextHk, OutageNs);
+                SimShift(&NextRecord, OutageNs);
+                SimShift(&NextTable, OutageNs);
+            }
+            Sim.RestartNs    = Sim.NowNs;
+            Sim.RestartTick  = true;
+            Sim.RestartTwist = RoverAppData.LastTwist.twist;
+            if (ColdRestart)
+            {
+                StubCfe_CdsClear();
+            }
+            if (!SimStartApp(Verbose, NoShaping, &Table, SetOutput ? &Output : NULL))
+            {
+                return EXIT_FAILURE;
+            }
+            NextRestart = UINT64_MAX;
+        }
+
+        if (Sim.NowNs == NextTable)
+        {
+            Table.LinearAccelMax  *= 2.0f;
+            Table.LinearJerkMax   *= 2.0f;
+            Table.AngularAccelMax *= 2.0f;
+            Table.AngularJerkMax  *= 2.0f;
+            StubCfe_TableStage(ROVER_APP_TABLE_NAME, &Table, sizeof(Table));
+            NextTable = UINT64_MAX;
+        }
+        if (Sim.NowNs == NextCmd)
+        {
+            SimSendGroundTwist(CmdIndex++);
+            NextCmd += CmdPeriodNs;
+        }
+        if (Sim.NowNs == NextOdom)
+        {
+            SimSendOdom();
+            NextOdom += OdomPeriod * OdomBurst;
+        }
+        if (Sim.NowNs == NextTick)
+        {
+            SimSendWakeup(&Sim.TickCost);
+            SimCheckState();
+            NextTick += TickPeriod;
+            Ticks++;
+        }
+        if (Sim.NowNs == NextHk)
+        {
+            SimSendNoArgs(ROVER_APP_SEND_HK_MID, NULL);
+            NextHk += HkPeriod;
+        }
+        if (Sim.NowNs == NextRecord)
+        {
+            RoverAppRecordService();
+            NextRecord += RecordPeriod;
+        }
+    }
+    if (Recording != NULL)
+    {
+        SimRecord(NULL);
+    }
+    if (BlackBox != NULL)
+    {
+        SimBlackBoxDump(BlackBox);
+    }
+
+    WallNs = StubCfe_NowNs() - WallStart;
+    getrusage(RUSAGE_SELF, &Usage);
+
+    fprintf(SimOut, "rover_app sim: %.1f s mission time in %.3f s wall (%.0fx real time)\n", Duration,
+            (double)WallNs / (double)SIM_NS_PER_SEC, (Duration * (double)SIM_NS_PER_SEC) / (double)WallNs);
+    fprintf(SimOut, "  control %.0f Hz, odometry %.0f Hz, %llu ticks, %u ground commands, %llu twist updates\n",
+            ControlHz, OdomHz, (unsigned long long)Ticks, (unsigned int)CmdIndex,
+            (unsigned long long)Sim.TwistUpdates);
+    fprintf(SimOut, "  final pose x=%.3f y=%.3f yaw=%.3f\n\n", Sim.x, Sim.y, Sim.yaw);
+
+    SimHistPrint("cmd->odom latency", "ms", 1e-6, &Sim.CmdToOdom);
+    SimHistPrint("HR tick cost", "us", 1e-3, &Sim.TickCost);
+    SimHistPrint("odom processing cost", "us", 1e-3, &Sim.OdomCost);
+    SimHistPrint("tick state error", "mm", 1e-3, &Sim.StateError);
+    if (Sim.PathCount != 0)
+    {
+        SimHistPrint("path error", "mm", 1e-3, &Sim.PathError);
+        fprintf(SimOut, "  path: %u points, final pose %.3f m from its end\n", (unsigned int)Sim.PathCount,
+                hypot(Sim.x - Sim.PathX[Sim.PathCount - 1], Sim.y - Sim.PathY[Sim.PathCount - 1]));
+    }
+
+    fprintf(SimOut, "\n  memory: max RSS %ld KiB, command pipe high-water %u/%u, pipe overflows %llu\n",
+            Usage.ru_maxrss, (unsigned int)StubCfe_GetPipeHighWater(RoverAppData.CommandPipe),
+            (unsigned int)RoverAppData.PipeDepth, (unsigned long long)StubCfe_GetCounters()->PipeOverflowCount);
+#if ROVER_APP_CONTROL_TASK_ENABLE
+    fprintf(SimOut, "  control pipe high-water %u/%u\n", (unsigned int)StubCfe_GetPipeHighWater(RoverAppData.ControlPipe),
+            (unsigned int)ROVER_APP_CONTROL_PIPE_DEPTH);
+#endif
+    fprintf(SimOut, "  pipe batching: %u coalesced, %u dropped (HK)\n",
+            (unsigned int)RoverAppData.HkTlm.Payload.CoalescedCount,
+            (unsigned int)RoverAppData.HkTlm.Payload.DroppedCount);
+    fprintf(SimOut, "  odometry history: %u out of order, %u restarts on a time jump (HK)\n",
+            (unsigned int)RoverAppData.HkTlm.Payload.OdomRejectedCount,
+            (unsigned int)RoverAppData.HkTlm.Payload.OdomReseedCount);
+    fprintf(SimOut, "  shared state: %u reads gave up on a writer, previous copy kept (HK)\n",
+            (unsigned int)RoverAppData.HkTlm.Payload.StaleReadCount);
+    fprintf(SimOut, "  twist output: %u sent, %u held back by the output policy (HK)\n",
+            (unsigned int)RoverAppData.HkTlm.Payload.OutputSentCount[ROVER_APP_OUTPUT_TWIST],
+            (unsigned int)RoverAppData.HkTlm.Payload.OutputSuppressedCount[ROVER_APP_OUTPUT_TWIST]);
+    fprintf(SimOut, "  telemetry transmit: %u zero-copy, %u copied for want of a buffer, %u lost (HK)\n",
+            (unsigned int)RoverAppData.HkTlm.Payload.TxZeroCopyCount,
+            (unsigned int)RoverAppData.HkTlm.Payload.TxFallbackCount,
+            (unsigned int)RoverAppData.HkTlm.Payload.TxErrorCount);
+    fprintf(SimOut, "  events: %u held back by their rate limit (HK)\n",
+            (unsigned int)RoverAppData.HkTlm.Payload.EventSuppressedCount);
+    if (Recording != NULL)
+    {
+        fprintf(SimOut, "  recording: %u messages to %s, %u dropped (HK)\n",
+                (unsigned int)RoverAppData.HkTlm.Payload.RecordCount, Recording,
+                (unsigned int)RoverAppData.HkTlm.Payload.RecordDropCount);
+    }
+    if (TableLoad >= 0.0)
+    {
+        fprintf(SimOut, "  table: %u updates, %u rejected (HK)\n",
+                (unsigned int)RoverAppData.HkTlm.Payload.TableUpdateCount,
+                (unsigned int)RoverAppData.HkTlm.Payload.TableRejectCount);
+    }
+    if (Sim.RestartNs != 0)
+    {
+        fprintf(SimOut, "  %s restart at %.3f s after %.3f s down: first state %.1f mm off, twist step %.3f m/s %.3f rad/s, ",
+                ColdRestart ? "cold" : "warm", (double)Sim.RestartNs / (double)SIM_NS_PER_SEC,
+                (double)OutageNs / (double)SIM_NS_PER_SEC, Sim.RestartError * 1e3, Sim.RestartStep,
+                Sim.RestartTurn);
+        if (Sim.RecoverNs != 0)
+        {
+            fprintf(SimOut, "state back on the model after %.3f ms\n",
+                    (double)(Sim.RecoverNs - Sim.RestartNs) * 1e-6);
+        }
+        else
+        {
+            fprintf(SimOut, "state never back on the model\n");
+        }
+        fprintf(SimOut, "  state moved %.1f mm before the first odometry after the restart\n", Sim.RestartDrift * 1e3);
+        fprintf(SimOut, "  CDS: %u writes since the restart (HK)\n",
+                (unsigned int)RoverAppData.HkTlm.Payload.CdsSaveCount);
+    }
+    if (BlackBox != NULL)
+    {
+        fprintf(SimOut, "  flight recorder: last %u ticks to %s, %u dumps\n",
+                (unsigned int)((Ticks < ROVER_APP_BLACKBOX_ENTRIES) ? Ticks : ROVER_APP_BLACKBOX_ENTRIES - 1),
+                BlackBox, (unsigned int)RoverAppBlackBoxDumps());
+    }
+    fprintf(SimOut, "  state bundles: %llu packets, %llu samples for %llu ticks, %.1f bytes per tick, %llu bad\n",
+            (unsigned long long)Sim.BundleCount, (unsigned long long)Sim.BundleSamples, (unsigned long long)Ticks,
+            (Ticks != 0) ? (double)Sim.BundleBytes / (double)Ticks : 0.0, (unsigned long long)Sim.BundleBad);
+    SimHistPrint("bundle first sample age", "ms", 1e-6, &Sim.BundleAge);
+    if (Sim.TimeTagLeadNs != 0)
+    {
+        SimPrintSched();
+    }
+    SimPrintStats();
+    fprintf(SimOut, "  stub cFE: %llu transmits (%llu bytes copied), %llu events, %u buffers held\n",
+            (unsigned long long)StubCfe_GetCounters()->TransmitCount,
+            (unsigned long long)StubCfe_GetCounters()->CopyBytes, (unsigned long long)StubCfe_GetCounters()->EventCount,
+            (unsigned int)StubCfe_GetBuffersInUse());
+
+    fflush(SimOut);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,111 @@
+/*******************************************************************************
+**
+** File: rover_app_trace_decode.c
+**
+** Purpose:
+**   Renders a rover_app binary trace file (see rover_app_trace.h) as text.
+**
+**   Usage: rover_app_trace_decode <trace file>
+**
+*******************************************************************************/
+
+#include "rover_app_trace.h"
+
+#include <stdlib.h>
+
+static const char *TracePointName(uint8 Point)
+{
+    switch (Point)
+    {
+        case ROVER_APP_TRACE_PT_LOST:
+            return "LOST";
+        case ROVER_APP_TRACE_PT_GROUND_CMD:
+            return "GROUND_CMD";
+        case ROVER_APP_TRACE_PT_ODOM:
+            return "ODOM";
+        case ROVER_APP_TRACE_PT_HK:
+            return "HK";
+        case ROVER_APP_TRACE_PT_LEN_ERR:
+            return "LEN_ERR";
+        case ROVER_APP_TRACE_PT_HR_TICK:
+            return "HR_TICK";
+        default:
+            return "?";
+    }
+}
+
+static const char *TraceLevelName(uint8 Level)
+{
+    switch (Level)
+    {
+        case ROVER_APP_TRACE_LEVEL_ERROR:
+            return "ERR";
+        case ROVER_APP_TRACE_LEVEL_INFO:
+            return "INF";
+        case ROVER_APP_TRACE_LEVEL_DEBUG:
+            return "DBG";
+        default:
+            return "---";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    RoverAppTraceFileHdr_t Hdr;
+    RoverAppTraceRecord_t  Rec;
+    FILE                  *File;
+    unsigned long          Count = 0;
+    unsigned long          Lost  = 0;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s <trace file>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    File = fopen(argv[1], "rb");
+    if (File == NULL)
+    {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    if (fread(&Hdr, sizeof(Hdr), 1, File) != 1 || Hdr.Magic != ROVER_APP_TRACE_FILE_MAGIC)
+    {
+        fprintf(stderr, "%s: not a rover_app trace file\n", argv[1]);
+        fclose(File);
+        return EXIT_FAILURE;
+    }
+
+    if (Hdr.Version != ROVER_APP_TRACE_FILE_VERSION || Hdr.RecordSize != sizeof(Rec))
+    {
+        fprintf(stderr, "%s: unsupported trace version %u (record size %u)\n", argv[1], (unsigned int)Hdr.Version,
+                (unsigned int)Hdr.RecordSize);
+        fclose(File);
+        return EXIT_FAILURE;
+    }
+
+    printf("%10s %18s %3s %-10s %6s %3s %5s %s\n", "seq", "time [s]", "lvl", "point", "mid", "cc", "len", "status");
+
+    while (fread(&Rec, sizeof(Rec), 1, File) == 1)
+    {
+        if (Rec.Point == ROVER_APP_TRACE_PT_LOST)
+        {
+            printf("%10s %18s %3s %-10s %ld records overwritten\n", "-", "-", "---", "LOST", (long)Rec.Status);
+            Lost += (unsigned long)Rec.Status;
+            continue;
+        }
+
+        printf("%10u %18.6f %3s %-10s 0x%04X %3u %5u %ld\n", (unsigned int)Rec.Seq,
+               (double)Rec.Seconds + ((double)Rec.Subseconds / 4294967296.0), TraceLevelName(Rec.Level),
+               TracePointName(Rec.Point), (unsigned int)Rec.MsgId, (unsigned int)Rec.FcnCode,
+               (unsigned int)Rec.Length, (long)Rec.Status);
+        Count++;
+    }
+
+    fclose(File);
+
+    fprintf(stderr, "%lu records, %lu lost\n", Count, Lost);
+
+    return EXIT_SUCCESS;
+}
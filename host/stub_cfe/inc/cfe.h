@@ -0,0 +1,282 @@
+/*******************************************************************************
+**
+** File: cfe.h (host stub)
+**
+** Purpose:
+**   Minimal, in-process stand-in for the cFE API surface used by rover_app.
+**   It is only used by the host-side harness under host/ and is never part
+**   of a flight build.  Types and layouts follow cFE 7 closely enough that
+**   the flight sources compile unmodified and message handling costs
+**   (header decode, copies into SB memory) are representative.
+**
+*******************************************************************************/
+#ifndef _stub_cfe_h_
+#define _stub_cfe_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/*
+** OSAL common types
+*/
+typedef int8_t   int8;
+typedef int16_t  int16;
+typedef int32_t  int32;
+typedef int64_t  int64;
+typedef uint8_t  uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef uint64_t uint64;
+typedef uint32   osal_id_t;
+
+#define OS_SUCCESS 0
+#define OS_ERROR   (-1)
+
+#define CFE_MISSION_MAX_API_LEN   20
+#define CFE_MISSION_TBL_MAX_FULL_NAME_LEN 40
+#define CFE_MISSION_MAX_PATH_LEN  64
+#define CFE_MISSION_SB_MAX_SB_MSG_SIZE 32768
+#define CFE_MISSION_EVS_MAX_MESSAGE_LENGTH 122
+
+/*
+** Status codes
+*/
+typedef int32 CFE_Status_t;
+
+#define CFE_SUCCESS                 ((CFE_Status_t)0)
+#define CFE_STATUS_BAD_COMMAND_CODE ((CFE_Status_t)0xc8000003)
+#define CFE_STATUS_VALIDATION_FAILURE ((CFE_Status_t)0xc8000007)
+#define CFE_STATUS_RANGE_ERROR      ((CFE_Status_t)0xc8000008)
+#define CFE_STATUS_INCORRECT_STATE  ((CFE_Status_t)0xc8000009)
+#define CFE_SB_TIME_OUT             ((CFE_Status_t)0xca000001)
+#define CFE_SB_BAD_ARGUMENT         ((CFE_Status_t)0xca000002)
+#define CFE_SB_MAX_PIPES_MET        ((CFE_Status_t)0xca000003)
+#define CFE_SB_PIPE_RD_ERR          ((CFE_Status_t)0xca000005)
+#define CFE_SB_MSG_TOO_BIG          ((CFE_Status_t)0xca000006)
+#define CFE_SB_BUF_ALOC_ERR         ((CFE_Status_t)0xca000007)
+#define CFE_SB_MAX_MSGS_MET         ((CFE_Status_t)0xca000008)
+#define CFE_SB_NO_MESSAGE           ((CFE_Status_t)0xca00000e)
+#define CFE_SB_BUFFER_INVALID       ((CFE_Status_t)0xca00000d)
+#define CFE_MSG_BAD_ARGUMENT        ((CFE_Status_t)0xca000001)
+#define CFE_MSG_WRONG_MSG_TYPE      ((CFE_Status_t)0xca000005)
+#define CFE_ES_BAD_ARGUMENT         ((CFE_Status_t)0xc4000002)
+#define CFE_ES_ERR_CHILD_TASK_CREATE ((CFE_Status_t)0xc4000010)
+#define CFE_ES_CDS_ALREADY_EXISTS   ((CFE_Status_t)0x4400000c)
+#define CFE_ES_CDS_INSUFFICIENT_MEMORY ((CFE_Status_t)0xc400000b)
+#define CFE_ES_CDS_BLOCK_CRC_ERR    ((CFE_Status_t)0xc4000019)
+#define CFE_ES_ERR_RESOURCEID_NOT_VALID ((CFE_Status_t)0xc4000001)
+#define CFE_TBL_INFO_UPDATED        ((CFE_Status_t)0x4c000007)
+#define CFE_TBL_ERR_INVALID_HANDLE  ((CFE_Status_t)0xcc000001)
+#define CFE_TBL_ERR_REGISTRY_FULL   ((CFE_Status_t)0xcc000006)
+#define CFE_TBL_ERR_NEVER_LOADED    ((CFE_Status_t)0xcc00000f)
+#define CFE_TBL_ERR_ACCESS          ((CFE_Status_t)0xcc00002c)
+#define CFE_TBL_ERR_FILE_FOR_WRONG_TABLE ((CFE_Status_t)0xcc00001f)
+#define CFE_TBL_ERR_PARTIAL_LOAD    ((CFE_Status_t)0xcc000023)
+
+/*
+** Time
+*/
+typedef struct
+{
+    uint32 Seconds;
+    uint32 Subseconds;
+} CFE_TIME_SysTime_t;
+
+CFE_TIME_SysTime_t CFE_TIME_GetTime(void);
+
+/*
+** Message
+*/
+typedef struct
+{
+    uint8 StreamId[2];
+    uint8 Sequence[2];
+    uint8 Length[2];
+} CCSDS_PrimaryHeader_t;
+
+typedef union
+{
+    CCSDS_PrimaryHeader_t CCSDS;
+    uint8                 Byte[sizeof(CCSDS_PrimaryHeader_t)];
+} CFE_MSG_Message_t;
+
+typedef struct
+{
+    uint8 FunctionCode;
+    uint8 Checksum;
+} CFE_MSG_CommandSecondaryHeader_t;
+
+typedef struct
+{
+    uint8 Time[6];
+} CFE_MSG_TelemetrySecondaryHeader_t;
+
+typedef struct
+{
+    CFE_MSG_Message_t                Msg;
+    CFE_MSG_CommandSecondaryHeader_t Sec;
+} CFE_MSG_CommandHeader_t;
+
+typedef struct
+{
+    CFE_MSG_Message_t                  Msg;
+    CFE_MSG_TelemetrySecondaryHeader_t Sec;
+    uint8                              Spare[4];
+} CFE_MSG_TelemetryHeader_t;
+
+typedef size_t CFE_MSG_Size_t;
+typedef uint16 CFE_MSG_FcnCode_t;
+typedef uint16 CFE_MSG_SequenceCount_t;
+
+/*
+** Software Bus
+*/
+typedef uint32 CFE_SB_MsgId_Atom_t;
+typedef CFE_SB_MsgId_Atom_t CFE_SB_MsgId_t;
+typedef uint32 CFE_SB_PipeId_t;
+
+typedef union
+{
+    CFE_MSG_Message_t Msg;
+    long long         LongInt;
+    long double       LongDouble;
+} CFE_SB_Buffer_t;
+
+#define CFE_SB_INVALID_MSG_ID ((CFE_SB_MsgId_t)0xFFFFFFFF)
+#define CFE_SB_PEND_FOREVER   (-1)
+#define CFE_SB_POLL           0
+
+static inline CFE_SB_MsgId_t CFE_SB_ValueToMsgId(CFE_SB_MsgId_Atom_t MsgIdValue)
+{
+    return (CFE_SB_MsgId_t)MsgIdValue;
+}
+
+static inline CFE_SB_MsgId_Atom_t CFE_SB_MsgIdToValue(CFE_SB_MsgId_t MsgId)
+{
+    return (CFE_SB_MsgId_Atom_t)MsgId;
+}
+
+CFE_Status_t CFE_MSG_Init(CFE_MSG_Message_t *MsgPtr, CFE_SB_MsgId_t MsgId, CFE_MSG_Size_t Size);
+CFE_Status_t CFE_MSG_GetMsgId(const CFE_MSG_Message_t *MsgPtr, CFE_SB_MsgId_t *MsgId);
+CFE_Status_t CFE_MSG_SetMsgId(CFE_MSG_Message_t *MsgPtr, CFE_SB_MsgId_t MsgId);
+CFE_Status_t CFE_MSG_GetSize(const CFE_MSG_Message_t *MsgPtr, CFE_MSG_Size_t *Size);
+CFE_Status_t CFE_MSG_SetSize(CFE_MSG_Message_t *MsgPtr, CFE_MSG_Size_t Size);
+CFE_Status_t CFE_MSG_GetFcnCode(const CFE_MSG_Message_t *MsgPtr, CFE_MSG_FcnCode_t *FcnCode);
+CFE_Status_t CFE_MSG_SetFcnCode(CFE_MSG_Message_t *MsgPtr, CFE_MSG_FcnCode_t FcnCode);
+CFE_Status_t CFE_MSG_GetSequenceCount(const CFE_MSG_Message_t *MsgPtr, CFE_MSG_SequenceCount_t *SeqCnt);
+CFE_Status_t CFE_MSG_SetSequenceCount(CFE_MSG_Message_t *MsgPtr, CFE_MSG_SequenceCount_t SeqCnt);
+CFE_MSG_SequenceCount_t CFE_MSG_GetNextSequenceCount(CFE_MSG_SequenceCount_t SeqCnt);
+CFE_Status_t CFE_MSG_GetMsgTime(const CFE_MSG_Message_t *MsgPtr, CFE_TIME_SysTime_t *Time);
+CFE_Status_t CFE_MSG_SetMsgTime(CFE_MSG_Message_t *MsgPtr, CFE_TIME_SysTime_t NewTime);
+
+CFE_Status_t CFE_SB_CreatePipe(CFE_SB_PipeId_t *PipeIdPtr, uint16 Depth, const char *PipeName);
+CFE_Status_t CFE_SB_DeletePipe(CFE_SB_PipeId_t PipeId);
+CFE_Status_t CFE_SB_Subscribe(CFE_SB_MsgId_t MsgId, CFE_SB_PipeId_t PipeId);
+CFE_Status_t CFE_SB_ReceiveBuffer(CFE_SB_Buffer_t **BufPtr, CFE_SB_PipeId_t PipeId, int32 TimeOut);
+CFE_Status_t CFE_SB_TransmitMsg(const CFE_MSG_Message_t *MsgPtr, bool IncrementSequenceCount);
+CFE_SB_Buffer_t *CFE_SB_AllocateMessageBuffer(size_t MsgSize);
+CFE_Status_t CFE_SB_ReleaseMessageBuffer(CFE_SB_Buffer_t *BufPtr);
+CFE_Status_t CFE_SB_TransmitBuffer(CFE_SB_Buffer_t *BufPtr, bool IncrementSequenceCount);
+void         CFE_SB_TimeStampMsg(CFE_MSG_Message_t *MsgPtr);
+
+/*
+** Event Services
+*/
+typedef struct
+{
+    uint16 EventID;
+    uint16 Mask;
+} CFE_EVS_BinFilter_t;
+
+enum
+{
+    CFE_EVS_EventFilter_BINARY = 0
+};
+
+enum
+{
+    CFE_EVS_EventType_DEBUG       = 1,
+    CFE_EVS_EventType_INFORMATION = 2,
+    CFE_EVS_EventType_ERROR       = 3,
+    CFE_EVS_EventType_CRITICAL    = 4
+};
+
+CFE_Status_t CFE_EVS_Register(const void *Filters, uint16 NumEventFilters, uint16 FilterScheme);
+CFE_Status_t CFE_EVS_SendEvent(uint16 EventID, uint16 EventType, const char *Spec, ...);
+
+/*
+** Executive Services
+*/
+enum
+{
+    CFE_ES_RunStatus_UNDEFINED   = 0,
+    CFE_ES_RunStatus_APP_RUN     = 1,
+    CFE_ES_RunStatus_APP_EXIT    = 2,
+    CFE_ES_RunStatus_APP_ERROR   = 3,
+    CFE_ES_RunStatus_SYS_EXCEPTION = 4
+};
+
+typedef uint32 CFE_ES_TaskId_t;
+typedef void (*CFE_ES_ChildTaskMainFuncPtr_t)(void);
+typedef void *CFE_ES_StackPointer_t;
+typedef uint32 CFE_ES_CDSHandle_t;
+
+#define CFE_ES_TASK_STACK_ALLOCATE NULL
+
+bool         CFE_ES_RunLoop(uint32 *RunStatus);
+void         CFE_ES_ExitApp(uint32 ExitStatus);
+CFE_Status_t CFE_ES_WriteToSysLog(const char *SpecStringPtr, ...);
+void         CFE_ES_PerfLogAdd(uint32 Marker, uint32 EntryExit);
+CFE_Status_t CFE_ES_CreateChildTask(CFE_ES_TaskId_t *TaskIdPtr, const char *TaskName,
+                                    CFE_ES_ChildTaskMainFuncPtr_t FunctionPtr, CFE_ES_StackPointer_t StackPtr,
+                                    size_t StackSize, uint16 Priority, uint32 Flags);
+void         CFE_ES_ExitChildTask(void);
+CFE_Status_t CFE_ES_RegisterCDS(CFE_ES_CDSHandle_t *CDSHandlePtr, size_t BlockSize, const char *Name);
+CFE_Status_t CFE_ES_CopyToCDS(CFE_ES_CDSHandle_t Handle, const void *DataToCopy);
+CFE_Status_t CFE_ES_RestoreFromCDS(void *RestoreToMemory, CFE_ES_CDSHandle_t Handle);
+
+#define CFE_ES_PerfLogEntry(id) (CFE_ES_PerfLogAdd(id, 0))
+#define CFE_ES_PerfLogExit(id)  (CFE_ES_PerfLogAdd(id, 1))
+
+/*
+** Table Services
+*/
+typedef int16 CFE_TBL_Handle_t;
+typedef int32 (*CFE_TBL_CallbackFuncPtr_t)(void *TblPtr);
+
+typedef enum
+{
+    CFE_TBL_SRC_FILE    = 0,
+    CFE_TBL_SRC_ADDRESS = 1
+} CFE_TBL_SrcEnum_t;
+
+#define CFE_TBL_OPT_DEFAULT 0x0000
+
+CFE_Status_t CFE_TBL_Register(CFE_TBL_Handle_t *TblHandlePtr, const char *Name, size_t Size, uint16 TblOptionFlags,
+                              CFE_TBL_CallbackFuncPtr_t TblValidationFuncPtr);
+CFE_Status_t CFE_TBL_Load(CFE_TBL_Handle_t TblHandle, CFE_TBL_SrcEnum_t SrcType, const void *SrcDataPtr);
+CFE_Status_t CFE_TBL_Manage(CFE_TBL_Handle_t TblHandle);
+CFE_Status_t CFE_TBL_GetAddress(void **TblPtr, CFE_TBL_Handle_t TblHandle);
+CFE_Status_t CFE_TBL_ReleaseAddress(CFE_TBL_Handle_t TblHandle);
+
+/*
+** OSAL
+*/
+#define OS_FILE_FLAG_NONE     0x00
+#define OS_FILE_FLAG_CREATE   0x01
+#define OS_FILE_FLAG_TRUNCATE 0x02
+
+#define OS_READ_ONLY  0
+#define OS_WRITE_ONLY 1
+#define OS_READ_WRITE 2
+
+void  OS_printf(const char *string, ...);
+int32 OS_TaskDelay(uint32 millisecond);
+int32 OS_OpenCreate(osal_id_t *filedes, const char *path, int32 flags, int32 access_mode);
+int32 OS_read(osal_id_t filedes, void *buffer, size_t nbytes);
+int32 OS_write(osal_id_t filedes, const void *buffer, size_t nbytes);
+int32 OS_close(osal_id_t filedes);
+
+#endif /* _stub_cfe_h_ */
@@ -0,0 +1,12 @@
+/*
+** File: cfe_es.h (host stub)
+**
+** Purpose:
+**   The host stub keeps the whole cFE API surface in cfe.h.
+*/
+#ifndef _stub_cfe_es_h_
+#define _stub_cfe_es_h_
+
+#include "cfe.h"
+
+#endif /* _stub_cfe_es_h_ */
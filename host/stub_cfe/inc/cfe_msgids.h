@@ -0,0 +1,13 @@
+/*
+** File: cfe_msgids.h (host stub)
+**
+** Purpose:
+**   Message ID bases matching the default cFE platform configuration.
+*/
+#ifndef _stub_cfe_msgids_h_
+#define _stub_cfe_msgids_h_
+
+#define CFE_PLATFORM_CMD_MID_BASE 0x1800
+#define CFE_PLATFORM_TLM_MID_BASE 0x0800
+
+#endif /* _stub_cfe_msgids_h_ */
@@ -0,0 +1,75 @@
+/*******************************************************************************
+**
+** File: stub_cfe.h
+**
+** Purpose:
+**   Control and observation interface of the host cFE stub.  Harness
+**   programs use it to inject time, observe transmitted messages and read
+**   back how much work the stubbed services did.
+**
+*******************************************************************************/
+#ifndef _stub_cfe_ctl_h_
+#define _stub_cfe_ctl_h_
+
+#include "cfe.h"
+
+/*
+** Called for every CFE_SB_TransmitMsg() and CFE_SB_TransmitBuffer() after
+** the message is routed
+*/
+typedef void (*StubCfe_TransmitHook_t)(const CFE_MSG_Message_t *MsgPtr, CFE_MSG_Size_t Size, void *Arg);
+
+/*
+** Replaces the wall clock behind CFE_TIME_GetTime()
+*/
+typedef CFE_TIME_SysTime_t (*StubCfe_TimeSource_t)(void *Arg);
+
+typedef struct
+{
+    uint64 TransmitCount;
+    uint64 TransmitBytes;
+    uint64 CopyBytes;         /* Copied into SB buffers by CFE_SB_TransmitMsg() */
+    uint64 AllocateCount;     /* CFE_SB_AllocateMessageBuffer() */
+    uint64 AllocateFailCount;
+    uint64 RouteCount;
+    uint64 PipeOverflowCount;
+    uint64 EventCount;
+    uint64 SysLogCount;
+    uint64 PerfLogCount;
+    uint64 ChildTaskCount;
+    uint64 TableLoadCount;   /* Images that passed validation */
+    uint64 TableRejectCount; /* Images the validation function refused */
+    uint64 CdsWriteCount;    /* CFE_ES_CopyToCDS() */
+} StubCfe_Counters_t;
+
+void StubCfe_Reset(void);
+void StubCfe_SetVerbose(bool Verbose);
+void StubCfe_SetTransmitHook(StubCfe_TransmitHook_t Hook, void *Arg);
+void StubCfe_SetTimeSource(StubCfe_TimeSource_t Source, void *Arg);
+void StubCfe_SetAllocateFail(bool Fail); /* CFE_SB_AllocateMessageBuffer() returns NULL while set */
+
+/*
+** Stages a new image for a registered table, as a ground load and activate
+** does; the owner's next CFE_TBL_Manage() validates and applies it
+*/
+CFE_Status_t StubCfe_TableStage(const char *Name, const void *Data, size_t Size);
+
+/*
+** The CDS outlives StubCfe_Reset(), as it does an app restart or a
+** processor reset; this empties it, as a power-on reset does
+*/
+void StubCfe_CdsClear(void);
+
+const StubCfe_Counters_t *StubCfe_GetCounters(void);
+uint32                    StubCfe_GetPipeCount(CFE_SB_PipeId_t PipeId);
+uint32                    StubCfe_GetPipeHighWater(CFE_SB_PipeId_t PipeId);
+uint32                    StubCfe_GetBuffersInUse(void);
+
+/*
+** Helpers for the harnesses
+*/
+uint64             StubCfe_NowNs(void);
+CFE_TIME_SysTime_t StubCfe_NsToSysTime(uint64 Ns);
+uint64             StubCfe_SysTimeToNs(CFE_TIME_SysTime_t Time);
+
+#endif /* _stub_cfe_ctl_h_ */
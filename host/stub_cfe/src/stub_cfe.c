@@ -0,0 +1,1252 @@
+/*******************************************************************************
+**
+** File: stub_cfe.c
+**
+** Purpose:
+**   Host, single-process implementation of the cFE services used by
+**   rover_app.  Pipes are bounded FIFOs that own copies of the routed
+**   messages.  Like SB, a transmitted message is first copied into a
+**   buffer from a fixed pool, which zero-copy senders allocate and fill
+**   themselves, so the copy cost of a transmit is still paid.  Events are
+**   formatted but only printed in verbose mode.  Tables hold an active
+**   and a staged image.  File loads read the cFE file header and table
+**   header ahead of the image, and refuse a file whose table name is not
+**   "<app>.<table>" or that does not hold the whole image.
+**
+*******************************************************************************/
+
+#include "cfe.h"
+#include "stub_cfe.h"
+
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define STUB_CFE_MAX_PIPES        8
+#define STUB_CFE_MAX_SUBSCRIPTIONS 128
+#define STUB_CFE_PIPE_SLOT_SIZE   4096
+#define STUB_CFE_SB_BUFFERS       64 /* SB buffer pool, each STUB_CFE_PIPE_SLOT_SIZE */
+#define STUB_CFE_MAX_TABLES       4
+#define STUB_CFE_MAX_CDS          4
+#define STUB_CFE_APP_NAME         "ROVER_APP" /* Owner of every table, as in the startup script */
+#define STUB_CFE_FS_HDR_SIZE      64          /* CFE_FS_Header_t ahead of a table file's own header */
+
+#define STUB_CFE_CMD_TYPE_BIT 0x1000
+#define STUB_CFE_SEQCNT_MASK  0x3FFF
+
+typedef struct
+{
+    bool   InUse;
+    char   Name[CFE_MISSION_MAX_API_LEN];
+    uint16 Depth;
+    uint32 Head;
+    uint32 Count;
+    uint32 HighWater;
+    uint8 *Slots; /* Depth + 1 slots; the last one received stays valid */
+} StubCfe_Pipe_t;
+
+typedef struct
+{
+    CFE_SB_MsgId_t  MsgId;
+    CFE_SB_PipeId_t PipeId;
+} StubCfe_Subscription_t;
+
+typedef struct
+{
+    CFE_SB_MsgId_t          MsgId;
+    CFE_MSG_SequenceCount_t SeqCnt;
+} StubCfe_Route_t;
+
+typedef struct
+{
+    bool                      InUse;
+    char                      Name[CFE_MISSION_MAX_API_LEN];
+    size_t                    Size;
+    CFE_TBL_CallbackFuncPtr_t Validate;
+    uint8                    *Active;
+    uint8                    *Staged;
+    bool                      Loaded;
+    bool                      StagePending;
+    bool                      Updated; /* Not yet reported by CFE_TBL_GetAddress() */
+} StubCfe_Table_t;
+
+typedef struct
+{
+    bool   InUse;
+    char   Name[CFE_MISSION_MAX_API_LEN];
+    size_t Size;
+    uint16 Crc; /* Of Data, as of the last CFE_ES_CopyToCDS() */
+    uint8 *Data;
+} StubCfe_CdsBlock_t;
+
+typedef union
+{
+    CFE_SB_Buffer_t Buf;
+    uint8           Bytes[STUB_CFE_PIPE_SLOT_SIZE];
+} StubCfe_SbBuffer_t;
+
+static StubCfe_SbBuffer_t StubCfe_Buffers[STUB_CFE_SB_BUFFERS];
+
+/* Not part of StubCfe, StubCfe_Reset() leaves it alone */
+static StubCfe_CdsBlock_t StubCfe_Cds[STUB_CFE_MAX_CDS];
+
+static struct
+{
+    StubCfe_Pipe_t         Pipes[STUB_CFE_MAX_PIPES];
+    StubCfe_Subscription_t Subs[STUB_CFE_MAX_SUBSCRIPTIONS];
+    uint32                 SubCount;
+    StubCfe_Route_t        Routes[STUB_CFE_MAX_SUBSCRIPTIONS]; /* Per-MsgId sequence counters */
+    uint32                 RouteCount;
+
+    bool   BuffersReady; /* FreeBuffers holds the free ones */
+    bool   AllocateFail;
+    bool   BufferInUse[STUB_CFE_SB_BUFFERS];
+    uint32 FreeBuffers[STUB_CFE_SB_BUFFERS];
+    uint32 FreeCount;
+
+    StubCfe_Table_t Tables[STUB_CFE_MAX_TABLES];
+
+    StubCfe_TransmitHook_t TransmitHook;
+    void                  *TransmitHookArg;
+    StubCfe_TimeSource_t   TimeSource;
+    void                  *TimeSourceArg;
+
+    bool               Verbose;
+    StubCfe_Counters_t Counters;
+    char               EventText[128];
+} StubCfe;
+
+/*
+** Harness control
+*/
+void StubCfe_Reset(void)
+{
+    uint32 i;
+
+    for (i = 0; i < STUB_CFE_MAX_PIPES; i++)
+    {
+        free(StubCfe.Pipes[i].Slots);
+    }
+    for (i = 0; i < STUB_CFE_MAX_TABLES; i++)
+    {
+        free(StubCfe.Tables[i].Active);
+        free(StubCfe.Tables[i].Staged);
+    }
+
+    memset(&StubCfe, 0, sizeof(StubCfe));
+}
+
+void StubCfe_CdsClear(void)
+{
+    uint32 i;
+
+    for (i = 0; i < STUB_CFE_MAX_CDS; i++)
+    {
+        free(StubCfe_Cds[i].Data);
+    }
+
+    memset(StubCfe_Cds, 0, sizeof(StubCfe_Cds));
+}
+
+void StubCfe_SetVerbose(bool Verbose)
+{
+    StubCfe.Verbose = Verbose;
+}
+
+void StubCfe_SetTransmitHook(StubCfe_TransmitHook_t Hook, void *Arg)
+{
+    StubCfe.TransmitHook    = Hook;
+    StubCfe.TransmitHookArg = Arg;
+}
+
+void StubCfe_SetAllocateFail(bool Fail)
+{
+    StubCfe.AllocateFail = Fail;
+}
+
+uint32 StubCfe_GetBuffersInUse(void)
+{
+    return StubCfe.BuffersReady ? (STUB_CFE_SB_BUFFERS - StubCfe.FreeCount) : 0;
+}
+
+void StubCfe_SetTimeSource(StubCfe_TimeSource_t Source, void *Arg)
+{
+    StubCfe.TimeSource    = Source;
+    StubCfe.TimeSourceArg = Arg;
+}
+
+const StubCfe_Counters_t *StubCfe_GetCounters(void)
+{
+    return &StubCfe.Counters;
+}
+
+uint32 StubCfe_GetPipeCount(CFE_SB_PipeId_t PipeId)
+{
+    if (PipeId >= STUB_CFE_MAX_PIPES || !StubCfe.Pipes[PipeId].InUse)
+    {
+        return 0;
+    }
+
+    return StubCfe.Pipes[PipeId].Count;
+}
+
+uint32 StubCfe_GetPipeHighWater(CFE_SB_PipeId_t PipeId)
+{
+    if (PipeId >= STUB_CFE_MAX_PIPES || !StubCfe.Pipes[PipeId].InUse)
+    {
+        return 0;
+    }
+
+    return StubCfe.Pipes[PipeId].HighWater;
+}
+
+uint64 StubCfe_NowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64)ts.tv_sec * 1000000000ULL) + (uint64)ts.tv_nsec;
+}
+
+CFE_TIME_SysTime_t StubCfe_NsToSysTime(uint64 Ns)
+{
+    CFE_TIME_SysTime_t Time;
+
+    Time.Seconds    = (uint32)(Ns / 1000000000ULL);
+    Time.Subseconds = (uint32)(((Ns % 1000000000ULL) << 32) / 1000000000ULL);
+
+    return Time;
+}
+
+uint64 StubCfe_SysTimeToNs(CFE_TIME_SysTime_t Time)
+{
+    return ((uint64)Time.Seconds * 1000000000ULL) + (((uint64)Time.Subseconds * 1000000000ULL) >> 32);
+}
+
+/*
+** Time Services
+*/
+CFE_TIME_SysTime_t CFE_TIME_GetTime(void)
+{
+    if (StubCfe.TimeSource != NULL)
+    {
+        return StubCfe.TimeSource(StubCfe.TimeSourceArg);
+    }
+
+    return StubCfe_NsToSysTime(StubCfe_NowNs());
+}
+
+/*
+** Message Services (CCSDS v1 primary header, MsgId == StreamId)
+*/
+static inline uint16 StubCfe_Get16(const uint8 *Bytes)
+{
+    return (uint16)((Bytes[0] << 8) | Bytes[1]);
+}
+
+static inline void StubCfe_Put16(uint8 *Bytes, uint16 Value)
+{
+    Bytes[0] = (uint8)(Value >> 8);
+    Bytes[1] = (uint8)Value;
+}
+
+CFE_Status_t CFE_MSG_Init(CFE_MSG_Message_t *MsgPtr, CFE_SB_MsgId_t MsgId, CFE_MSG_Size_t Size)
+{
+    if (MsgPtr == NULL || Size < sizeof(CFE_MSG_Message_t))
+    {
+        return CFE_MSG_BAD_ARGUMENT;
+    }
+
+    memset(MsgPtr, 0, Size);
+    CFE_MSG_SetMsgId(MsgPtr, MsgId);
+    CFE_MSG_SetSize(MsgPtr, Size);
+
+    return CFE_SUCCESS;
+}
+
+CFE_Status_t CFE_MSG_GetMsgId(const CFE_MSG_Message_t *MsgPtr, CFE_SB_MsgId_t *MsgId)
+{
+    *MsgId = CFE_SB_ValueToMsgId(StubCfe_Get16(MsgPtr->CCSDS.StreamId));
+
+    return CFE_SUCCESS;
+}
+
+CFE_Status_t CFE_MSG_SetMsgId(CFE_MSG_Message_t *MsgPtr, CFE_SB_MsgId_t MsgId)
+{
+    StubCfe_Put16(MsgPtr->CCSDS.StreamId, (uint16)CFE_SB_MsgIdToValue(MsgId));
+
+    return CFE_SUCCESS;
+}
+
+CFE_Status_t CFE_MSG_GetSize(const CFE_MSG_Message_t *MsgPtr, CFE_MSG_Size_t *Size)
+{
+    *Size = (CFE_MSG_Size_t)StubCfe_Get16(MsgPtr->CCSDS.Length) + 7;
+
+    return CFE_SUCCESS;
+}
+
+CFE_Status_t CFE_MSG_SetSize(CFE_MSG_Message_t *MsgPtr, CFE_MSG_Size_t Size)
+{
+    if (Size < 7 || Size > 0xFFFF + 7)
+    {
+        return CFE_MSG_BAD_ARGUMENT;
+    }
+
+    StubCfe_Put16(MsgPtr->CCSDS.Length, (uint16)(Size - 7));
+
+    return CFE_SUCCESS;
+}
+
+static inline bool StubCfe_IsCommand(const CFE_MSG_Message_t *MsgPtr)
+{
+    return (StubCfe_Get16(MsgPtr->CCSDS.StreamId) & STUB_CFE_CMD_TYPE_BIT) != 0;
+}
+
+CFE_Status_t CFE_MSG_GetFcnCode(const CFE_MSG_Message_t *MsgPtr, CFE_MSG_FcnCode_t *FcnCode)
+{
+    if (!StubCfe_IsCommand(MsgPtr))
+    {
+        *FcnCode = 0;
+        return CFE_MSG_WRONG_MSG_TYPE;
+    }
+
+    *FcnCode = ((const CFE_MSG_CommandHeader_t *)MsgPtr)->Sec.FunctionCode & 0x7F;
+
+    return CFE_SUCCESS;
+}
+
+CFE_Status_t CFE_MSG_SetFcnCode(CFE_MSG_Message_t *MsgPtr, CFE_MSG_FcnCode_t FcnCode)
+{
+    if (!StubCfe_IsCommand(MsgPtr))
+    {
+        return CFE_MSG_WRONG_MSG_TYPE;
+    }
+
+    ((CFE_MSG_CommandHeader_t *)MsgPtr)->Sec.FunctionCode = (uint8)(FcnCode & 0x7F);
+
+    return CFE_SUCCESS;
+}
+
+CFE_Status_t CFE_MSG_GetSequenceCount(const CFE_MSG_Message_t *MsgPtr, CFE_MSG_SequenceCount_t *SeqCnt)
+{
+    *SeqCnt = StubCfe_Get16(MsgPtr->CCSDS.Sequence) & STUB_CFE_SEQCNT_MASK;
+
+    return CFE_SUCCESS;
+}
+
+CFE_Status_t CFE_MSG_SetSequenceCount(CFE_MSG_Message_t *MsgPtr, CFE_MSG_SequenceCount_t SeqCnt)
+{
+    uint16 Sequence = StubCfe_Get16(MsgPtr->CCSDS.Sequence);
+
+    if (SeqCnt > STUB_CFE_SEQCNT_MASK)
+    {
+        return CFE_MSG_BAD_ARGUMENT;
+    }
+
+    StubCfe_Put16(MsgPtr->CCSDS.Sequence, (uint16)((Sequence & ~STUB_CFE_SEQCNT_MASK) | SeqCnt));
+
+    return CFE_SUCCESS;
+}
+
+CFE_MSG_SequenceCount_t CFE_MSG_GetNextSequenceCount(CFE_MSG_SequenceCount_t SeqCnt)
+{
+    return (CFE_MSG_SequenceCount_t)((SeqCnt + 1) & STUB_CFE_SEQCNT_MASK);
+}
+
+CFE_Status_t CFE_MSG_GetMsgTime(const CFE_MSG_Message_t *MsgPtr, CFE_TIME_SysTime_t *Time)
+{
+    const uint8 *Bytes;
+
+    if (StubCfe_IsCommand(MsgPtr))
+    {
+        Time->Seconds    = 0;
+        Time->Subseconds = 0;
+        return CFE_MSG_WRONG_MSG_TYPE;
+    }
+
+    Bytes            = ((const CFE_MSG_TelemetryHeader_t *)MsgPtr)->Sec.Time;
+    Time->Seconds    = ((uint32)StubCfe_Get16(&Bytes[0]) << 16) | StubCfe_Get16(&Bytes[2]);
+    Time->Subseconds = (uint32)StubCfe_Get16(&Bytes[4]) << 16;
+
+    return CFE_SUCCESS;
+}
+
+CFE_Status_t CFE_MSG_SetMsgTime(CFE_MSG_Message_t *MsgPtr, CFE_TIME_SysTime_t NewTime)
+{
+    uint8 *Bytes;
+
+    if (StubCfe_IsCommand(MsgPtr))
+    {
+        return CFE_MSG_WRONG_MSG_TYPE;
+    }
+
+    Bytes = ((CFE_MSG_TelemetryHeader_t *)MsgPtr)->Sec.Time;
+    StubCfe_Put16(&Bytes[0], (uint16)(NewTime.Seconds >> 16));
+    StubCfe_Put16(&Bytes[2], (uint16)NewTime.Seconds);
+    StubCfe_Put16(&Bytes[4], (uint16)(NewTime.Subseconds >> 16));
+
+    return CFE_SUCCESS;
+}
+
+/*
+** Software Bus
+*/
+CFE_Status_t CFE_SB_CreatePipe(CFE_SB_PipeId_t *PipeIdPtr, uint16 Depth, const char *PipeName)
+{
+    uint32 i;
+
+    if (PipeIdPtr == NULL || Depth == 0)
+    {
+        return CFE_SB_BAD_ARGUMENT;
+    }
+
+    for (i = 0; i < STUB_CFE_MAX_PIPES; i++)
+    {
+        if (!StubCfe.Pipes[i].InUse)
+        {
+            StubCfe.Pipes[i].Slots = calloc((size_t)Depth + 1, STUB_CFE_PIPE_SLOT_SIZE);
+            if (StubCfe.Pipes[i].Slots == NULL)
+            {
+                return CFE_SB_BUF_ALOC_ERR;
+            }
+
+            StubCfe.Pipes[i].InUse = true;
+            StubCfe.Pipes[i].Depth = Depth;
+            StubCfe.Pipes[i].Head  = 0;
+            StubCfe.Pipes[i].Count = 0;
+            strncpy(StubCfe.Pipes[i].Name, PipeName, sizeof(StubCfe.Pipes[i].Name) - 1);
+
+            *PipeIdPtr = i;
+            return CFE_SUCCESS;
+        }
+    }
+
+    return CFE_SB_MAX_PIPES_MET;
+}
+
+CFE_Status_t CFE_SB_DeletePipe(CFE_SB_PipeId_t PipeId)
+{
+    uint32 i;
+    uint32 Kept = 0;
+
+    if (PipeId >= STUB_CFE_MAX_PIPES || !StubCfe.Pipes[PipeId].InUse)
+    {
+        return CFE_SB_BAD_ARGUMENT;
+    }
+
+    for (i = 0; i < StubCfe.SubCount; i++)
+    {
+        if (StubCfe.Subs[i].PipeId != PipeId)
+        {
+            StubCfe.Subs[Kept++] = StubCfe.Subs[i];
+        }
+    }
+    StubCfe.SubCount = Kept;
+
+    free(StubCfe.Pipes[PipeId].Slots);
+    memset(&StubCfe.Pipes[PipeId], 0, sizeof(StubCfe.Pipes[PipeId]));
+
+    return CFE_SUCCESS;
+}
+
+CFE_Status_t CFE_SB_Subscribe(CFE_SB_MsgId_t MsgId, CFE_SB_PipeId_t PipeId)
+{
+    if (PipeId >= STUB_CFE_MAX_PIPES || !StubCfe.Pipes[PipeId].InUse)
+    {
+        return CFE_SB_BAD_ARGUMENT;
+    }
+
+    if (StubCfe.SubCount >= STUB_CFE_MAX_SUBSCRIPTIONS)
+    {
+        return CFE_SB_MAX_MSGS_MET;
+    }
+
+    StubCfe.Subs[StubCfe.SubCount].MsgId  = MsgId;
+    StubCfe.Subs[StubCfe.SubCount].PipeId = PipeId;
+    StubCfe.SubCount++;
+
+    return CFE_SUCCESS;
+}
+
+CFE_Status_t CFE_SB_ReceiveBuffer(CFE_SB_Buffer_t **BufPtr, CFE_SB_PipeId_t PipeId, int32 TimeOut)
+{
+    StubCfe_Pipe_t *Pipe;
+
+    if (BufPtr == NULL || PipeId >= STUB_CFE_MAX_PIPES || !StubCfe.Pipes[PipeId].InUse)
+    {
+        return CFE_SB_BAD_ARGUMENT;
+    }
+
+    Pipe = &StubCfe.Pipes[PipeId];
+
+    if (Pipe->Count == 0)
+    {
+        /* Nothing else runs in the host process that could ever fill the pipe */
+        *BufPtr = NULL;
+        if (TimeOut == CFE_SB_POLL)
+        {
+            return CFE_SB_NO_MESSAGE;
+        }
+        return (TimeOut == CFE_SB_PEND_FOREVER) ? CFE_SB_PIPE_RD_ERR : CFE_SB_TIME_OUT;
+    }
+
+    *BufPtr    = (CFE_SB_Buffer_t *)&Pipe->Slots[(size_t)Pipe->Head * STUB_CFE_PIPE_SLOT_SIZE];
+    Pipe->Head = (Pipe->Head + 1) % ((uint32)Pipe->Depth + 1);
+    Pipe->Count--;
+
+    return CFE_SUCCESS;
+}
+
+/*
+** Sequence counter of the route for MsgId, created on first use
+*/
+static CFE_MSG_SequenceCount_t *StubCfe_RouteSeqCnt(CFE_SB_MsgId_t MsgId)
+{
+    uint32 i;
+
+    for (i = 0; i < StubCfe.RouteCount; i++)
+    {
+        if (StubCfe.Routes[i].MsgId == MsgId)
+        {
+            return &StubCfe.Routes[i].SeqCnt;
+        }
+    }
+
+    if (StubCfe.RouteCount >= STUB_CFE_MAX_SUBSCRIPTIONS)
+    {
+        return NULL;
+    }
+
+    StubCfe.Routes[StubCfe.RouteCount].MsgId  = MsgId;
+    StubCfe.Routes[StubCfe.RouteCount].SeqCnt = 0;
+
+    return &StubCfe.Routes[StubCfe.RouteCount++].SeqCnt;
+}
+
+/*
+** Hands a message in an SB buffer to the subscribed pipes; Owned is the
+** buffer itself, which gets the sequence count like the routed copies
+*/
+static void StubCfe_Route(CFE_MSG_Message_t *Owned, CFE_MSG_Size_t Size, bool IncrementSequenceCount)
+{
+    CFE_SB_MsgId_t           MsgId;
+    CFE_MSG_SequenceCount_t *SeqCnt = NULL;
+    StubCfe_Pipe_t          *Pipe;
+    uint32                   Tail;
+    uint32                   i;
+
+    CFE_MSG_GetMsgId(Owned, &MsgId);
+
+    StubCfe.Counters.TransmitCount++;
+    StubCfe.Counters.TransmitBytes += Size;
+
+    if (IncrementSequenceCount)
+    {
+        SeqCnt = StubCfe_RouteSeqCnt(MsgId);
+        if (SeqCnt != NULL)
+        {
+            *SeqCnt = CFE_MSG_GetNextSequenceCount(*SeqCnt);
+            CFE_MSG_SetSequenceCount(Owned, *SeqCnt);
+        }
+    }
+
+    for (i = 0; i < StubCfe.SubCount; i++)
+    {
+        if (StubCfe.Subs[i].MsgId != MsgId)
+        {
+            continue;
+        }
+
+        Pipe = &StubCfe.Pipes[StubCfe.Subs[i].PipeId];
+        if (Pipe->Count >= Pipe->Depth)
+        {
+            StubCfe.Counters.PipeOverflowCount++;
+            continue;
+        }
+
+        Tail = (Pipe->Head + Pipe->Count) % ((uint32)Pipe->Depth + 1);
+        memcpy(&Pipe->Slots[(size_t)Tail * STUB_CFE_PIPE_SLOT_SIZE], Owned, Size);
+        Pipe->Count++;
+        if (Pipe->Count > Pipe->HighWater)
+        {
+            Pipe->HighWater = Pipe->Count;
+        }
+        StubCfe.Counters.RouteCount++;
+    }
+
+    if (StubCfe.TransmitHook != NULL)
+    {
+        StubCfe.TransmitHook(Owned, Size, StubCfe.TransmitHookArg);
+    }
+}
+
+/*
+** SB buffer pool, a stack of free buffers
+*/
+static CFE_SB_Buffer_t *StubCfe_BufferGet(void)
+{
+    uint32 i;
+
+    if (!StubCfe.BuffersReady)
+    {
+        for (i = 0; i < STUB_CFE_SB_BUFFERS; i++)
+        {
+            StubCfe.FreeBuffers[i] = i;
+        }
+        StubCfe.FreeCount    = STUB_CFE_SB_BUFFERS;
+        StubCfe.BuffersReady = true;
+    }
+
+    if (StubCfe.FreeCount == 0)
+    {
+        return NULL;
+    }
+
+    i                      = StubCfe.FreeBuffers[--StubCfe.FreeCount];
+    StubCfe.BufferInUse[i] = true;
+
+    return &StubCfe_Buffers[i].Buf;
+}
+
+/*
+** Index of a pool buffer the caller holds, or STUB_CFE_SB_BUFFERS
+*/
+static uint32 StubCfe_BufferIndex(const CFE_SB_Buffer_t *BufPtr)
+{
+    uint32 Index;
+
+    if ((const void *)BufPtr < (const void *)&StubCfe_Buffers[0] ||
+        (const void *)BufPtr >= (const void *)&StubCfe_Buffers[STUB_CFE_SB_BUFFERS])
+    {
+        return STUB_CFE_SB_BUFFERS;
+    }
+
+    Index = (uint32)((const StubCfe_SbBuffer_t *)(const void *)BufPtr - StubCfe_Buffers);
+    if ((const void *)BufPtr != (const void *)&StubCfe_Buffers[Index] || !StubCfe.BufferInUse[Index])
+    {
+        return STUB_CFE_SB_BUFFERS;
+    }
+
+    return Index;
+}
+
+static CFE_Status_t StubCfe_BufferPut(CFE_SB_Buffer_t *BufPtr)
+{
+    uint32 Index = StubCfe_BufferIndex(BufPtr);
+
+    if (Index >= STUB_CFE_SB_BUFFERS)
+    {
+        return CFE_SB_BUFFER_INVALID;
+    }
+
+    StubCfe.BufferInUse[Index]               = false;
+    StubCfe.FreeBuffers[StubCfe.FreeCount++] = Index;
+
+    return CFE_SUCCESS;
+}
+
+CFE_Status_t CFE_SB_TransmitMsg(const CFE_MSG_Message_t *MsgPtr, bool IncrementSequenceCount)
+{
+    CFE_MSG_Size_t   Size;
+    CFE_SB_Buffer_t *BufPtr;
+
+    if (MsgPtr == NULL)
+    {
+        return CFE_SB_BAD_ARGUMENT;
+    }
+
+    CFE_MSG_GetSize(MsgPtr, &Size);
+
+    if (Size > STUB_CFE_PIPE_SLOT_SIZE)
+    {
+        return CFE_SB_MSG_TOO_BIG;
+    }
+
+    /* Like SB, copy the message into a buffer of its own and route that */
+    BufPtr = StubCfe_BufferGet();
+    if (BufPtr == NULL)
+    {
+        return CFE_SB_BUF_ALOC_ERR;
+    }
+    memcpy(BufPtr, MsgPtr, Size);
+    StubCfe.Counters.CopyBytes += Size;
+
+    StubCfe_Route(&BufPtr->Msg, Size, IncrementSequenceCount);
+    StubCfe_BufferPut(BufPtr);
+
+    return CFE_SUCCESS;
+}
+
+CFE_SB_Buffer_t *CFE_SB_AllocateMessageBuffer(size_t MsgSize)
+{
+    CFE_SB_Buffer_t *BufPtr = NULL;
+
+    if (MsgSize <= STUB_CFE_PIPE_SLOT_SIZE && !StubCfe.AllocateFail)
+    {
+        BufPtr = StubCfe_BufferGet();
+    }
+
+    if (BufPtr == NULL)
+    {
+        StubCfe.Counters.AllocateFailCount++;
+        return NULL;
+    }
+
+    StubCfe.Counters.AllocateCount++;
+
+    return BufPtr;
+}
+
+CFE_Status_t CFE_SB_ReleaseMessageBuffer(CFE_SB_Buffer_t *BufPtr)
+{
+    return StubCfe_BufferPut(BufPtr);
+}
+
+CFE_Status_t CFE_SB_TransmitBuffer(CFE_SB_Buffer_t *BufPtr, bool IncrementSequenceCount)
+{
+    CFE_MSG_Size_t Size;
+
+    if (BufPtr == NULL)
+    {
+        return CFE_SB_BAD_ARGUMENT;
+    }
+    if (StubCfe_BufferIndex(BufPtr) >= STUB_CFE_SB_BUFFERS)
+    {
+        return CFE_SB_BUFFER_INVALID;
+    }
+
+    /* On success the buffer is SB's again, on error the caller keeps it */
+    CFE_MSG_GetSize(&BufPtr->Msg, &Size);
+    if (Size > STUB_CFE_PIPE_SLOT_SIZE)
+    {
+        return CFE_SB_MSG_TOO_BIG;
+    }
+
+    StubCfe_Route(&BufPtr->Msg, Size, IncrementSequenceCount);
+    StubCfe_BufferPut(BufPtr);
+
+    return CFE_SUCCESS;
+}
+
+void CFE_SB_TimeStampMsg(CFE_MSG_Message_t *MsgPtr)
+{
+    CFE_MSG_SetMsgTime(MsgPtr, CFE_TIME_GetTime());
+}
+
+/*
+** Event Services
+*/
+CFE_Status_t CFE_EVS_Register(const void *Filters, uint16 NumEventFilters, uint16 FilterScheme)
+{
+    (void)Filters;
+    (void)NumEventFilters;
+
+    return (FilterScheme == CFE_EVS_EventFilter_BINARY) ? CFE_SUCCESS : CFE_SB_BAD_ARGUMENT;
+}
+
+CFE_Status_t CFE_EVS_SendEvent(uint16 EventID, uint16 EventType, const char *Spec, ...)
+{
+    va_list ArgPtr;
+
+    /* Formatting is the dominant cost of a real event, so keep paying it */
+    va_start(ArgPtr, Spec);
+    vsnprintf(StubCfe.EventText, sizeof(StubCfe.EventText), Spec, ArgPtr);
+    va_end(ArgPtr);
+
+    StubCfe.Counters.EventCount++;
+
+    if (StubCfe.Verbose)
+    {
+        fprintf(stderr, "EVS %u/%u: %s\n", (unsigned int)EventID, (unsigned int)EventType, StubCfe.EventText);
+    }
+
+    return CFE_SUCCESS;
+}
+
+/*
+** Table Services
+*/
+static StubCfe_Table_t *StubCfe_Table(CFE_TBL_Handle_t TblHandle)
+{
+    if (TblHandle < 0 || TblHandle >= STUB_CFE_MAX_TABLES || !StubCfe.Tables[TblHandle].InUse)
+    {
+        return NULL;
+    }
+
+    return &StubCfe.Tables[TblHandle];
+}
+
+/*
+** Runs the validation function on the staged image and makes it the
+** active one
+*/
+static CFE_Status_t StubCfe_TableApply(StubCfe_Table_t *Table)
+{
+    CFE_Status_t Status = CFE_SUCCESS;
+
+    if (Table->Validate != NULL)
+    {
+        Status = Table->Validate(Table->Staged);
+    }
+    if (Status != CFE_SUCCESS)
+    {
+        StubCfe.Counters.TableRejectCount++;
+        return Status;
+    }
+
+    memcpy(Table->Active, Table->Staged, Table->Size);
+    Table->Loaded  = true;
+    Table->Updated = true;
+    StubCfe.Counters.TableLoadCount++;
+
+    return CFE_SUCCESS;
+}
+
+CFE_Status_t StubCfe_TableStage(const char *Name, const void *Data, size_t Size)
+{
+    StubCfe_Table_t *Table;
+    uint32           i;
+
+    for (i = 0; i < STUB_CFE_MAX_TABLES; i++)
+    {
+        Table = &StubCfe.Tables[i];
+        if (Table->InUse && strcmp(Table->Name, Name) == 0 && Table->Size == Size)
+        {
+            memcpy(Table->Staged, Data, Size);
+            Table->StagePending = true;
+            return CFE_SUCCESS;
+        }
+    }
+
+    return CFE_TBL_ERR_INVALID_HANDLE;
+}
+
+CFE_Status_t CFE_TBL_Register(CFE_TBL_Handle_t *TblHandlePtr, const char *Name, size_t Size, uint16 TblOptionFlags,
+                              CFE_TBL_CallbackFuncPtr_t TblValidationFuncPtr)
+{
+    StubCfe_Table_t *Table;
+    uint32           i;
+
+    (void)TblOptionFlags;
+
+    if (TblHandlePtr == NULL || Name == NULL || Size == 0)
+    {
+        return CFE_ES_BAD_ARGUMENT;
+    }
+
+    for (i = 0; i < STUB_CFE_MAX_TABLES; i++)
+    {
+        Table = &StubCfe.Tables[i];
+        if (!Table->InUse)
+        {
+            Table->Active = calloc(1, Size);
+            Table->Staged = calloc(1, Size);
+            if (Table->Active == NULL || Table->Staged == NULL)
+            {
+                free(Table->Active);
+                free(Table->Staged);
+                Table->Active = NULL;
+                Table->Staged = NULL;
+                return CFE_TBL_ERR_REGISTRY_FULL;
+            }
+
+            Table->InUse = true;
+            strncpy(Table->Name, Name, sizeof(Table->Name) - 1);
+            Table->Size     = Size;
+            Table->Validate = TblValidationFuncPtr;
+            *TblHandlePtr   = (CFE_TBL_Handle_t)i;
+
+            return CFE_SUCCESS;
+        }
+    }
+
+    return CFE_TBL_ERR_REGISTRY_FULL;
+}
+
+/*
+** Reads a table file as cFE writes it: the cFE file header, then the
+** table header (big endian offset and size, and the <app>.<table> name
+** the file is for), then the image
+*/
+static CFE_Status_t StubCfe_TableReadFile(StubCfe_Table_t *Table, const char *Filename)
+{
+    uint8   Hdr[STUB_CFE_FS_HDR_SIZE + 12 + CFE_MISSION_TBL_MAX_FULL_NAME_LEN];
+    char    FullName[CFE_MISSION_TBL_MAX_FULL_NAME_LEN];
+    uint8  *TblHdr = &Hdr[STUB_CFE_FS_HDR_SIZE];
+    uint32  Offset;
+    uint32  NumBytes;
+    ssize_t Got;
+    int     fd;
+
+    fd = open(Filename, O_RDONLY);
+    if (fd < 0)
+    {
+        return CFE_TBL_ERR_ACCESS;
+    }
+
+    Got = read(fd, Hdr, sizeof(Hdr));
+    if (Got != (ssize_t)sizeof(Hdr))
+    {
+        close(fd);
+        return CFE_TBL_ERR_ACCESS;
+    }
+
+    snprintf(FullName, sizeof(FullName), "%s.%s", STUB_CFE_APP_NAME, Table->Name);
+    if (strncmp((const char *)&TblHdr[12], FullName, CFE_MISSION_TBL_MAX_FULL_NAME_LEN) != 0)
+    {
+        close(fd);
+        return CFE_TBL_ERR_FILE_FOR_WRONG_TABLE;
+    }
+
+    Offset   = ((uint32)StubCfe_Get16(&TblHdr[4]) << 16) | StubCfe_Get16(&TblHdr[6]);
+    NumBytes = ((uint32)StubCfe_Get16(&TblHdr[8]) << 16) | StubCfe_Get16(&TblHdr[10]);
+    if (Offset != 0 || NumBytes != Table->Size)
+    {
+        close(fd);
+        return CFE_TBL_ERR_PARTIAL_LOAD;
+    }
+
+    Got = read(fd, Table->Staged, Table->Size);
+    close(fd);
+
+    return (Got == (ssize_t)Table->Size) ? CFE_SUCCESS : CFE_TBL_ERR_ACCESS;
+}
+
+CFE_Status_t CFE_TBL_Load(CFE_TBL_Handle_t TblHandle, CFE_TBL_SrcEnum_t SrcType, const void *SrcDataPtr)
+{
+    StubCfe_Table_t *Table = StubCfe_Table(TblHandle);
+    CFE_Status_t     Status;
+
+    if (Table == NULL || SrcDataPtr == NULL)
+    {
+        return CFE_TBL_ERR_INVALID_HANDLE;
+    }
+
+    if (SrcType == CFE_TBL_SRC_FILE)
+    {
+        Status = StubCfe_TableReadFile(Table, (const char *)SrcDataPtr);
+        if (Status != CFE_SUCCESS)
+        {
+            return Status;
+        }
+    }
+    else
+    {
+        memcpy(Table->Staged, SrcDataPtr, Table->Size);
+    }
+
+    return StubCfe_TableApply(Table);
+}
+
+CFE_Status_t CFE_TBL_Manage(CFE_TBL_Handle_t TblHandle)
+{
+    StubCfe_Table_t *Table = StubCfe_Table(TblHandle);
+
+    if (Table == NULL)
+    {
+        return CFE_TBL_ERR_INVALID_HANDLE;
+    }
+    if (!Table->StagePending || !Table->Loaded)
+    {
+        return CFE_SUCCESS;
+    }
+
+    Table->StagePending = false;
+
+    return (StubCfe_TableApply(Table) == CFE_SUCCESS) ? CFE_TBL_INFO_UPDATED : CFE_SUCCESS;
+}
+
+CFE_Status_t CFE_TBL_GetAddress(void **TblPtr, CFE_TBL_Handle_t TblHandle)
+{
+    StubCfe_Table_t *Table = StubCfe_Table(TblHandle);
+
+    if (Table == NULL || TblPtr == NULL)
+    {
+        return CFE_TBL_ERR_INVALID_HANDLE;
+    }
+    if (!Table->Loaded)
+    {
+        return CFE_TBL_ERR_NEVER_LOADED;
+    }
+
+    *TblPtr = Table->Active;
+    if (Table->Updated)
+    {
+        Table->Updated = false;
+        return CFE_TBL_INFO_UPDATED;
+    }
+
+    return CFE_SUCCESS;
+}
+
+CFE_Status_t CFE_TBL_ReleaseAddress(CFE_TBL_Handle_t TblHandle)
+{
+    return (StubCfe_Table(TblHandle) != NULL) ? CFE_SUCCESS : CFE_TBL_ERR_INVALID_HANDLE;
+}
+
+/*
+** Executive Services
+*/
+bool CFE_ES_RunLoop(uint32 *RunStatus)
+{
+    return (RunStatus != NULL && *RunStatus == CFE_ES_RunStatus_APP_RUN);
+}
+
+void CFE_ES_ExitApp(uint32 ExitStatus)
+{
+    if (StubCfe.Verbose)
+    {
+        fprintf(stderr, "ES: app exit, status %u\n", (unsigned int)ExitStatus);
+    }
+}
+
+CFE_Status_t CFE_ES_WriteToSysLog(const char *SpecStringPtr, ...)
+{
+    va_list ArgPtr;
+
+    StubCfe.Counters.SysLogCount++;
+
+    if (StubCfe.Verbose)
+    {
+        va_start(ArgPtr, SpecStringPtr);
+        vfprintf(stderr, SpecStringPtr, ArgPtr);
+        va_end(ArgPtr);
+    }
+
+    return CFE_SUCCESS;
+}
+
+void CFE_ES_PerfLogAdd(uint32 Marker, uint32 EntryExit)
+{
+    (void)Marker;
+    (void)EntryExit;
+
+    StubCfe.Counters.PerfLogCount++;
+}
+
+/*
+** Child tasks are recorded but never started: the host harness is single
+** threaded and services every pipe itself.
+*/
+CFE_Status_t CFE_ES_CreateChildTask(CFE_ES_TaskId_t *TaskIdPtr, const char *TaskName,
+                                    CFE_ES_ChildTaskMainFuncPtr_t FunctionPtr, CFE_ES_StackPointer_t StackPtr,
+                                    size_t StackSize, uint16 Priority, uint32 Flags)
+{
+    (void)TaskName;
+    (void)StackPtr;
+    (void)StackSize;
+    (void)Priority;
+    (void)Flags;
+
+    if (TaskIdPtr == NULL || FunctionPtr == NULL)
+    {
+        return CFE_ES_BAD_ARGUMENT;
+    }
+
+    *TaskIdPtr = (CFE_ES_TaskId_t)++StubCfe.Counters.ChildTaskCount;
+
+    return CFE_SUCCESS;
+}
+
+void CFE_ES_ExitChildTask(void)
+{
+}
+
+/*
+** Critical Data Store, CRC-16/ARC over each block as cFE uses
+*/
+static uint16 StubCfe_CdsCrc(const uint8 *Data, size_t Size)
+{
+    uint16 Crc = 0;
+    size_t i;
+    uint32 Bit;
+
+    for (i = 0; i < Size; i++)
+    {
+        Crc ^= Data[i];
+        for (Bit = 0; Bit < 8; Bit++)
+        {
+            Crc = (Crc & 1) ? (uint16)((Crc >> 1) ^ 0xA001) : (uint16)(Crc >> 1);
+        }
+    }
+
+    return Crc;
+}
+
+static StubCfe_CdsBlock_t *StubCfe_CdsBlock(CFE_ES_CDSHandle_t Handle)
+{
+    if (Handle >= STUB_CFE_MAX_CDS || !StubCfe_Cds[Handle].InUse)
+    {
+        return NULL;
+    }
+
+    return &StubCfe_Cds[Handle];
+}
+
+CFE_Status_t CFE_ES_RegisterCDS(CFE_ES_CDSHandle_t *CDSHandlePtr, size_t BlockSize, const char *Name)
+{
+    StubCfe_CdsBlock_t *Block;
+    StubCfe_CdsBlock_t *Free = NULL;
+    uint32              i;
+
+    if (CDSHandlePtr == NULL || Name == NULL || BlockSize == 0)
+    {
+        return CFE_ES_BAD_ARGUMENT;
+    }
+
+    for (i = 0; i < STUB_CFE_MAX_CDS; i++)
+    {
+        Block = &StubCfe_Cds[i];
+        if (Block->InUse && strcmp(Block->Name, Name) == 0)
+        {
+            *CDSHandlePtr = i;
+            if (Block->Size == BlockSize)
+            {
+                return CFE_ES_CDS_ALREADY_EXISTS;
+            }
+
+            /* A new size replaces the old block */
+            free(Block->Data);
+            Block->InUse = false;
+            Free         = Block;
+            break;
+        }
+        if (!Block->InUse && Free == NULL)
+        {
+            Free = Block;
+        }
+    }
+
+    if (Free == NULL)
+    {
+        return CFE_ES_CDS_INSUFFICIENT_MEMORY;
+    }
+
+    Free->Data = calloc(1, BlockSize);
+    if (Free->Data == NULL)
+    {
+        return CFE_ES_CDS_INSUFFICIENT_MEMORY;
+    }
+
+    Free->InUse = true;
+    strncpy(Free->Name, Name, sizeof(Free->Name) - 1);
+    Free->Size    = BlockSize;
+    Free->Crc     = StubCfe_CdsCrc(Free->Data, BlockSize);
+    *CDSHandlePtr = (CFE_ES_CDSHandle_t)(Free - StubCfe_Cds);
+
+    return CFE_SUCCESS;
+}
+
+CFE_Status_t CFE_ES_CopyToCDS(CFE_ES_CDSHandle_t Handle, const void *DataToCopy)
+{
+    StubCfe_CdsBlock_t *Block = StubCfe_CdsBlock(Handle);
+
+    if (Block == NULL || DataToCopy == NULL)
+    {
+        return CFE_ES_ERR_RESOURCEID_NOT_VALID;
+    }
+
+    memcpy(Block->Data, DataToCopy, Block->Size);
+    Block->Crc = StubCfe_CdsCrc(Block->Data, Block->Size);
+    StubCfe.Counters.CdsWriteCount++;
+
+    return CFE_SUCCESS;
+}
+
+CFE_Status_t CFE_ES_RestoreFromCDS(void *RestoreToMemory, CFE_ES_CDSHandle_t Handle)
+{
+    StubCfe_CdsBlock_t *Block = StubCfe_CdsBlock(Handle);
+
+    if (Block == NULL || RestoreToMemory == NULL)
+    {
+        return CFE_ES_ERR_RESOURCEID_NOT_VALID;
+    }
+
+    memcpy(RestoreToMemory, Block->Data, Block->Size);
+
+    return (StubCfe_CdsCrc(Block->Data, Block->Size) == Block->Crc) ? CFE_SUCCESS : CFE_ES_CDS_BLOCK_CRC_ERR;
+}
+
+/*
+** OSAL
+*/
+void OS_printf(const char *string, ...)
+{
+    va_list ArgPtr;
+
+    va_start(ArgPtr, string);
+    vprintf(string, ArgPtr);
+    va_end(ArgPtr);
+}
+
+int32 OS_TaskDelay(uint32 millisecond)
+{
+    struct timespec ts;
+
+    ts.tv_sec  = millisecond / 1000;
+    ts.tv_nsec = (long)(millisecond % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+
+    return OS_SUCCESS;
+}
+
+int32 OS_OpenCreate(osal_id_t *filedes, const char *path, int32 flags, int32 access_mode)
+{
+    int PosixFlags;
+    int fd;
+
+    switch (access_mode)
+    {
+        case OS_WRITE_ONLY:
+            PosixFlags = O_WRONLY;
+            break;
+        case OS_READ_WRITE:
+            PosixFlags = O_RDWR;
+            break;
+        default:
+            PosixFlags = O_RDONLY;
+            break;
+    }
+
+    if (flags & OS_FILE_FLAG_CREATE)
+    {
+        PosixFlags |= O_CREAT;
+    }
+    if (flags & OS_FILE_FLAG_TRUNCATE)
+    {
+        PosixFlags |= O_TRUNC;
+    }
+
+    fd = open(path, PosixFlags, 0644);
+    if (fd < 0)
+    {
+        return OS_ERROR;
+    }
+
+    *filedes = (osal_id_t)fd;
+
+    return OS_SUCCESS;
+}
+
+int32 OS_read(osal_id_t filedes, void *buffer, size_t nbytes)
+{
+    ssize_t Result = read((int)filedes, buffer, nbytes);
+
+    return (Result < 0) ? OS_ERROR : (int32)Result;
+}
+
+int32 OS_write(osal_id_t filedes, const void *buffer, size_t nbytes)
+{
+    ssize_t Result = write((int)filedes, buffer, nbytes);
+
+    return (Result < 0) ? OS_ERROR : (int32)Result;
+}
+
+int32 OS_close(osal_id_t filedes)
+{
+    return (close((int)filedes) == 0) ? OS_SUCCESS : OS_ERROR;
+}